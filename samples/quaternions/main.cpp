@@ -18,6 +18,7 @@
 
 #include <scene/components/mesh_instacnes/mesh_instance.hpp>
 #include <misc/opengl.hpp>
+#include <misc/debug.hpp>
 #include <misc/types_traits.hpp>
 
 #include <scene/scene/scene.hpp>
@@ -485,6 +486,9 @@ int main()
     const auto shadow_debug_shader = r->create_shader(shadow_debug_shader_descriptor);
     const auto post_process_shader = r->create_shader(post_process_shader_descriptor);
 
+    ASSERT(r->validate_parameters_list(shader, "instance_data", instance_params));
+    ASSERT(r->validate_parameters_list(shadow_shader, "instance_data", shadow_params));
+
     auto light_proj = math::ortho(20, 20, 0.01, 20);
     auto light_view = math::look_at({0, 18, -6}, {0, 0, 0}, {0, 1, 0});
     auto light_vp = light_proj * light_view;
@@ -0,0 +1,168 @@
+
+
+#include "bvh.hpp"
+
+#include <algorithm>
+#include <array>
+
+
+namespace
+{
+    using math::bound_boxes::bound3;
+
+    constexpr uint32_t bins_count = 16;
+    constexpr uint32_t max_leaf_size = 4;
+    // traversal stack gets one entry per level at most.
+    constexpr uint32_t max_depth = 60;
+    // cost of a node visit relative to a primitive test.
+    constexpr float traversal_cost = 1.f;
+
+
+    float get_axis(math::vec3 v, uint32_t axis)
+    {
+        return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+    }
+
+
+    float get_half_area(const bound3& b)
+    {
+        const auto d = math::bound_boxes::diagonal(b);
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+
+    struct bin
+    {
+        bound3 bound;
+        uint32_t count{0};
+    };
+} // namespace
+
+
+void raytracer::bvh::build(std::span<const math::bound_boxes::bound3> bounds)
+{
+    m_nodes.clear();
+    m_indices.resize(bounds.size());
+    m_centroids.resize(bounds.size());
+
+    for (uint32_t i = 0; i < bounds.size(); ++i) {
+        m_indices[i] = i;
+        m_centroids[i] = (bounds[i].min + bounds[i].max) * 0.5f;
+    }
+
+    if (!bounds.empty()) {
+        m_nodes.reserve(2 * bounds.size() - 1);
+        build_node(bounds, 0, uint32_t(bounds.size()), 0);
+    }
+
+    m_centroids.clear();
+    m_centroids.shrink_to_fit();
+}
+
+
+std::span<const uint32_t> raytracer::bvh::get_indices() const
+{
+    return m_indices;
+}
+
+
+std::span<const raytracer::bvh::node> raytracer::bvh::get_nodes() const
+{
+    return m_nodes;
+}
+
+
+uint32_t raytracer::bvh::build_node(std::span<const math::bound_boxes::bound3> bounds, uint32_t first, uint32_t last, uint32_t depth)
+{
+    const auto index = uint32_t(m_nodes.size());
+    m_nodes.emplace_back();
+
+    bound3 node_bound;
+    bound3 centroids_bound;
+
+    for (auto i = first; i < last; ++i) {
+        node_bound = math::bound_boxes::union_bounds(node_bound, bounds[m_indices[i]]);
+        centroids_bound = math::bound_boxes::union_bound_point(centroids_bound, m_centroids[m_indices[i]]);
+    }
+
+    m_nodes[index].bound = node_bound;
+
+    const auto count = last - first;
+    const auto make_leaf = [this, index, first, count]() {
+        m_nodes[index].offset = first;
+        m_nodes[index].count = count;
+        return index;
+    };
+
+    const auto extent = math::bound_boxes::diagonal(centroids_bound);
+    const uint32_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+    const auto axis_min = get_axis(centroids_bound.min, axis);
+    const auto axis_extent = get_axis(extent, axis);
+
+    // coincident centroids can't be split by position.
+    if (count == 1 || depth >= max_depth || axis_extent <= 0.f) {
+        return make_leaf();
+    }
+
+    const auto get_bin = [&](uint32_t primitive) {
+        const auto b = uint32_t(float(bins_count) * (get_axis(m_centroids[primitive], axis) - axis_min) / axis_extent);
+        return std::min(b, bins_count - 1);
+    };
+
+    std::array<bin, bins_count> bins{};
+
+    for (auto i = first; i < last; ++i) {
+        auto& b = bins[get_bin(m_indices[i])];
+        b.bound = math::bound_boxes::union_bounds(b.bound, bounds[m_indices[i]]);
+        ++b.count;
+    }
+
+    // cost of splitting after bin i is sum of sides areas weighted by their primitives counts.
+    std::array<float, bins_count - 1> costs{};
+    bound3 side_bound;
+    uint32_t side_count = 0;
+
+    for (uint32_t i = 0; i < bins_count - 1; ++i) {
+        side_bound = math::bound_boxes::union_bounds(side_bound, bins[i].bound);
+        side_count += bins[i].count;
+        costs[i] = side_count > 0 ? get_half_area(side_bound) * float(side_count) : 0.f;
+    }
+
+    side_bound = bound3{};
+    side_count = 0;
+
+    for (uint32_t i = bins_count - 1; i > 0; --i) {
+        side_bound = math::bound_boxes::union_bounds(side_bound, bins[i].bound);
+        side_count += bins[i].count;
+        costs[i - 1] += side_count > 0 ? get_half_area(side_bound) * float(side_count) : 0.f;
+    }
+
+    const auto best = uint32_t(std::min_element(costs.begin(), costs.end()) - costs.begin());
+    const auto node_area = get_half_area(node_bound);
+    const auto split_cost = traversal_cost + (node_area > 0.f ? costs[best] / node_area : float(count));
+
+    if (count <= max_leaf_size && split_cost >= float(count)) {
+        return make_leaf();
+    }
+
+    auto* middle = std::partition(m_indices.data() + first, m_indices.data() + last, [&](uint32_t primitive) {
+        return get_bin(primitive) <= best;
+    });
+
+    auto mid = uint32_t(middle - m_indices.data());
+
+    if (mid == first || mid == last) {
+        mid = first + count / 2;
+        std::nth_element(m_indices.data() + first, m_indices.data() + mid, m_indices.data() + last, [&](uint32_t l, uint32_t r) {
+            return get_axis(m_centroids[l], axis) < get_axis(m_centroids[r], axis);
+        });
+    }
+
+    build_node(bounds, first, mid, depth + 1);
+    const auto right = build_node(bounds, mid, last, depth + 1);
+
+    m_nodes[index].offset = right;
+    m_nodes[index].count = 0;
+
+    return index;
+}
@@ -0,0 +1,221 @@
+
+
+
+#pragma once
+
+#include <ray_packet.hpp>
+
+#include <math/raytracing/ray.hpp>
+#include <math/bound_boxes/bound.hpp>
+#include <math/simd/simd.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <limits>
+#include <span>
+#include <vector>
+
+
+namespace raytracer
+{
+    // bounding volume hierarchy over primitives bounds, built with binned surface area heuristic.
+    // nodes are stored depth first, left child of an interior node follows it.
+    class bvh
+    {
+    public:
+        // two nodes per cache line.
+        struct alignas(32) node
+        {
+            math::bound_boxes::bound3 bound;
+            // first index of leaf primitives, or right child of interior node.
+            uint32_t offset;
+            // 0 for interior nodes.
+            uint32_t count;
+        };
+
+        void build(std::span<const math::bound_boxes::bound3> bounds);
+
+        // primitives of leaf are get_indices()[offset, offset + count).
+        std::span<const uint32_t> get_indices() const;
+        std::span<const node> get_nodes() const;
+
+        // calls hit(primitive, t_max) for primitives of leaves the ray enters before t_max, nearest first.
+        // hit returns true and lowers t_max when the primitive is hit closer.
+        template<typename HitFunc>
+        bool traverse(const math::raytracing::ray3& ray, float t_max, HitFunc&& hit) const
+        {
+            return traverse_leaves(ray, t_max, [this, &hit](uint32_t offset, uint32_t count, float& t_max) {
+                bool res = false;
+                for (auto i = offset; i < offset + count; ++i) {
+                    res = hit(m_indices[i], t_max) || res;
+                }
+                return res;
+            });
+        }
+
+        // same as traverse, hit(offset, count, t_max) gets whole leaf, its primitives are get_indices()[offset, offset + count).
+        template<typename HitFunc>
+        bool traverse_leaves(const math::raytracing::ray3& ray, float t_max, HitFunc&& hit) const
+        {
+            constexpr size_t stack_size = 64;
+
+            struct entry
+            {
+                uint32_t node;
+                float t;
+            };
+
+            if (m_nodes.empty() || !math::raytracing::intersect(ray, m_nodes.front().bound, static_cast<float*>(nullptr), static_cast<float*>(nullptr), t_max)) {
+                return false;
+            }
+
+            entry stack[stack_size];
+            size_t stack_top = 0;
+            uint32_t current = 0;
+            bool res = false;
+
+            while (true) {
+                const auto& n = m_nodes[current];
+
+                if (n.count > 0) {
+                    res = hit(n.offset, n.count, t_max) || res;
+                } else {
+                    const auto left = current + 1;
+                    const auto right = n.offset;
+
+                    float left_t = 0;
+                    float right_t = 0;
+                    const auto is_left_hit = math::raytracing::intersect(ray, m_nodes[left].bound, &left_t, static_cast<float*>(nullptr), t_max);
+                    const auto is_right_hit = math::raytracing::intersect(ray, m_nodes[right].bound, &right_t, static_cast<float*>(nullptr), t_max);
+
+                    if (is_left_hit && is_right_hit) {
+                        const auto is_left_near = left_t <= right_t;
+                        stack[stack_top++] = is_left_near ? entry{right, right_t} : entry{left, left_t};
+                        current = is_left_near ? left : right;
+                        continue;
+                    }
+
+                    if (is_left_hit || is_right_hit) {
+                        current = is_left_hit ? left : right;
+                        continue;
+                    }
+                }
+
+                // far children pushed before a closer hit was found may be behind it now.
+                do {
+                    if (stack_top == 0) {
+                        return res;
+                    }
+                    --stack_top;
+                } while (stack[stack_top].t > t_max);
+
+                current = stack[stack_top].node;
+            }
+        }
+
+        // packet traverse_leaves, node is entered when any lane enters it before its t_max.
+        // hit(offset, count, t_max) lowers t_max lanes hit closer, empty lanes of packet never enter nodes.
+        template<typename HitFunc>
+        void traverse_packet(const ray_packet& packet, HitFunc&& hit) const
+        {
+            using namespace math::simd;
+
+            constexpr size_t stack_size = 64;
+            constexpr float miss = std::numeric_limits<float>::infinity();
+
+            struct entry
+            {
+                uint32_t node;
+                float t;
+            };
+
+            if (m_nodes.empty()) {
+                return;
+            }
+
+            const auto ox = load4(packet.origin_x.data());
+            const auto oy = load4(packet.origin_y.data());
+            const auto oz = load4(packet.origin_z.data());
+            const auto one = splat(1.f);
+            const auto inv_dx = div(one, load4(packet.direction_x.data()));
+            const auto inv_dy = div(one, load4(packet.direction_y.data()));
+            const auto inv_dz = div(one, load4(packet.direction_z.data()));
+            auto t_max = load4(packet.t_max.data());
+
+            // nearest entry of lanes into the bound, slabs of nan lanes are skipped as in intersect.
+            const auto enter = [&](const math::bound_boxes::bound3& b) {
+                const auto x0 = mul(sub(splat(b.min.x), ox), inv_dx);
+                const auto x1 = mul(sub(splat(b.max.x), ox), inv_dx);
+                const auto y0 = mul(sub(splat(b.min.y), oy), inv_dy);
+                const auto y1 = mul(sub(splat(b.max.y), oy), inv_dy);
+                const auto z0 = mul(sub(splat(b.min.z), oz), inv_dz);
+                const auto z1 = mul(sub(splat(b.max.z), oz), inv_dz);
+
+                auto t_near = max(min(x0, x1), splat(0.f));
+                auto t_far = min(max(x0, x1), t_max);
+                t_near = max(min(y0, y1), t_near);
+                t_far = min(max(y0, y1), t_far);
+                t_near = max(min(z0, z1), t_near);
+                t_far = min(max(z0, z1), t_far);
+
+                alignas(16) float lanes[ray_packet::size];
+                store4(lanes, select(cmp_lt(t_near, t_far), t_near, splat(miss)));
+                return std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+            };
+
+            if (enter(m_nodes.front().bound) == miss) {
+                return;
+            }
+
+            entry stack[stack_size];
+            size_t stack_top = 0;
+            uint32_t current = 0;
+
+            while (true) {
+                const auto& n = m_nodes[current];
+
+                if (n.count > 0) {
+                    hit(n.offset, n.count, t_max);
+                } else {
+                    const auto left = current + 1;
+                    const auto right = n.offset;
+
+                    const auto left_t = enter(m_nodes[left].bound);
+                    const auto right_t = enter(m_nodes[right].bound);
+
+                    if (left_t != miss && right_t != miss) {
+                        const auto is_left_near = left_t <= right_t;
+                        stack[stack_top++] = is_left_near ? entry{right, right_t} : entry{left, left_t};
+                        current = is_left_near ? left : right;
+                        continue;
+                    }
+
+                    if (left_t != miss || right_t != miss) {
+                        current = left_t != miss ? left : right;
+                        continue;
+                    }
+                }
+
+                alignas(16) float lanes[ray_packet::size];
+                store4(lanes, t_max);
+                const auto farthest = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+
+                do {
+                    if (stack_top == 0) {
+                        return;
+                    }
+                    --stack_top;
+                } while (stack[stack_top].t > farthest);
+
+                current = stack[stack_top].node;
+            }
+        }
+
+    private:
+        uint32_t build_node(std::span<const math::bound_boxes::bound3> bounds, uint32_t first, uint32_t last, uint32_t depth);
+
+        std::vector<node> m_nodes;
+        std::vector<uint32_t> m_indices;
+        std::vector<math::vec3> m_centroids;
+    };
+}
@@ -38,7 +38,8 @@ bool raytracer::dielectric::scatter(
         scattered = {record.point, res};
         return true;
     } else {
+        // total internal reflection, nothing is absorbed.
         scattered = {record.point, math::misc::reflect(ray.direction, record.normal)};
-        return false;
+        return true;
     }
 }
@@ -0,0 +1,25 @@
+
+
+#include "emissive.hpp"
+
+
+raytracer::emissive::emissive(math::vec3 radiance)
+    : m_radiance(radiance)
+{
+}
+
+
+bool raytracer::emissive::scatter(
+    math::raytracing::ray3,
+    const raytracer::hit_record&,
+    math::vec3&,
+    math::raytracing::ray3&)
+{
+    return false;
+}
+
+
+math::vec3 raytracer::emissive::emitted(const raytracer::hit_record&) const
+{
+    return m_radiance;
+}
@@ -0,0 +1,23 @@
+
+
+#pragma once
+
+#include <material.hpp>
+
+
+namespace raytracer
+{
+    // light source, emits radiance and absorbs everything it's hit by.
+    class emissive : public material
+    {
+    public:
+        explicit emissive(math::vec3 radiance);
+        ~emissive() override = default;
+
+        bool scatter(math::raytracing::ray3 ray, const hit_record& record, math::vec3& attenuation, math::raytracing::ray3& scattered) override;
+        math::vec3 emitted(const hit_record& record) const override;
+
+    private:
+        math::vec3 m_radiance;
+    };
+}
@@ -1,3 +1,17 @@
 
 
 #include "hit_detector.hpp"
+
+
+uint32_t raytracer::hit_detector::hit_packet(const raytracer::ray_packet& packet, raytracer::hit_record* records, float t_min)
+{
+    uint32_t res = 0;
+
+    for (uint32_t lane = 0; lane < ray_packet::size; ++lane) {
+        if (packet.t_max[lane] >= t_min && hit(packet.get(lane), records[lane], t_min, packet.t_max[lane])) {
+            res |= 1u << lane;
+        }
+    }
+
+    return res;
+}
@@ -4,7 +4,9 @@
 #pragma once
 
 #include <math/raytracing/ray.hpp>
+#include <math/bound_boxes/bound.hpp>
 #include <hit_record.hpp>
+#include <ray_packet.hpp>
 
 
 namespace raytracer
@@ -14,6 +16,11 @@ namespace raytracer
     public:
         virtual ~hit_detector() = default;
         virtual bool hit(math::raytracing::ray3, hit_record&, float t_min = 0, float t_max = std::numeric_limits<float>::max()) = 0;
+        virtual math::bound_boxes::bound3 get_bound() const = 0;
+
+        // hits of packet lanes, bit i of result is set if lane i hit and records[i] is filled.
+        // tests lanes one by one with hit, detectors override it with simd kernels.
+        virtual uint32_t hit_packet(const ray_packet&, hit_record* records, float t_min = 0);
     };
 }
 
@@ -1,3 +1,46 @@
 
 
 #include "hit_detectors_list.hpp"
+
+#include <misc/debug.hpp>
+
+
+void raytracer::hit_detectors_list::build()
+{
+    std::vector<math::bound_boxes::bound3> bounds;
+    bounds.reserve(m_hit_detectors.size());
+
+    for (const auto& detector : m_hit_detectors) {
+        bounds.emplace_back(detector->get_bound());
+    }
+
+    m_bvh.build(bounds);
+}
+
+
+bool raytracer::hit_detectors_list::hit(math::raytracing::ray3 ray, raytracer::hit_record& record, float t_min, float t_max)
+{
+    ASSERT(m_bvh.get_indices().size() == m_hit_detectors.size());
+
+    bool is_found = false;
+
+    return m_bvh.traverse(ray, t_max, [this, &ray, &record, &is_found, t_min](uint32_t detector, float& closest_t) {
+        raytracer::hit_record curr_record{};
+
+        if (!m_hit_detectors[detector]->hit(ray, curr_record, t_min, closest_t) || (is_found && curr_record.t >= closest_t)) {
+            return false;
+        }
+
+        record = curr_record;
+        closest_t = curr_record.t;
+        is_found = true;
+        return true;
+    });
+}
+
+
+math::bound_boxes::bound3 raytracer::hit_detectors_list::get_bound() const
+{
+    const auto nodes = m_bvh.get_nodes();
+    return nodes.empty() ? math::bound_boxes::bound3{} : nodes.front().bound;
+}
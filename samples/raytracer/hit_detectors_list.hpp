@@ -4,6 +4,7 @@
 #pragma once
 
 #include <hit_detector.hpp>
+#include <bvh.hpp>
 
 #include <vector>
 #include <memory>
@@ -11,6 +12,7 @@
 
 namespace raytracer
 {
+    // detectors are found through bvh over their bounds, build() has to be called after they are added.
     class hit_detectors_list : public raytracer::hit_detector
     {
     public:
@@ -22,34 +24,13 @@ namespace raytracer
             m_hit_detectors.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
         }
 
-        bool hit(math::raytracing::ray3 ray, raytracer::hit_record& record, float t_min, float t_max) override
-        {
-            raytracer::hit_record closest{};
-            bool is_first = true;
-            bool hit_success = false;
-
-            for (auto& detector : m_hit_detectors) {
-                raytracer::hit_record curr_record{};
-                if (detector->hit(ray, curr_record, t_min, t_max)) {
-                    if (is_first) {
-                        closest = curr_record;
-                        hit_success = true;
-                        is_first = false;
-                        continue;
-                    }
-
-                    if (curr_record.t < closest.t) {
-                        closest = curr_record;
-                    }
-                }
-            }
-
-            record = closest;
-
-            return hit_success;
-        }
+        void build();
+
+        bool hit(math::raytracing::ray3 ray, raytracer::hit_record& record, float t_min, float t_max) override;
+        math::bound_boxes::bound3 get_bound() const override;
 
     private:
         std::vector<std::unique_ptr<hit_detector>> m_hit_detectors;
+        raytracer::bvh m_bvh;
     };
 }
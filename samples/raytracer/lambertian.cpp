@@ -23,3 +23,9 @@ bool raytracer::lambertian::scatter(
     return true;
 }
 
+
+bool raytracer::lambertian::get_brdf(const raytracer::hit_record&, math::vec3& brdf) const
+{
+    brdf = albedo / float(M_PI);
+    return true;
+}
@@ -19,6 +19,8 @@ namespace raytracer
             math::vec3& attenuation,
             math::raytracing::ray3& scattered) override;
 
+        bool get_brdf(const hit_record& record, math::vec3& brdf) const override;
+
         math::vec3 albedo{};
     };
 
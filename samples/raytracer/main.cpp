@@ -4,91 +4,200 @@
 #include "hit_detector.hpp"
 #include "sphere.hpp"
 #include "hit_detectors_list.hpp"
+#include "spheres_list.hpp"
 #include "camera.hpp"
 #include "lambertian.hpp"
 #include "metal.hpp"
 #include "dielectric.hpp"
+#include "emissive.hpp"
+#include "path_integrator.hpp"
+#include "render_scheduler.hpp"
 
 #include <math/vector.hpp>
-#include <math/misc/misc.hpp>
+#include <math/misc/random.hpp>
 #include <math/raytracing/ray.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <span>
 #include <vector>
 #include <iostream>
 
-#include <future>
+namespace
+{
+    raytracer::sampler_type parse_sampler(const char* name)
+    {
+        if (std::strcmp(name, "uniform") == 0) {
+            return raytracer::sampler_type::uniform;
+        } else if (std::strcmp(name, "stratified") == 0) {
+            return raytracer::sampler_type::stratified;
+        } else if (std::strcmp(name, "halton") == 0) {
+            return raytracer::sampler_type::halton;
+        } else if (std::strcmp(name, "sobol") == 0) {
+            return raytracer::sampler_type::sobol;
+        }
+
+        throw std::runtime_error(std::string("unknown sampler ") + name + ".");
+    }
 
-constexpr static size_t width = 800;
-constexpr static size_t height = 600;
-constexpr static size_t samples_count = 4;
 
-math::ubvec3 image[height][width];
+    struct options
+    {
+        raytracer::render_settings render;
+        raytracer::integrator_settings integrator;
+        // trace samples of a tile as ray stream.
+        bool stream = true;
+        // small random spheres scattered over the ground.
+        uint32_t spheres_count = 0;
+    };
 
-math::vec3 color(math::raytracing::ray3 ray, raytracer::hit_detector* world, size_t recursion_depth = 0)
-{
-    raytracer::hit_record r{};
-    if (recursion_depth <= 500 && world->hit(ray, r, 0.0001) && r.material != nullptr) {
-        math::raytracing::ray3 new_ray{};
-        math::vec3 attenuation;
-        r.material->scatter(ray, r, attenuation, new_ray);
-        return attenuation * color(new_ray, world, ++recursion_depth);
-    } else {
-        auto c = ray.direction * 0.5 + 0.5;
-        return math::misc::lerp(math::vec3{1, 1, 1}, math::vec3{0.5, 0.6, 0.7}, c);
-    }
-}
 
-int main()
-{
-    raytracer::hit_detectors_list l;
-    l.add_detector<raytracer::sphere>(math::vec3{-1., 0, -1}, 0.5, std::make_unique<raytracer::metal>(math::vec3 {0.5, 0.3, 0.4}));
-    l.add_detector<raytracer::sphere>(math::vec3{1., 0, -1}, 0.5, std::make_unique<raytracer::dielectric>(math::vec3{1.f, 1.f, 1.f}, 1.5f));
-    l.add_detector<raytracer::sphere>(math::vec3{0, 0, -1}, 0.5, std::make_unique<raytracer::lambertian>(math::vec3 {0.7, 0.8, 0}));
-    l.add_detector<raytracer::sphere>(math::vec3{0, -100.5, -1}, 100, std::make_unique<raytracer::lambertian>(math::vec3 {0.2, 0.7, 0.2}));
+    options parse_options(int argc, char** argv)
+    {
+        options res;
+        auto& render = res.render;
 
-   raytracer::camera c{M_PI_2, 4, 3, {0, 0, 1.}, {0., 0., -1.}};
+        for (int i = 1; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--sampler") == 0) {
+                render.sampler = parse_sampler(argv[i + 1]);
+                continue;
+            }
 
-    auto threads_count = std::thread::hardware_concurrency();
-    auto chunk_width = width / threads_count;
-    int chunk_alignment = width % threads_count;
-    auto curr_offset = 0;
+            if (std::strcmp(argv[i], "--seed") == 0) {
+                render.seed = std::stoull(argv[i + 1]);
+                continue;
+            }
 
-    std::vector<std::future<void>> futures;
-    futures.reserve(threads_count);
+            if (std::strcmp(argv[i], "--mode") == 0) {
+                if (std::strcmp(argv[i + 1], "stream") == 0) {
+                    res.stream = true;
+                } else if (std::strcmp(argv[i + 1], "scalar") == 0) {
+                    res.stream = false;
+                } else {
+                    throw std::runtime_error(std::string("unknown mode ") + argv[i + 1] + ".");
+                }
+                continue;
+            }
 
-    for (int i = 0; i < threads_count; ++i, chunk_alignment--) {
-        auto bias = chunk_alignment > 0 ? 1 : 0;
-        auto x_max = curr_offset + chunk_width + bias;
+            const auto value = uint32_t(std::stoul(argv[i + 1]));
+
+            if (std::strcmp(argv[i], "--width") == 0) {
+                render.width = value;
+            } else if (std::strcmp(argv[i], "--height") == 0) {
+                render.height = value;
+            } else if (std::strcmp(argv[i], "--samples") == 0) {
+                render.samples_count = std::max(value, 1u);
+            } else if (std::strcmp(argv[i], "--tile") == 0) {
+                render.tile_size = std::max(value, 1u);
+            } else if (std::strcmp(argv[i], "--max-depth") == 0) {
+                res.integrator.max_depth = value;
+            } else if (std::strcmp(argv[i], "--spheres") == 0) {
+                res.spheres_count = value;
+            } else {
+                throw std::runtime_error(std::string("unknown option ") + argv[i] + ".");
+            }
+        }
 
-        auto f = std::async([x_max, curr_offset, &c, &l]() {
-            for (int x = curr_offset; x < x_max; ++x) {
-                for (int y = 0; y < height; ++y) {
-                    math::vec3 curr_color{};
+        return res;
+    }
 
-                    for (int i = 0; i < samples_count; ++i) {
-                        const auto ray = c.gen_ray((float(x) + math::misc::rand_float()) / width, (float(y) + math::misc::rand_float()) / height);
-                        curr_color += ::color(ray, &l);
-                    }
 
-                    curr_color /= samples_count;
+    void add_random_spheres(raytracer::spheres_list& l, uint32_t count)
+    {
+        math::misc::pcg32 rng;
 
-                    image[(height - 1) - y][x].x = sqrt(curr_color.x) * 255.99f;
-                    image[(height - 1) - y][x].y = sqrt(curr_color.y) * 255.99f;
-                    image[(height - 1) - y][x].z = sqrt(curr_color.z) * 255.99f;
-                }
-            }
-        });
+        // spheres lie on the ground in a square of density independent of count.
+        const auto half_extent = 0.25f * std::sqrt(float(count));
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto r = 0.05f + 0.05f * rng.next_float();
+            const math::vec3 o{half_extent * (2.f * rng.next_float() - 1.f), r - 0.5f, -1.f - 2.f * half_extent * rng.next_float()};
+            const math::vec3 color{rng.next_float(), rng.next_float(), rng.next_float()};
 
-        futures.emplace_back(std::move(f));
-        curr_offset += chunk_width + bias;
+            if (rng.next_float() < 0.8f) {
+                l.add_sphere(o, r, std::make_unique<raytracer::lambertian>(color));
+            } else {
+                l.add_sphere(o, r, std::make_unique<raytracer::metal>(color));
+            }
+        }
     }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto options = parse_options(argc, argv);
+    const auto& settings = options.render;
+
+    raytracer::spheres_list l;
+    l.add_sphere(math::vec3{-1., 0, -1}, 0.5, std::make_unique<raytracer::metal>(math::vec3 {0.5, 0.3, 0.4}));
+    l.add_sphere(math::vec3{1., 0, -1}, 0.5, std::make_unique<raytracer::dielectric>(math::vec3{1.f, 1.f, 1.f}, 1.5f));
+    l.add_sphere(math::vec3{0, 0, -1}, 0.5, std::make_unique<raytracer::lambertian>(math::vec3 {0.7, 0.8, 0}));
+    l.add_sphere(math::vec3{0, -100.5, -1}, 100, std::make_unique<raytracer::lambertian>(math::vec3 {0.2, 0.7, 0.2}));
+    add_random_spheres(l, options.spheres_count);
+
+    raytracer::path_integrator integrator{l, options.integrator};
+
+    const math::vec3 light_origin{0.5, 1.1, -1.5};
+    const float light_radius = 0.3;
+    auto light = std::make_unique<raytracer::emissive>(math::vec3{6, 5, 4});
+    integrator.add_light(light_origin, light_radius, light.get());
+    l.add_sphere(light_origin, light_radius, std::move(light));
+    l.build();
+
+    raytracer::camera c{M_PI_2, float(settings.width), float(settings.height), {0, 0, 1.}, {0., 0., -1.}};
+
+    renderer::scene::job_scheduler jobs;
+    raytracer::render_scheduler scheduler{jobs};
+
+    std::vector<math::vec3> pixels;
+    size_t last_percent = 0;
+
+    const auto progress = [&last_percent](size_t tiles_done, size_t tiles_count) {
+        const auto percent = tiles_done * 100 / tiles_count;
+        if (percent != last_percent) {
+            last_percent = percent;
+            std::cout << "\rrendered " << percent << "%" << std::flush;
+        }
+    };
+
+    if (options.stream) {
+        const raytracer::render_scheduler::stream_func stream =
+            [&c, &integrator, &settings](std::span<const float> xs, std::span<const float> ys, std::span<math::misc::pcg32> rngs, std::span<math::vec3> colors) {
+                thread_local std::vector<math::raytracing::ray3> rays;
+                rays.resize(xs.size());
+
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    rays[i] = c.gen_ray(xs[i] / settings.width, ys[i] / settings.height);
+                }
+
+                integrator.trace(rays, rngs, colors);
+            };
 
-    while (!futures.empty()) {
-        futures.back().get();
-        futures.pop_back();
+        scheduler.render(settings, stream, pixels, progress);
+    } else {
+        const raytracer::render_scheduler::sample_func sample = [&c, &integrator, &settings](float x, float y) {
+            return integrator.trace(c.gen_ray(x / settings.width, y / settings.height));
+        };
+
+        scheduler.render(settings, sample, pixels, progress);
     }
 
+    std::cout << std::endl;
+
+    // png rows go from the top, lights are brighter than white.
+    std::vector<math::ubvec3> image(pixels.size());
 
-    stbi_write_png("result.png", width, height, 3, image, 0);
+    for (uint32_t y = 0; y < settings.height; ++y) {
+        for (uint32_t x = 0; x < settings.width; ++x) {
+            const auto& color = pixels[size_t(y) * settings.width + x];
+            auto& pixel = image[size_t(settings.height - 1 - y) * settings.width + x];
+            pixel.x = std::min(sqrt(color.x), 1.f) * 255.99f;
+            pixel.y = std::min(sqrt(color.y), 1.f) * 255.99f;
+            pixel.z = std::min(sqrt(color.z), 1.f) * 255.99f;
+        }
+    }
+
+    stbi_write_png("result.png", int(settings.width), int(settings.height), 3, image.data(), 0);
     return 0;
-}
\ No newline at end of file
+}
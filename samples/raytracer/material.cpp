@@ -1,3 +1,15 @@
 
 
 #include "material.hpp"
+
+
+math::vec3 raytracer::material::emitted(const raytracer::hit_record&) const
+{
+    return {};
+}
+
+
+bool raytracer::material::get_brdf(const raytracer::hit_record&, math::vec3&) const
+{
+    return false;
+}
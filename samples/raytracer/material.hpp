@@ -17,6 +17,13 @@ namespace raytracer
             const raytracer::hit_record&,
             math::vec3& attenuation,
             math::raytracing::ray3& scattered) = 0;
+
+        // radiance emitted from hit point.
+        virtual math::vec3 emitted(const raytracer::hit_record&) const;
+
+        // brdf for direct light sampling. materials without it (mirrors, glass) return false
+        // and get light only by scattered rays.
+        virtual bool get_brdf(const raytracer::hit_record&, math::vec3& brdf) const;
     };
 }
 
@@ -0,0 +1,282 @@
+
+
+#include "path_integrator.hpp"
+
+#include <math/misc/misc.hpp>
+#include <misc/debug.hpp>
+
+#include <algorithm>
+#include <utility>
+
+
+namespace
+{
+    constexpr float ray_epsilon = 0.0001f;
+    constexpr float max_survival_probability = 0.95f;
+
+
+    math::vec3 get_background(const math::raytracing::ray3& ray)
+    {
+        auto c = ray.direction * 0.5 + 0.5;
+        return math::misc::lerp(math::vec3{1, 1, 1}, math::vec3{0.5, 0.6, 0.7}, c);
+    }
+
+
+    // packets of queue items [first, first + count), lanes past count stay empty.
+    template<typename Func>
+    void for_each_packet(size_t size, Func func)
+    {
+        raytracer::ray_packet packet;
+
+        for (size_t first = 0; first < size; first += raytracer::ray_packet::size) {
+            packet.clear();
+            func(first, std::min<size_t>(raytracer::ray_packet::size, size - first), packet);
+        }
+    }
+} // namespace
+
+
+raytracer::path_integrator::path_integrator(raytracer::hit_detector& world, raytracer::integrator_settings settings)
+    : m_world(world)
+    , m_settings(settings)
+{
+}
+
+
+void raytracer::path_integrator::add_light(math::vec3 origin, float radius, const raytracer::material* emitter)
+{
+    m_lights.push_back({origin, radius, emitter});
+}
+
+
+math::vec3 raytracer::path_integrator::trace(math::raytracing::ray3 ray) const
+{
+    math::vec3 radiance{};
+    path_state path{ray};
+
+    for (uint32_t depth = 0; depth < m_settings.max_depth; ++depth) {
+        hit_record record{};
+
+        if (!m_world.hit(path.ray, record, ray_epsilon) || record.material == nullptr) {
+            radiance += path.throughput * get_background(path.ray);
+            break;
+        }
+
+        shadow_ray shadow{};
+        const auto alive = shade(path, record, depth, radiance, shadow);
+
+        // light is occluded if anything else is hit first.
+        if (shadow.light != nullptr) {
+            hit_record light_record{};
+            if (m_world.hit(shadow.ray, light_record, ray_epsilon) && light_record.material == shadow.light) {
+                radiance += shadow.weight * shadow.light->emitted(light_record);
+            }
+        }
+
+        if (!alive) {
+            break;
+        }
+    }
+
+    return radiance;
+}
+
+
+void raytracer::path_integrator::trace(std::span<const math::raytracing::ray3> rays, std::span<math::misc::pcg32> rngs, std::span<math::vec3> radiance) const
+{
+    ASSERT(rays.size() == rngs.size() && rays.size() == radiance.size());
+
+    // queues are reused between calls, every render thread has its own.
+    thread_local std::vector<path_state> paths;
+    thread_local std::vector<path_state> next_paths;
+    thread_local std::vector<hit_record> records;
+    thread_local std::vector<uint32_t> hits;
+    thread_local std::vector<uint32_t> sorted_hits;
+    thread_local std::vector<uint32_t> hits_materials;
+    thread_local std::vector<const material*> materials;
+    thread_local std::vector<uint32_t> materials_offsets;
+    thread_local std::vector<shadow_ray> shadows;
+    thread_local std::vector<hit_record> shadow_records;
+
+    paths.clear();
+
+    for (uint32_t i = 0; i < rays.size(); ++i) {
+        paths.push_back({rays[i], {1, 1, 1}, i, true});
+        radiance[i] = {};
+    }
+
+    // materials draw from thread rng, so it's swapped with the rng of path which is shaded.
+    auto& thread_rng = math::misc::get_thread_rng();
+    const auto saved_rng = thread_rng;
+
+    for (uint32_t depth = 0; depth < m_settings.max_depth && !paths.empty(); ++depth) {
+        records.resize(paths.size());
+        hits.clear();
+
+        for_each_packet(paths.size(), [&](size_t first, size_t count, ray_packet& packet) {
+            for (uint32_t lane = 0; lane < count; ++lane) {
+                packet.set(lane, paths[first + lane].ray);
+            }
+
+            const auto mask = m_world.hit_packet(packet, records.data() + first, ray_epsilon);
+
+            for (uint32_t lane = 0; lane < count; ++lane) {
+                const auto p = uint32_t(first + lane);
+                auto& path = paths[p];
+
+                if ((mask & (1u << lane)) == 0 || records[p].material == nullptr) {
+                    radiance[path.index] += path.throughput * get_background(path.ray);
+                } else {
+                    hits.push_back(p);
+                }
+            }
+        });
+
+        // paths of one material are shaded together. scenes have few materials, so hits are
+        // bucketed by material in order of first appearance.
+        materials.clear();
+        materials_offsets.clear();
+        hits_materials.resize(hits.size());
+
+        for (size_t i = 0; i < hits.size(); ++i) {
+            const auto* material = records[hits[i]].material;
+            const auto found = std::find(materials.begin(), materials.end(), material);
+            hits_materials[i] = uint32_t(found - materials.begin());
+
+            if (found == materials.end()) {
+                materials.push_back(material);
+                materials_offsets.push_back(0);
+            }
+
+            ++materials_offsets[hits_materials[i]];
+        }
+
+        for (uint32_t i = 0, offset = 0; i < materials_offsets.size(); ++i) {
+            offset += std::exchange(materials_offsets[i], offset);
+        }
+
+        sorted_hits.resize(hits.size());
+
+        for (size_t i = 0; i < hits.size(); ++i) {
+            sorted_hits[materials_offsets[hits_materials[i]]++] = hits[i];
+        }
+
+        next_paths.clear();
+        shadows.clear();
+
+        for (const auto p : sorted_hits) {
+            auto& path = paths[p];
+            shadow_ray shadow{};
+
+            thread_rng = rngs[path.index];
+            const auto alive = shade(path, records[p], depth, radiance[path.index], shadow);
+            rngs[path.index] = thread_rng;
+
+            if (shadow.light != nullptr) {
+                shadow.index = path.index;
+                shadows.push_back(shadow);
+            }
+
+            if (alive) {
+                next_paths.push_back(path);
+            }
+        }
+
+        shadow_records.resize(shadows.size());
+
+        for_each_packet(shadows.size(), [&](size_t first, size_t count, ray_packet& packet) {
+            for (uint32_t lane = 0; lane < count; ++lane) {
+                packet.set(lane, shadows[first + lane].ray);
+            }
+
+            const auto mask = m_world.hit_packet(packet, shadow_records.data() + first, ray_epsilon);
+
+            for (uint32_t lane = 0; lane < count; ++lane) {
+                const auto& shadow = shadows[first + lane];
+                const auto& record = shadow_records[first + lane];
+
+                if ((mask & (1u << lane)) != 0 && record.material == shadow.light) {
+                    radiance[shadow.index] += shadow.weight * shadow.light->emitted(record);
+                }
+            }
+        });
+
+        std::swap(paths, next_paths);
+    }
+
+    thread_rng = saved_rng;
+}
+
+
+bool raytracer::path_integrator::shade(path_state& path, const raytracer::hit_record& record, uint32_t depth, math::vec3& radiance, shadow_ray& shadow) const
+{
+    auto& rng = math::misc::get_thread_rng();
+
+    if (path.count_emitted) {
+        radiance += path.throughput * record.material->emitted(record);
+    }
+
+    math::vec3 brdf;
+    path.count_emitted = m_lights.empty() || !record.material->get_brdf(record, brdf);
+
+    if (!path.count_emitted) {
+        sample_light(record, path.throughput * brdf, rng, shadow);
+    }
+
+    math::raytracing::ray3 scattered{};
+    math::vec3 attenuation;
+
+    if (!record.material->scatter(path.ray, record, attenuation, scattered)) {
+        return false;
+    }
+
+    path.throughput = path.throughput * attenuation;
+    path.ray = scattered;
+
+    if (depth + 1 >= m_settings.roulette_depth) {
+        const auto survival = std::min(std::max({path.throughput.x, path.throughput.y, path.throughput.z}), max_survival_probability);
+        if (rng.next_float() >= survival) {
+            return false;
+        }
+        path.throughput = path.throughput / survival;
+    }
+
+    return true;
+}
+
+
+void raytracer::path_integrator::sample_light(const raytracer::hit_record& record, math::vec3 weight, math::misc::pcg32& rng, shadow_ray& shadow) const
+{
+    const auto lights_count = uint32_t(m_lights.size());
+    const auto& light = m_lights[std::min(uint32_t(rng.next_float() * float(lights_count)), lights_count - 1)];
+
+    const auto to_light = light.origin - record.point;
+    const auto sq_distance = math::dot(to_light, to_light);
+    const auto sq_radius = light.radius * light.radius;
+
+    if (sq_distance <= sq_radius) {
+        return;
+    }
+
+    // uniform direction in the cone light is seen in.
+    const auto cos_max = std::sqrt(1.f - sq_radius / sq_distance);
+    const auto cos_theta = 1.f - rng.next_float() * (1.f - cos_max);
+    const auto sin_theta = std::sqrt(std::max(0.f, 1.f - cos_theta * cos_theta));
+    const auto phi = 2.f * float(M_PI) * rng.next_float();
+
+    const auto w = to_light / std::sqrt(sq_distance);
+    const auto u = math::normalize(math::cross(std::abs(w.x) > 0.9f ? math::vec3{0, 1, 0} : math::vec3{1, 0, 0}, w));
+    const auto v = math::cross(w, u);
+    const auto dir = u * (std::cos(phi) * sin_theta) + v * (std::sin(phi) * sin_theta) + w * cos_theta;
+
+    const auto cos_surface = math::dot(dir, record.normal);
+
+    if (cos_surface <= 0.f) {
+        return;
+    }
+
+    const auto inv_pdf = 2.f * float(M_PI) * (1.f - cos_max) * float(lights_count);
+    shadow.ray = {record.point, dir};
+    shadow.weight = weight * (cos_surface * inv_pdf);
+    shadow.light = light.emitter;
+}
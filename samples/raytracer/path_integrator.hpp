@@ -0,0 +1,78 @@
+
+
+#pragma once
+
+#include <hit_detector.hpp>
+#include <material.hpp>
+
+#include <math/misc/random.hpp>
+
+#include <cinttypes>
+#include <span>
+#include <vector>
+
+
+namespace raytracer
+{
+    struct integrator_settings
+    {
+        uint32_t max_depth = 16;
+        // bounces before russian roulette may terminate a path.
+        uint32_t roulette_depth = 3;
+    };
+
+
+    // iterative path tracer. path carries throughput of all its bounces, after roulette depth it
+    // survives with probability of its largest throughput channel, so dark paths end early.
+    // diffuse surfaces sample registered lights directly (next event estimation), such paths
+    // don't count light they hit by the next bounce to not take it twice.
+    class path_integrator
+    {
+    public:
+        explicit path_integrator(hit_detector& world, integrator_settings = {});
+
+        // sphere with emissive material, it must be added to the world too.
+        void add_light(math::vec3 origin, float radius, const material* emitter);
+
+        // radiance along the ray, randoms are taken from thread rng.
+        math::vec3 trace(math::raytracing::ray3 ray) const;
+
+        // stream mode. every bounce intersects all live paths by ray packets, then shades hit
+        // paths sorted by material and traces their shadow rays by packets too. every path has
+        // its own rng, ray i with rngs[i] gets the same radiance as trace with that thread rng.
+        void trace(std::span<const math::raytracing::ray3> rays, std::span<math::misc::pcg32> rngs, std::span<math::vec3> radiance) const;
+
+    private:
+        struct sphere_light
+        {
+            math::vec3 origin;
+            float radius;
+            const material* emitter;
+        };
+
+        struct path_state
+        {
+            math::raytracing::ray3 ray;
+            math::vec3 throughput{1, 1, 1};
+            uint32_t index = 0;
+            bool count_emitted = true;
+        };
+
+        // light is null if there is nothing to trace.
+        struct shadow_ray
+        {
+            math::raytracing::ray3 ray;
+            math::vec3 weight;
+            const material* light = nullptr;
+            uint32_t index = 0;
+        };
+
+        // adds emission of hit point, samples a light and scatters path, false if path ends.
+        bool shade(path_state&, const hit_record&, uint32_t depth, math::vec3& radiance, shadow_ray&) const;
+        void sample_light(const hit_record&, math::vec3 weight, math::misc::pcg32&, shadow_ray&) const;
+
+        hit_detector& m_world;
+        integrator_settings m_settings;
+        std::vector<sphere_light> m_lights;
+    };
+}
@@ -0,0 +1,33 @@
+
+
+#include "ray_packet.hpp"
+
+
+void raytracer::ray_packet::clear()
+{
+    origin_x.fill(0);
+    origin_y.fill(0);
+    origin_z.fill(0);
+    direction_x.fill(0);
+    direction_y.fill(0);
+    direction_z.fill(1);
+    t_max.fill(-1);
+}
+
+
+void raytracer::ray_packet::set(uint32_t lane, const math::raytracing::ray3& ray, float max)
+{
+    origin_x[lane] = ray.origin.x;
+    origin_y[lane] = ray.origin.y;
+    origin_z[lane] = ray.origin.z;
+    direction_x[lane] = ray.direction.x;
+    direction_y[lane] = ray.direction.y;
+    direction_z[lane] = ray.direction.z;
+    t_max[lane] = max;
+}
+
+
+math::raytracing::ray3 raytracer::ray_packet::get(uint32_t lane) const
+{
+    return {{origin_x[lane], origin_y[lane], origin_z[lane]}, {direction_x[lane], direction_y[lane], direction_z[lane]}};
+}
@@ -0,0 +1,33 @@
+
+
+#pragma once
+
+#include <math/raytracing/ray.hpp>
+
+#include <array>
+#include <cinttypes>
+#include <limits>
+
+
+namespace raytracer
+{
+    // up to 4 rays as structure of arrays, lanes match math::simd::float4.
+    // empty lanes have negative t_max, so they never hit anything.
+    struct ray_packet
+    {
+        constexpr static uint32_t size = 4;
+        constexpr static uint32_t full_mask = (1u << size) - 1;
+
+        void clear();
+        void set(uint32_t lane, const math::raytracing::ray3&, float t_max = std::numeric_limits<float>::max());
+        math::raytracing::ray3 get(uint32_t lane) const;
+
+        alignas(16) std::array<float, size> origin_x;
+        alignas(16) std::array<float, size> origin_y;
+        alignas(16) std::array<float, size> origin_z;
+        alignas(16) std::array<float, size> direction_x;
+        alignas(16) std::array<float, size> direction_y;
+        alignas(16) std::array<float, size> direction_z;
+        alignas(16) std::array<float, size> t_max;
+    };
+}
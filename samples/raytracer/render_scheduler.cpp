@@ -0,0 +1,190 @@
+
+
+#include "render_scheduler.hpp"
+
+#include <misc/debug.hpp>
+#include <math/misc/samplers.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+
+namespace
+{
+    // stratified grid closest to square, nx * ny is exactly samples count.
+    uint32_t get_strata_x(uint32_t samples_count)
+    {
+        uint32_t res = 1;
+        for (uint32_t i = 1; i * i <= samples_count; ++i) {
+            if (samples_count % i == 0) {
+                res = i;
+            }
+        }
+        return res;
+    }
+
+
+    // offsets of pixel samples in [0, 1)^2, rng is already seeded for the pixel.
+    void gen_pixel_samples(const raytracer::render_settings& settings, uint32_t strata_x, math::misc::pcg32& rng, float* xs, float* ys)
+    {
+        const auto count = settings.samples_count;
+
+        switch (settings.sampler) {
+            case raytracer::sampler_type::uniform:
+                math::misc::uniform_2d(rng, count, xs, ys);
+                break;
+            case raytracer::sampler_type::stratified:
+                math::misc::stratified_2d(rng, strata_x, count / strata_x, xs, ys);
+                break;
+            case raytracer::sampler_type::halton: {
+                const auto offset_x = rng.next_float();
+                math::misc::halton_2d(0, count, offset_x, rng.next_float(), xs, ys);
+                break;
+            }
+            case raytracer::sampler_type::sobol: {
+                const auto scramble_x = rng.next_uint();
+                math::misc::sobol_2d(0, count, scramble_x, rng.next_uint(), xs, ys);
+                break;
+            }
+        }
+    }
+} // namespace
+
+
+raytracer::render_scheduler::render_scheduler(renderer::scene::job_scheduler& jobs)
+    : m_jobs(jobs)
+{
+}
+
+
+void raytracer::render_scheduler::render(const render_settings& settings, const sample_func& sample, std::vector<math::vec3>& pixels, const progress_func& progress)
+{
+    ASSERT(settings.tile_size > 0 && settings.samples_count > 0);
+
+    pixels.assign(size_t(settings.width) * settings.height, math::vec3{});
+
+    const auto strata_x = get_strata_x(settings.samples_count);
+
+    // every tile writes only its own pixels.
+    const auto render_tile = [&](uint32_t x_begin, uint32_t y_begin, uint32_t x_end, uint32_t y_end) {
+        std::vector<float> xs(settings.samples_count);
+        std::vector<float> ys(settings.samples_count);
+        auto& rng = math::misc::get_thread_rng();
+
+        for (auto y = y_begin; y < y_end; ++y) {
+            for (auto x = x_begin; x < x_end; ++x) {
+                const auto pixel = size_t(y) * settings.width + x;
+                rng.set_seed(math::misc::mix_seed(settings.seed), pixel);
+                gen_pixel_samples(settings, strata_x, rng, xs.data(), ys.data());
+
+                math::vec3 color{};
+                for (uint32_t s = 0; s < settings.samples_count; ++s) {
+                    color += sample(float(x) + xs[s], float(y) + ys[s]);
+                }
+                pixels[pixel] = color / float(settings.samples_count);
+            }
+        }
+    };
+
+    render_tiles(settings, render_tile, progress);
+}
+
+
+void raytracer::render_scheduler::render(const render_settings& settings, const stream_func& stream, std::vector<math::vec3>& pixels, const progress_func& progress)
+{
+    ASSERT(settings.tile_size > 0 && settings.samples_count > 0);
+
+    pixels.assign(size_t(settings.width) * settings.height, math::vec3{});
+
+    const auto strata_x = get_strata_x(settings.samples_count);
+    const auto samples_count = settings.samples_count;
+
+    // samples of a pixel are neighbours in the stream, so rays of one packet are coherent.
+    const auto render_tile = [&](uint32_t x_begin, uint32_t y_begin, uint32_t x_end, uint32_t y_end) {
+        const auto count = size_t(x_end - x_begin) * (y_end - y_begin) * samples_count;
+
+        std::vector<float> xs(count);
+        std::vector<float> ys(count);
+        std::vector<math::misc::pcg32> rngs(count);
+        std::vector<math::vec3> colors(count);
+        auto& rng = math::misc::get_thread_rng();
+
+        size_t first = 0;
+
+        for (auto y = y_begin; y < y_end; ++y) {
+            for (auto x = x_begin; x < x_end; ++x, first += samples_count) {
+                const auto pixel = size_t(y) * settings.width + x;
+                rng.set_seed(math::misc::mix_seed(settings.seed), pixel);
+                gen_pixel_samples(settings, strata_x, rng, xs.data() + first, ys.data() + first);
+
+                for (uint32_t s = 0; s < samples_count; ++s) {
+                    xs[first + s] += float(x);
+                    ys[first + s] += float(y);
+                    rngs[first + s].set_seed(math::misc::mix_seed(settings.seed, pixel), s);
+                }
+            }
+        }
+
+        stream(xs, ys, rngs, colors);
+
+        first = 0;
+
+        for (auto y = y_begin; y < y_end; ++y) {
+            for (auto x = x_begin; x < x_end; ++x, first += samples_count) {
+                math::vec3 color{};
+                for (uint32_t s = 0; s < samples_count; ++s) {
+                    color += colors[first + s];
+                }
+                pixels[size_t(y) * settings.width + x] = color / float(samples_count);
+            }
+        }
+    };
+
+    render_tiles(settings, render_tile, progress);
+}
+
+
+void raytracer::render_scheduler::render_tiles(const render_settings& settings, const tile_func& render_tile, const progress_func& progress)
+{
+    const auto tiles_x = (settings.width + settings.tile_size - 1) / settings.tile_size;
+    const auto tiles_y = (settings.height + settings.tile_size - 1) / settings.tile_size;
+    const size_t tiles_count = size_t(tiles_x) * tiles_y;
+
+    std::atomic<size_t> next_tile{0};
+    std::atomic<size_t> tiles_done{0};
+
+    const auto render_next_tile = [&]() {
+        const auto tile = next_tile.fetch_add(1, std::memory_order_relaxed);
+        if (tile >= tiles_count) {
+            return false;
+        }
+
+        const auto x_begin = uint32_t(tile % tiles_x) * settings.tile_size;
+        const auto y_begin = uint32_t(tile / tiles_x) * settings.tile_size;
+        render_tile(x_begin, y_begin, std::min(x_begin + settings.tile_size, settings.width), std::min(y_begin + settings.tile_size, settings.height));
+
+        tiles_done.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    };
+
+    renderer::scene::job_group group;
+
+    for (size_t i = 0; i < std::min(m_jobs.workers_count(), tiles_count); ++i) {
+        m_jobs.submit(group, [&render_next_tile]() {
+            while (render_next_tile()) {
+            }
+        });
+    }
+
+    while (render_next_tile()) {
+        if (progress) {
+            progress(tiles_done.load(std::memory_order_relaxed), tiles_count);
+        }
+    }
+
+    m_jobs.wait(group);
+
+    if (progress) {
+        progress(tiles_count, tiles_count);
+    }
+}
@@ -0,0 +1,67 @@
+
+
+
+#pragma once
+
+#include <scene/systems/job_scheduler.hpp>
+
+#include <math/vector.hpp>
+#include <math/misc/random.hpp>
+
+#include <cinttypes>
+#include <functional>
+#include <span>
+#include <vector>
+
+
+namespace raytracer
+{
+    enum class sampler_type
+    {
+        uniform,
+        stratified,
+        halton,
+        sobol
+    };
+
+
+    struct render_settings
+    {
+        uint32_t width = 800;
+        uint32_t height = 600;
+        uint32_t samples_count = 4;
+        uint32_t tile_size = 32;
+        sampler_type sampler = sampler_type::sobol;
+        // same seed gives same image regardless of threads count.
+        uint64_t seed = 0;
+    };
+
+
+    // renders image by square tiles. tiles are handed out by an atomic counter to one tiles loop per
+    // worker of the job scheduler, so threads which get cheap tiles simply take more of them.
+    // the calling thread renders tiles too and reports progress between them.
+    // before every pixel thread rng is reseeded from settings seed and pixel index, so samples
+    // positions and everything sample function draws from thread rng are reproducible.
+    class render_scheduler
+    {
+    public:
+        // color of one sample at image position (x, y) in pixels, y goes up from the bottom row.
+        using sample_func = std::function<math::vec3(float x, float y)>;
+        // colors of all samples of a tile at once, rngs[i] is seeded for sample i.
+        using stream_func = std::function<void(std::span<const float> xs, std::span<const float> ys, std::span<math::misc::pcg32> rngs, std::span<math::vec3> colors)>;
+        using progress_func = std::function<void(size_t tiles_done, size_t tiles_count)>;
+
+        explicit render_scheduler(renderer::scene::job_scheduler&);
+
+        // pixels get average of samples, row by row from the bottom one.
+        void render(const render_settings&, const sample_func&, std::vector<math::vec3>& pixels, const progress_func& = {});
+        void render(const render_settings&, const stream_func&, std::vector<math::vec3>& pixels, const progress_func& = {});
+
+    private:
+        using tile_func = std::function<void(uint32_t x_begin, uint32_t y_begin, uint32_t x_end, uint32_t y_end)>;
+
+        void render_tiles(const render_settings&, const tile_func&, const progress_func&);
+
+        renderer::scene::job_scheduler& m_jobs;
+    };
+}
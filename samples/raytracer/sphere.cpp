@@ -1,6 +1,10 @@
 
 
 #include "sphere.hpp"
+
+#include <cmath>
+
+
 raytracer::sphere::sphere(math::vec3 o, float r, std::unique_ptr<material> material)
     : origin(o)
     , radius(r)
@@ -37,4 +41,12 @@ bool raytracer::sphere::hit(math::raytracing::ray3 ray, raytracer::hit_record& r
         }
     }
     return false;
-}
\ No newline at end of file
+}
+
+
+math::bound_boxes::bound3 raytracer::sphere::get_bound() const
+{
+    const auto extent = std::abs(radius);
+    const math::vec3 r{extent, extent, extent};
+    return {origin - r, origin + r};
+}
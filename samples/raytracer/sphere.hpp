@@ -18,6 +18,7 @@ namespace raytracer
         virtual ~sphere() = default;
 
         bool hit(math::raytracing::ray3 ray, raytracer::hit_record& record, float t_min, float t_max) override;
+        math::bound_boxes::bound3 get_bound() const override;
 
         math::vec3 origin;
         float radius;
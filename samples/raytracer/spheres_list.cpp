@@ -0,0 +1,224 @@
+
+
+#include "spheres_list.hpp"
+
+#include <math/simd/simd.hpp>
+#include <misc/debug.hpp>
+
+#include <limits>
+
+
+void raytracer::spheres_list::add_sphere(math::vec3 o, float r, std::unique_ptr<material> material)
+{
+    m_origins.push_back(o);
+    m_sq_radiuses.emplace_back(r * r);
+    m_materials.emplace_back(std::move(material));
+}
+
+
+void raytracer::spheres_list::build()
+{
+    std::vector<math::bound_boxes::bound3> bounds;
+    bounds.reserve(m_origins.size());
+
+    for (size_t i = 0; i < m_origins.size(); ++i) {
+        const auto r = std::sqrt(m_sq_radiuses[i]);
+        const math::vec3 extent{r, r, r};
+        const auto o = m_origins.get(i);
+        bounds.push_back({o - extent, o + extent});
+    }
+
+    m_bvh.build(bounds);
+
+    math::vec3_soa origins;
+    std::vector<float> sq_radiuses;
+    std::vector<std::unique_ptr<material>> materials;
+
+    origins.reserve(m_origins.size());
+    sq_radiuses.reserve(m_origins.size());
+    materials.reserve(m_origins.size());
+
+    for (auto i : m_bvh.get_indices()) {
+        origins.push_back(m_origins.get(i));
+        sq_radiuses.emplace_back(m_sq_radiuses[i]);
+        materials.emplace_back(std::move(m_materials[i]));
+    }
+
+    m_origins = std::move(origins);
+    m_sq_radiuses = std::move(sq_radiuses);
+    m_materials = std::move(materials);
+}
+
+
+bool raytracer::spheres_list::hit(math::raytracing::ray3 ray, raytracer::hit_record& record, float t_min, float t_max)
+{
+    ASSERT(m_bvh.get_indices().size() == m_origins.size());
+
+    const auto* origins_x = m_origins.lane(0);
+    const auto* origins_y = m_origins.lane(1);
+    const auto* origins_z = m_origins.lane(2);
+
+    const float a = math::dot(ray.direction, ray.direction);
+
+    size_t closest = m_origins.size();
+    float closest_t = 0;
+
+    m_bvh.traverse_leaves(ray, t_max, [&](uint32_t offset, uint32_t count, float& leaf_t_max) {
+        const auto last = closest;
+
+        for (auto i = offset; i < offset + count; ++i) {
+            // co = -oc of sphere::hit, so dot(co, dir) is exactly -dot(oc, dir) and dot(co, co) == dot(oc, oc).
+            // dots are z + (y + x) as in the packet kernel.
+            const math::vec3 co{origins_x[i] - ray.origin.x, origins_y[i] - ray.origin.y, origins_z[i] - ray.origin.z};
+            const float co_dot_dir = co.z * ray.direction.z + (co.y * ray.direction.y + co.x * ray.direction.x);
+            const float co_sq = co.z * co.z + (co.y * co.y + co.x * co.x);
+
+            float b = 2.f * -co_dot_dir;
+            float c = co_sq - m_sq_radiuses[i];
+            float d = b * b - 4.f * a * c;
+
+            if (d < 0.f) {
+                continue;
+            }
+
+            float t = (-b - sqrt(d)) / (2.f * a);
+            if (t < t_min || t > leaf_t_max) {
+                t = (-b + sqrt(d)) / (2.f * a);
+                if (t < t_min || t > leaf_t_max) {
+                    continue;
+                }
+            }
+
+            if (closest == m_origins.size() || t < closest_t) {
+                closest = i;
+                closest_t = t;
+            }
+        }
+
+        if (closest == last) {
+            return false;
+        }
+
+        leaf_t_max = closest_t;
+        return true;
+    });
+
+    if (closest == m_origins.size()) {
+        return false;
+    }
+
+    record.point = ray.origin + ray.direction * closest_t;
+    record.normal = math::normalize(record.point - m_origins.get(closest));
+    record.t = closest_t;
+    record.material = m_materials[closest].get();
+
+    return true;
+}
+
+
+uint32_t raytracer::spheres_list::hit_packet(const raytracer::ray_packet& packet, raytracer::hit_record* records, float t_min)
+{
+    using namespace math::simd;
+
+    ASSERT(m_bvh.get_indices().size() == m_origins.size());
+
+    // sphere indices are kept in float lanes.
+    ASSERT(m_origins.size() < (1u << 24u));
+
+    const auto ox = load4(packet.origin_x.data());
+    const auto oy = load4(packet.origin_y.data());
+    const auto oz = load4(packet.origin_z.data());
+    const auto dx = load4(packet.direction_x.data());
+    const auto dy = load4(packet.direction_y.data());
+    const auto dz = load4(packet.direction_z.data());
+    const auto t_min4 = splat(t_min);
+    const auto zero = splat(0.f);
+
+    // same operations order as hit, dot is z + (y + x).
+    const auto a = add(mul(dz, dz), add(mul(dy, dy), mul(dx, dx)));
+    const auto two_a = mul(splat(2.f), a);
+    const auto four_a = mul(splat(4.f), a);
+
+    auto closest_t = splat(std::numeric_limits<float>::infinity());
+    auto closest = splat(-1.f);
+
+    const auto* origins_x = m_origins.lane(0);
+    const auto* origins_y = m_origins.lane(1);
+    const auto* origins_z = m_origins.lane(2);
+
+    m_bvh.traverse_packet(packet, [&](uint32_t offset, uint32_t count, float4& leaf_t_max) {
+        for (auto i = offset; i < offset + count; ++i) {
+            const auto co_x = sub(splat(origins_x[i]), ox);
+            const auto co_y = sub(splat(origins_y[i]), oy);
+            const auto co_z = sub(splat(origins_z[i]), oz);
+
+            const auto co_dot_dir = add(mul(co_z, dz), add(mul(co_y, dy), mul(co_x, dx)));
+            const auto co_sq = add(mul(co_z, co_z), add(mul(co_y, co_y), mul(co_x, co_x)));
+
+            const auto b = mul(splat(-2.f), co_dot_dir);
+            const auto c = sub(co_sq, splat(m_sq_radiuses[i]));
+            const auto d = sub(mul(b, b), mul(four_a, c));
+
+            const auto has_roots = cmp_ge(d, zero);
+            if (mask_bits(has_roots) == 0) {
+                continue;
+            }
+
+            const auto sqrt_d = sqrt(max(d, zero));
+            const auto minus_b = sub(zero, b);
+            const auto t_near = div(sub(minus_b, sqrt_d), two_a);
+            const auto t_far = div(add(minus_b, sqrt_d), two_a);
+
+            const auto near_hit = mask_and(has_roots, mask_and(cmp_ge(t_near, t_min4), cmp_le(t_near, leaf_t_max)));
+            const auto far_hit = mask_and_not(mask_and(has_roots, mask_and(cmp_ge(t_far, t_min4), cmp_le(t_far, leaf_t_max))), near_hit);
+            const auto t = select(near_hit, t_near, t_far);
+
+            const auto closer = mask_and(mask_or(near_hit, far_hit), cmp_lt(t, closest_t));
+            closest_t = select(closer, t, closest_t);
+            closest = select(closer, splat(float(i)), closest);
+        }
+
+        leaf_t_max = min(leaf_t_max, closest_t);
+    });
+
+    alignas(16) float hit_t[ray_packet::size];
+    alignas(16) float hit_index[ray_packet::size];
+    store4(hit_t, closest_t);
+    store4(hit_index, closest);
+
+    uint32_t res = 0;
+
+    for (uint32_t lane = 0; lane < ray_packet::size; ++lane) {
+        if (hit_index[lane] < 0.f) {
+            continue;
+        }
+
+        const auto sphere = size_t(hit_index[lane]);
+        const auto ray = packet.get(lane);
+        auto& record = records[lane];
+
+        record.point = ray.origin + ray.direction * hit_t[lane];
+        record.normal = math::normalize(record.point - m_origins.get(sphere));
+        record.t = hit_t[lane];
+        record.material = m_materials[sphere].get();
+
+        res |= 1u << lane;
+    }
+
+    return res;
+}
+
+
+math::bound_boxes::bound3 raytracer::spheres_list::get_bound() const
+{
+    math::bound_boxes::bound3 res;
+
+    for (size_t i = 0; i < m_origins.size(); ++i) {
+        const auto r = std::sqrt(m_sq_radiuses[i]);
+        const math::vec3 extent{r, r, r};
+        const auto o = m_origins.get(i);
+        res = math::bound_boxes::union_bounds(res, {o - extent, o + extent});
+    }
+
+    return res;
+}
@@ -0,0 +1,41 @@
+
+
+#pragma once
+
+#include <hit_detector.hpp>
+#include <material.hpp>
+#include <bvh.hpp>
+
+#include <math/soa/vec_soa.hpp>
+
+#include <vector>
+#include <memory>
+
+
+namespace raytracer
+{
+    // spheres stored as structure of arrays in bvh leaves order, rays are tested against spheres of leaves they enter.
+    // gives the same hits as hit_detectors_list of raytracer::sphere, build() has to be called after spheres are added.
+    class spheres_list : public raytracer::hit_detector
+    {
+    public:
+        ~spheres_list() override = default;
+
+        void add_sphere(math::vec3 o, float r, std::unique_ptr<material> material = nullptr);
+
+        // builds bvh and reorders spheres, so every leaf is a contiguous range of them.
+        void build();
+
+        bool hit(math::raytracing::ray3 ray, raytracer::hit_record& record, float t_min, float t_max) override;
+        math::bound_boxes::bound3 get_bound() const override;
+
+        // 4 rays against every sphere of leaves any of them enters, same hits as hit per lane.
+        uint32_t hit_packet(const ray_packet& packet, hit_record* records, float t_min) override;
+
+    private:
+        math::vec3_soa m_origins;
+        std::vector<float> m_sq_radiuses;
+        std::vector<std::unique_ptr<material>> m_materials;
+        raytracer::bvh m_bvh;
+    };
+}
@@ -25,32 +25,8 @@ void rubiks_cube::cube::rotate(uint32_t axis, float angle)
     m_rotation[axis] += angle;
 }
 
-void rubiks_cube::cube::update_position(uint32_t axis, int direction)
+void rubiks_cube::cube::reset_rotation()
 {
-    math::mat4 rotation;
-    if (axis == x_axis) {
-        rotation = math::rotation_x(M_PI_2 * direction);
-    } else if (axis == y_axis) {
-        rotation = math::rotation_y(M_PI_2 * direction);
-    } else {
-        rotation = math::rotation_z(M_PI_2 * direction);
-    }
-
-    math::vec4 t{float(m_position.x), float(m_position.y), float(m_position.z), 0.0};
-
-    t = rotation * t;
-
-    m_position.x = round(t.x);
-    m_position.y = round(t.y);
-    m_position.z = round(t.z);
-
-    for (auto& face : faces) {
-        auto new_normal = rotation * face.normal;
-        face.normal.x = round(new_normal.x);
-        face.normal.y = round(new_normal.y);
-        face.normal.z = round(new_normal.z);
-    }
-
     m_rotation[x_axis] = 0;
     m_rotation[y_axis] = 0;
     m_rotation[z_axis] = 0;
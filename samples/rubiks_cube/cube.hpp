@@ -38,7 +38,7 @@ namespace rubiks_cube
 
         explicit cube(math::ivec3 translation);
         void rotate(uint32_t axis, float angle);
-        void update_position(uint32_t axis, int direction);
+        void reset_rotation();
         math::ivec3 get_position() const;
         math::mat4 get_transformation();
 
@@ -0,0 +1,241 @@
+
+
+#include "cube_state.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+
+namespace
+{
+    using namespace rubiks_cube::cube_model;
+
+    template<size_t Size>
+    move_tables_view get_static_view()
+    {
+        return {Size, static_tables<Size>.cycles, static_tables<Size>.offsets};
+    }
+
+
+    struct dynamic_move_tables
+    {
+        std::vector<cycle> cycles;
+        std::vector<uint32_t> offsets;
+    };
+
+
+    std::unique_ptr<dynamic_move_tables> make_dynamic_move_tables(size_t size)
+    {
+        auto res = std::make_unique<dynamic_move_tables>();
+        res->offsets.reserve(3 * size + 1);
+
+        for (uint32_t a = 0; a < 3; ++a) {
+            for (uint32_t layer = 0; layer < size; ++layer) {
+                res->offsets.emplace_back(uint32_t(res->cycles.size()));
+                res->cycles.reserve(res->cycles.size() + get_layer_cycles_count(size, layer));
+                for_each_layer_cycle(size, axis(a), layer, [&res](const cycle& c) {
+                    res->cycles.emplace_back(c);
+                });
+            }
+        }
+
+        res->offsets.emplace_back(uint32_t(res->cycles.size()));
+        return res;
+    }
+} // namespace
+
+
+rubiks_cube::cube_model::move_tables_view rubiks_cube::cube_model::get_move_tables(size_t size)
+{
+    switch (size) {
+        case 2:
+            return get_static_view<2>();
+        case 3:
+            return get_static_view<3>();
+        case 4:
+            return get_static_view<4>();
+        case 5:
+            return get_static_view<5>();
+        default:
+            break;
+    }
+
+    // tables live till the end of the program, views stay valid.
+    static std::mutex mutex;
+    static std::map<size_t, std::unique_ptr<dynamic_move_tables>> tables;
+
+    std::lock_guard lock{mutex};
+
+    auto& t = tables[size];
+    if (t == nullptr) {
+        t = make_dynamic_move_tables(size);
+    }
+
+    return {size, t->cycles, t->offsets};
+}
+
+
+rubiks_cube::cube_model::cube_state::cube_state(size_t size)
+    : m_tables(get_move_tables(size))
+{
+    if (size == 0) {
+        throw std::runtime_error("cube size must be positive.");
+    }
+
+    m_words.resize((get_facelets_count() + facelets_per_word - 1) / facelets_per_word);
+
+    const auto face_size = uint32_t(size * size);
+
+    // zeroed words are faces of color 0.
+    for (auto& counts : m_faces_colors_counts) {
+        counts[0] = face_size;
+    }
+    m_solved_faces_count = faces_count;
+
+    for (uint32_t facelet = 0; facelet < get_facelets_count(); ++facelet) {
+        set_color(facelet, uint8_t(facelet / face_size));
+    }
+}
+
+
+rubiks_cube::cube_model::cube_state::cube_state(size_t size, std::span<const uint8_t> colors)
+    : cube_state(size)
+{
+    if (colors.size() != get_facelets_count()) {
+        throw std::runtime_error("wrong facelets count.");
+    }
+
+    for (uint32_t facelet = 0; facelet < colors.size(); ++facelet) {
+        if (colors[facelet] >= faces_count) {
+            throw std::runtime_error("wrong facelet color.");
+        }
+        set_color(facelet, colors[facelet]);
+    }
+}
+
+
+size_t rubiks_cube::cube_model::cube_state::get_size() const
+{
+    return m_tables.size;
+}
+
+
+size_t rubiks_cube::cube_model::cube_state::get_facelets_count() const
+{
+    return faces_count * m_tables.size * m_tables.size;
+}
+
+
+uint8_t rubiks_cube::cube_model::cube_state::get_color(uint32_t facelet) const
+{
+    const auto shift = facelet % facelets_per_word * color_bits;
+    return uint8_t(m_words[facelet / facelets_per_word] >> shift & 0b111);
+}
+
+
+uint8_t rubiks_cube::cube_model::cube_state::get_color(face f, uint32_t row, uint32_t col) const
+{
+    const auto size = uint32_t(m_tables.size);
+    return get_color(f * size * size + row * size + col);
+}
+
+
+void rubiks_cube::cube_model::cube_state::write_color(uint32_t facelet, uint8_t color)
+{
+    const auto shift = facelet % facelets_per_word * color_bits;
+    auto& word = m_words[facelet / facelets_per_word];
+    word = (word & ~(uint64_t(0b111) << shift)) | uint64_t(color) << shift;
+}
+
+
+void rubiks_cube::cube_model::cube_state::set_color(uint32_t facelet, uint8_t color)
+{
+    const auto prev_color = get_color(facelet);
+
+    if (prev_color == color) {
+        return;
+    }
+
+    write_color(facelet, color);
+
+    const auto face_size = uint32_t(m_tables.size * m_tables.size);
+    auto& counts = m_faces_colors_counts[facelet / face_size];
+
+    m_solved_faces_count -= counts[prev_color] == face_size ? 1 : 0;
+    --counts[prev_color];
+    ++counts[color];
+    m_solved_faces_count += counts[color] == face_size ? 1 : 0;
+}
+
+
+void rubiks_cube::cube_model::cube_state::apply(move m)
+{
+    const auto turns = uint32_t(m.turns % 4 + 4) % 4;
+
+    if (turns == 0) {
+        return;
+    }
+
+    const auto layer_index = m.axis * m_tables.size + m.layer;
+    const auto begin = m_tables.offsets[layer_index];
+    const auto end = m_tables.offsets[layer_index + 1];
+
+    const auto face_size = uint32_t(m_tables.size * m_tables.size);
+
+    for (auto i = begin; i < end; ++i) {
+        const auto& c = m_tables.cycles[i];
+
+        const uint8_t colors[4]{get_color(c[0]), get_color(c[1]), get_color(c[2]), get_color(c[3])};
+
+        // cycle of the turned face itself keeps its colors counts.
+        if (c[0] / face_size == c[1] / face_size) {
+            for (uint32_t k = 0; k < 4; ++k) {
+                write_color(c[(k + turns) % 4], colors[k]);
+            }
+            continue;
+        }
+
+        for (uint32_t k = 0; k < 4; ++k) {
+            set_color(c[(k + turns) % 4], colors[k]);
+        }
+    }
+}
+
+
+void rubiks_cube::cube_model::cube_state::apply(std::span<const move> moves)
+{
+    for (const auto m : moves) {
+        apply(m);
+    }
+}
+
+
+bool rubiks_cube::cube_model::cube_state::is_solved() const
+{
+    return m_solved_faces_count == faces_count;
+}
+
+
+bool rubiks_cube::cube_model::cube_state::is_each_face_single_colored() const
+{
+    const auto face_size = uint32_t(m_tables.size * m_tables.size);
+
+    for (uint32_t f = 0; f < faces_count; ++f) {
+        const auto color = get_color(f * face_size);
+        for (uint32_t i = 1; i < face_size; ++i) {
+            if (get_color(f * face_size + i) != color) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool rubiks_cube::cube_model::cube_state::operator==(const cube_state& r) const
+{
+    return m_tables.size == r.m_tables.size && m_words == r.m_words;
+}
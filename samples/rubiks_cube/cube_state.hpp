@@ -0,0 +1,239 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace rubiks_cube
+{
+    // logical cube, independent of rendering. facelet index is face * size^2 + row * size + col.
+    // faces rows/cols are: x faces - (y, z), y faces - (z, x), z faces - (y, x), in layers order.
+    // layer of an axis is the grid coordinate along it, 0 is the negative side.
+    namespace cube_model
+    {
+        enum face
+        {
+            pos_x,
+            neg_x,
+            pos_y,
+            neg_y,
+            pos_z,
+            neg_z,
+            faces_count
+        };
+
+        enum axis
+        {
+            x,
+            y,
+            z
+        };
+
+        // quarter turn of a layer moves facelet cycle[k] to cycle[k + 1].
+        using cycle = std::array<uint32_t, 4>;
+
+        // turns are counterclockwise quarter turns looking from the positive side of the axis (right hand rule).
+        struct move
+        {
+            cube_model::axis axis;
+            uint32_t layer;
+            int32_t turns;
+        };
+
+        constexpr size_t get_layer_cycles_count(size_t size, uint32_t layer)
+        {
+            const auto side_cycles = size;
+            const auto face_cycles = layer == 0 || layer + 1 == size ? size * size / 4 : 0;
+            return side_cycles + face_cycles;
+        }
+
+        namespace detail
+        {
+            // center of the sticker's cubie in doubled grid coordinates (center of the cube is 0) and sticker's outer normal.
+            struct location
+            {
+                std::array<int32_t, 3> pos;
+                std::array<int32_t, 3> normal;
+            };
+
+            // grid axes of face rows and cols.
+            constexpr std::array<std::array<uint32_t, 2>, 3> face_axes{{{y, z}, {z, x}, {y, x}}};
+
+            constexpr location get_location(size_t size, uint32_t facelet)
+            {
+                const auto face_size = uint32_t(size * size);
+                const auto f = facelet / face_size;
+                const auto row = facelet % face_size / uint32_t(size);
+                const auto col = facelet % uint32_t(size);
+                const auto face_axis = f / 2;
+                const auto sign = f % 2 == 0 ? 1 : -1;
+                const auto extent = int32_t(size) - 1;
+
+                location res{};
+                res.pos[face_axis] = sign * extent;
+                res.pos[face_axes[face_axis][0]] = int32_t(row) * 2 - extent;
+                res.pos[face_axes[face_axis][1]] = int32_t(col) * 2 - extent;
+                res.normal[face_axis] = sign;
+
+                return res;
+            }
+
+            constexpr uint32_t get_facelet(size_t size, const location& l)
+            {
+                uint32_t face_axis = 0;
+                while (l.normal[face_axis] == 0) {
+                    ++face_axis;
+                }
+
+                const auto f = face_axis * 2 + (l.normal[face_axis] > 0 ? 0 : 1);
+                const auto extent = int32_t(size) - 1;
+                const auto row = uint32_t((l.pos[face_axes[face_axis][0]] + extent) / 2);
+                const auto col = uint32_t((l.pos[face_axes[face_axis][1]] + extent) / 2);
+
+                return f * uint32_t(size * size) + row * uint32_t(size) + col;
+            }
+
+            constexpr std::array<int32_t, 3> rotate(std::array<int32_t, 3> v, axis a)
+            {
+                switch (a) {
+                    case x:
+                        return {v[0], -v[2], v[1]};
+                    case y:
+                        return {v[2], v[1], -v[0]};
+                    case z:
+                        return {-v[1], v[0], v[2]};
+                }
+                return v;
+            }
+
+            constexpr uint32_t rotate_facelet(size_t size, uint32_t facelet, axis a)
+            {
+                const auto l = get_location(size, facelet);
+                return get_facelet(size, {rotate(l.pos, a), rotate(l.normal, a)});
+            }
+
+            constexpr bool is_in_layer(size_t size, uint32_t facelet, axis a, uint32_t layer)
+            {
+                return get_location(size, facelet).pos[a] == int32_t(layer) * 2 - (int32_t(size) - 1);
+            }
+        } // namespace detail
+
+
+        // calls f(cycle) for every 4-cycle of the layer quarter turn. works in constant evaluation,
+        // so tables of fixed sizes are built at compile time.
+        template<typename Func>
+        constexpr void for_each_layer_cycle(size_t size, axis a, uint32_t layer, Func&& f)
+        {
+            const auto facelets_count = uint32_t(faces_count * size * size);
+
+            for (uint32_t facelet = 0; facelet < facelets_count; ++facelet) {
+                if (!detail::is_in_layer(size, facelet, a, layer)) {
+                    continue;
+                }
+
+                cycle c{facelet, 0, 0, 0};
+                bool is_first = true;
+
+                for (uint32_t k = 1; k < 4; ++k) {
+                    c[k] = detail::rotate_facelet(size, c[k - 1], a);
+                    // cycle is emitted once, from its smallest facelet. center of odd face is a fixed point.
+                    is_first = is_first && c[k] > facelet;
+                }
+
+                if (is_first) {
+                    f(c);
+                }
+            }
+        }
+
+
+        // cycles of all layers, layer (a, l) owns cycles [offsets[a * size + l], offsets[a * size + l + 1]).
+        struct move_tables_view
+        {
+            size_t size;
+            std::span<const cycle> cycles;
+            std::span<const uint32_t> offsets;
+        };
+
+
+        template<size_t Size>
+        struct static_move_tables
+        {
+            constexpr static size_t cycles_count = 3 * (Size * Size + 2 * (Size * Size / 4));
+
+            std::array<cycle, cycles_count> cycles{};
+            std::array<uint32_t, 3 * Size + 1> offsets{};
+        };
+
+
+        template<size_t Size>
+        constexpr static_move_tables<Size> make_static_move_tables()
+        {
+            static_move_tables<Size> res;
+            uint32_t count = 0;
+
+            for (uint32_t a = 0; a < 3; ++a) {
+                for (uint32_t layer = 0; layer < Size; ++layer) {
+                    res.offsets[a * Size + layer] = count;
+                    for_each_layer_cycle(Size, axis(a), layer, [&res, &count](const cycle& c) {
+                        res.cycles[count++] = c;
+                    });
+                }
+            }
+
+            res.offsets[3 * Size] = count;
+            return res;
+        }
+
+
+        template<size_t Size>
+        inline constexpr auto static_tables = make_static_move_tables<Size>();
+
+
+        // compile time tables for small sizes, generated once for others.
+        move_tables_view get_move_tables(size_t size);
+
+
+        // facelets colors packed as 3 bits, 21 facelets per word. solved cube has color of face f on face f.
+        // colors count of every face is kept along, so solved check doesn't scan facelets.
+        class cube_state
+        {
+        public:
+            constexpr static uint32_t color_bits = 3;
+            constexpr static uint32_t facelets_per_word = 64 / color_bits;
+
+            explicit cube_state(size_t size);
+            // colors of all facelets, in facelets order.
+            cube_state(size_t size, std::span<const uint8_t> colors);
+
+            size_t get_size() const;
+            size_t get_facelets_count() const;
+
+            uint8_t get_color(uint32_t facelet) const;
+            uint8_t get_color(face f, uint32_t row, uint32_t col) const;
+
+            void apply(move);
+            void apply(std::span<const move>);
+
+            // every face has a single color, centers may be moved by middle layers.
+            bool is_solved() const;
+            // same as is_solved, but scans all facelets instead of the colors counts.
+            bool is_each_face_single_colored() const;
+
+            bool operator==(const cube_state&) const;
+
+        private:
+            // keeps faces colors counts.
+            void set_color(uint32_t facelet, uint8_t color);
+            void write_color(uint32_t facelet, uint8_t color);
+
+            move_tables_view m_tables;
+            std::vector<uint64_t> m_words;
+            std::array<std::array<uint32_t, faces_count>, faces_count> m_faces_colors_counts{};
+            // faces which have all facelets of one color.
+            uint32_t m_solved_faces_count{0};
+        };
+    } // namespace cube_model
+} // namespace rubiks_cube
@@ -8,13 +8,14 @@
 #include "rubiks_cube.hpp"
 #include "quad.hpp"
 
+#include <stdexcept>
+
 renderer::camera camera{};
 bool mouse_clicked = false;
 
-// added limitations because of limits for ubo size
-// so... we can pack matrices into textures, but... deadline is coming
+// cubes matrices are in instance stream, so size is limited by max texture buffer size only.
 constexpr auto MIN_CUBE_SIZE = 3;
-constexpr auto MAX_CUBE_SIZE = 7;
+constexpr auto MAX_CUBE_SIZE = 101;
 
 constexpr auto KEY_UP = 265;
 constexpr auto KEY_DOWN = 264;
@@ -28,6 +29,8 @@ int main()
     camera.height = 600;
 
     auto* r = window.get_renderer();
+    r->set_program_cache_directory("shaders_cache");
+    ::rubiks_cube::rubiks_cube::prewarm_shaders(r);
 
     auto cube = std::make_unique<::rubiks_cube::rubiks_cube>(r, curr_cube_size);
     rubiks_cube::indication_quad quad(r);
@@ -42,9 +45,14 @@ int main()
             switch (e.key_code) {
                 case KEY_UP:
                     if (curr_cube_size + 2 <= MAX_CUBE_SIZE) {
-                        curr_cube_size += 2;
                         cube.reset();
-                        cube = std::make_unique<::rubiks_cube::rubiks_cube>(r, curr_cube_size);
+                        try {
+                            cube = std::make_unique<::rubiks_cube::rubiks_cube>(r, curr_cube_size + 2);
+                            curr_cube_size += 2;
+                        } catch (const std::runtime_error&) {
+                            // instance stream doesn't fit into texture buffer of this gpu, the size stays.
+                            cube = std::make_unique<::rubiks_cube::rubiks_cube>(r, curr_cube_size);
+                        }
                         camera.position = {-10, 10, -10};
                     }
                     break;
@@ -15,35 +15,40 @@ rubiks_cube::rotation_manager::rotation_manager(size_t size)
 
 void rubiks_cube::rotation_manager::update(double delta_time)
 {
-    if (m_animations_queue.empty()) {
-        while (!m_disable_update_rows_queue.empty()) {
-            auto* row = m_disable_update_rows_queue.back();
-            row->need_cubes_update_position = false;
-            m_disable_update_rows_queue.pop();
-        }
-        return;
+    // rows queued till the previous update have moved their cubes on that frame, other rows keep waiting.
+    for (; m_queued_rows_to_disable > 0; --m_queued_rows_to_disable) {
+        m_disable_update_rows_queue.front()->need_cubes_update_position = false;
+        m_disable_update_rows_queue.pop();
     }
 
-    auto& anim = m_animations_queue.front();
-    auto offset = delta_time * 10.0f * anim.direction;
+    if (!m_animations_queue.empty()) {
+        auto& anim = m_animations_queue.front();
+        auto offset = delta_time * 10.0f * anim.direction;
 
-    auto animation_finished = (anim.direction < 0 ? (anim.row->angle + offset <= anim.bind_point) : (anim.row->angle + offset >= anim.bind_point));
+        auto animation_finished = (anim.direction < 0 ? (anim.row->angle + offset <= anim.bind_point) : (anim.row->angle + offset >= anim.bind_point));
 
-    if (animation_finished) {
-        anim.row->need_cubes_update_position = true;
-        anim.row->update_direction = anim.direction;
+        if (animation_finished) {
+            anim.row->need_cubes_update_position = true;
 
-        m_animations_queue.pop();
+            // finished row stops moving its cubes, unchanged rows are skipped by cubes updates.
+            anim.row->angle_offset = 0;
+            anim.row->update_direction = int(round(sin(anim.bind_point)));
+            anim.row->angle = 0;
+            m_disable_update_rows_queue.push(anim.row);
 
-        anim.row->angle_offset = 0;
-        anim.row->update_direction = int(round(sin(anim.bind_point)));
-        m_rows[m_acquired_axis][m_acquired_row].angle = 0;
-        m_acquired_row = uint32_t(-1);
-        m_disable_update_rows_queue.push(anim.row);
-    } else {
-        anim.row->angle_offset = offset;
-        anim.row->angle += offset;
+            // another row may be acquired while this one was animated.
+            if (is_any_row_acquired() && &m_rows[m_acquired_axis][m_acquired_row] == anim.row) {
+                m_acquired_row = uint32_t(-1);
+            }
+
+            m_animations_queue.pop();
+        } else {
+            anim.row->angle_offset = offset;
+            anim.row->angle += offset;
+        }
     }
+
+    m_queued_rows_to_disable = m_disable_update_rows_queue.size();
 }
 
 
@@ -101,12 +106,24 @@ void rubiks_cube::rotation_manager::rotate_cube(rubiks_cube::cube& c)
     c.rotate(axis::y, row_y.angle_offset);
     c.rotate(axis::z, row_z.angle_offset);
 
-    if (row_x.need_cubes_update_position) {
-        c.update_position(axis::x, row_x.update_direction);
-    } else if (row_y.need_cubes_update_position) {
-        c.update_position(axis::y, row_y.update_direction);
-    } else if (row_z.need_cubes_update_position) {
-        c.update_position(axis::z, row_z.update_direction);
+    // finished turn is applied to the logical cube state, cube itself returns to its place.
+    if (row_x.need_cubes_update_position || row_y.need_cubes_update_position || row_z.need_cubes_update_position) {
+        c.reset_rotation();
+    }
+}
+
+
+void rubiks_cube::rotation_manager::get_active_rows(std::vector<row_index>& rows) const
+{
+    rows.clear();
+
+    for (uint32_t a = 0; a < m_rows.size(); ++a) {
+        for (uint32_t i = 0; i < m_rows[a].size(); ++i) {
+            const auto& row = m_rows[a][i];
+            if (row.angle_offset != 0 || row.need_cubes_update_position) {
+                rows.emplace_back(row_index{axis(a), i, row.need_cubes_update_position ? row.update_direction : 0});
+            }
+        }
     }
 }
 
@@ -124,6 +141,10 @@ void rubiks_cube::rotation_manager::acquire_row(rubiks_cube::rotation_manager::a
 
 void rubiks_cube::rotation_manager::release_row()
 {
+    if (!is_any_row_acquired()) {
+        return;
+    }
+
     auto& row = m_rows[m_acquired_axis][m_acquired_row];
     auto& anim = m_animations_queue.emplace();
 
@@ -18,7 +18,7 @@ namespace rubiks_cube
     struct row
     {
         float angle{0};
-        float angle_offset;
+        float angle_offset{0};
         int update_direction = 0;
         bool need_cubes_update_position = false;
     };
@@ -44,6 +44,14 @@ namespace rubiks_cube
             z
         };
 
+        struct row_index
+        {
+            rotation_manager::axis axis;
+            uint32_t index;
+            // quarter turns finished on this frame, 0 while the row is only rotating.
+            int32_t turns;
+        };
+
         void acquire_row(axis axis, uint32_t index);
         void release_row();
         void rotate(float angle);
@@ -51,10 +59,14 @@ namespace rubiks_cube
         void rotate_cube(cube& c);
         void update(double delta);
 
+        // rows which rotate or move their cubes on this frame, rotate_cube is no-op for cubes outside them.
+        void get_active_rows(std::vector<row_index>& rows) const;
+
     private:
         std::array<std::vector<row>, 3> m_rows;
         std::queue<rotation_animation> m_animations_queue;
         std::queue<row*> m_disable_update_rows_queue;
+        size_t m_queued_rows_to_disable = 0;
         size_t m_size;
         uint32_t m_acquired_row{uint32_t(-1)};
         axis m_acquired_axis{axis::x};
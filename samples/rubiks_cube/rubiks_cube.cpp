@@ -4,37 +4,51 @@
 
 #include <misc/images_loader.hpp>
 #include <math/matrix_operations.hpp>
+#include <math/raytracing/ray.hpp>
 
-#include <sstream>
+#include <algorithm>
+#include <cmath>
 
 
 namespace
 {
-    std::string generate_cubes_vert_shader(size_t cubes_count)
-    {
-        std::ostringstream oss;
-        oss << R"(#version 410 core
+    // faces colors texture keeps this many cubes in a row, its height stays in texture size limits.
+    constexpr size_t cubes_per_faces_row = 256;
+
+    constexpr auto vss = R"(#version 410 core
 layout (location = 0) in vec3 attr_pos;
+layout (location = 1) in float attr_face;
+// cubes are instances of one draw, draw id is index of the first of them.
+layout (location = 15) in uint attr_draw_id;
 
-layout (std140) uniform instance_data
+layout (std140) uniform cube_data
 {
-    mat4 mvp)"
-            << "[" << cubes_count << "];\n"
-            << R"(
+    mat4 view_model;
 };
 
-
+// model matrix columns of every cube, only cubes of rotating rows change them.
+uniform samplerBuffer s_instances;
 uniform sampler2D s_faces_colors;
 
 out vec4 v_color;
 
+const int cubes_per_faces_row = 256;
+
 void main()
 {
-    gl_Position = mvp[gl_InstanceID] * vec4(attr_pos, 1.);
-    v_color = texelFetch(s_faces_colors, ivec2(gl_VertexID / 6, gl_InstanceID), 0);
+    int cube = int(attr_draw_id) + gl_InstanceID;
+    int base = cube * 4;
+    mat4 model = mat4(
+        texelFetch(s_instances, base),
+        texelFetch(s_instances, base + 1),
+        texelFetch(s_instances, base + 2),
+        texelFetch(s_instances, base + 3));
+
+    gl_Position = view_model * model * vec4(attr_pos, 1.);
+
+    ivec2 face_texel = ivec2((cube % cubes_per_faces_row) * 6 + int(attr_face), cube / cubes_per_faces_row);
+    v_color = texelFetch(s_faces_colors, face_texel, 0);
 })";
-        return oss.str();
-    }
 
     constexpr auto fss = R"(#version 410 core
 layout (location = 0) out vec4 frag_color;
@@ -94,6 +108,37 @@ void main()
         -0.5f, -0.5f, -0.5f,
     };
     // clang-format on
+
+    constexpr size_t vertices_count = sizeof(vertices) / sizeof(float) / 3;
+
+    // gl_VertexID of shared storage mesh is offset by its base vertex, faces are passed as attribute.
+    std::vector<uint8_t> get_vertex_data()
+    {
+        std::vector<float> data;
+        data.reserve(vertices_count * 4);
+
+        for (size_t i = 0; i < vertices_count; ++i) {
+            data.insert(data.end(), vertices + i * 3, vertices + i * 3 + 3);
+            data.emplace_back(float(i / 6));
+        }
+
+        auto begin = reinterpret_cast<const uint8_t*>(data.data());
+        return {begin, begin + data.size() * sizeof(float)};
+    }
+
+
+    std::vector<renderer::shader_stage> get_shader_stages()
+    {
+        return {
+            {
+                .name = renderer::shader_stage_name::vertex,
+                .code = vss,
+            },
+            {
+                .name = renderer::shader_stage_name::fragment,
+                .code = fss,
+            }};
+    }
 } // namespace
 
 
@@ -101,6 +146,7 @@ rubiks_cube::rubiks_cube::rubiks_cube(renderer::renderer* renderer, size_t size)
     : m_size(size)
     , rotation_manager(size)
     , m_renderer(renderer)
+    , m_state(size)
 {
     if (size % 2 == 0) {
         throw std::runtime_error("don't support even size.");
@@ -113,16 +159,12 @@ rubiks_cube::rubiks_cube::rubiks_cube(renderer::renderer* renderer, size_t size)
 
     m_cubes.reserve(size * size * size);
 
-    renderer::parameters_list_descriptor params_list_descriptor{
-        .parameters = {size * size * size, renderer::parameter_type::mat4}};
-
     for (int x = 0; x < size; ++x) {
         for (int y = 0; y < size; ++y) {
             for (int z = 0; z < size; ++z) {
                 auto& new_cube = m_cubes.emplace_back(
                     math::ivec3{int32_t(x_pos), int32_t(y_pos), int32_t(z_pos)});
                 new_cube.color = {float(x) / float(m_size), float(y) / float(m_size), float(z) / float(m_size), 1.f};
-                get_faces_color_by_position(new_cube, new_cube.get_position());
                 z_pos += stride;
             }
             z_pos = -rubiks_cube_size / 2;
@@ -132,38 +174,55 @@ rubiks_cube::rubiks_cube::rubiks_cube(renderer::renderer* renderer, size_t size)
         x_pos += stride;
     }
 
+    // cubes are created in grid order.
+    for (size_t i = 0; i < m_cubes.size(); ++i) {
+        update_cube_colors(i);
+    }
+
+    m_instances_data.resize(m_cubes.size());
+
+    for (uint32_t i = 0; i < m_cubes.size(); ++i) {
+        m_instances_data[i] = math::transpose(m_cubes[i].get_transformation());
+    }
+
+    m_instances = m_renderer->create_instance_stream({.element_type = renderer::parameter_type::mat4, .elements_count = m_cubes.size()});
+    m_renderer->set_instance_data(m_instances, 0, uint32_t(m_instances_data.size()), m_instances_data.data());
+
+    // after the instance stream, which throws if cubes don't fit, so nothing is left to destroy then.
     create_cubes_colors_texture();
 
-    m_params_list = m_renderer->create_parameters_list(params_list_descriptor);
+    m_params_list = m_renderer->create_parameters_list({.parameters = {renderer::parameter_type::mat4}});
 
     renderer::shader_descriptor shader_descriptor{
-        .stages = {
-            {
-                .name = renderer::shader_stage_name::vertex,
-                .code = generate_cubes_vert_shader(m_cubes.size()),
-            },
-            {
-                .name = renderer::shader_stage_name::fragment,
-                .code = fss,
-            }},
+        .stages = get_shader_stages(),
         .samplers = {{"s_faces_colors", m_cubes_faces_texture}},
-        .parameters = {{"instance_data", m_params_list}},
+        .parameters = {{"cube_data", m_params_list}},
         .state = {.depth_test = renderer::depth_test_mode::less_eq}};
 
     m_draw_shader = m_renderer->create_shader(shader_descriptor);
+    m_renderer->set_shader_instance_stream(m_draw_shader, m_instances, "s_instances");
 
     renderer::mesh_layout_descriptor mesh_descriptor{
         .vertex_attributes = {
-            {renderer::data_type::f32, 3}},
-        .vertex_data = {reinterpret_cast<const uint8_t*>(vertices), reinterpret_cast<const uint8_t*>(vertices) + sizeof(vertices)}};
+            {renderer::data_type::f32, 3},
+            {renderer::data_type::f32, 1}},
+        .vertex_data = get_vertex_data(),
+        .shared_storage = true};
 
     m_cube_mesh = m_renderer->create_mesh(mesh_descriptor);
 }
 
 
+void rubiks_cube::rubiks_cube::prewarm_shaders(renderer::renderer* renderer)
+{
+    renderer->prewarm_shaders({renderer::shader_descriptor{.stages = get_shader_stages()}});
+}
+
+
 void rubiks_cube::rubiks_cube::draw()
 {
-    m_renderer->encode_draw_command({.type = ::renderer::draw_command_type::draw, .mesh = m_cube_mesh, .shader = m_draw_shader, .instances_count = uint32_t(m_cubes.size())});
+    // one instanced draw of the shared storage mesh, it is batched with other multi draws of the arena.
+    m_renderer->encode_draw_command({.type = ::renderer::draw_command_type::multi_draw, .mesh = m_cube_mesh, .shader = m_draw_shader, .instances_count = uint32_t(m_cubes.size())});
 }
 
 
@@ -173,182 +232,189 @@ void rubiks_cube::rubiks_cube::update(double delta_time)
 
     auto rot_m = math::rotation_x(m_rotation.x) * math::rotation_y(m_rotation.y);
     m_transform = rot_m;
+    // pure rotation, inverse is transpose. picking reuses it till the next update.
+    m_world_to_model = math::transpose(rot_m);
+
+    auto view_model = math::transpose(parent_transform * m_transform);
+    m_renderer->set_parameter_data(m_params_list, 0, &view_model[0][0]);
 
-    math::mat4 m = parent_transform * m_transform;
+    // only cubes of rotating rows move, the rest keep their matrices and faces.
+    collect_moving_cubes();
 
-    for (int i = 0; i < m_cubes.size(); ++i) {
+    m_changed_faces_rows.clear();
+
+    for (auto i : m_moving_cubes) {
         auto& cube = m_cubes[i];
         rotation_manager.rotate_cube(cube);
-        auto cube_transform = math::transpose(m * cube.get_transformation());
-        m_renderer->set_parameter_data(m_params_list, i, &cube_transform[0][0]);
+
+        m_instances_data[i] = math::transpose(cube.get_transformation());
+        m_renderer->set_instance_data(m_instances, i, 1, &m_instances_data[i]);
+    }
+
+    // cubes stay at their grid positions, finished turn only changes colors of the turned layer.
+    for (const auto& row : m_active_rows) {
+        if (row.turns == 0) {
+            continue;
+        }
+
+        const auto layer = row.axis == rotation_manager::axis::z ? uint32_t(m_size) - 1 - row.index : row.index;
+        m_state.apply({cube_model::axis(row.axis), layer, row.turns});
+
+        for_each_cube_in_row(row, [this](uint32_t i) {
+            update_cube_colors(i);
+            update_cube_faces_texture_data(i);
+            m_changed_faces_rows.emplace_back(i / cubes_per_faces_row);
+        });
     }
 
-    // i know that this is BAD solution. But deadline is coming...
-    upload_cube_faces_texture_data();
-    m_renderer->load_texture_data(m_cubes_faces_texture, {6, m_cubes.size(), 1}, m_faces_texture_data.data());
+    upload_changed_faces_rows();
 }
 
 
-bool rubiks_cube::rubiks_cube::hit(math::ray ray, face& face, math::vec3& out_hit_point)
+void rubiks_cube::rubiks_cube::collect_moving_cubes()
 {
-    static math::vec3 vertices[] = {
-        // pos x
-        {0.5f, -0.5f, 0.5f},
-        {0.5f, -0.5f, -0.5f},
-        {0.5f, 0.5f, -0.5f},
-        {0.5f, 0.5f, 0.5f},
-
-        // neg x
-        {-0.5f, 0.5f, -0.5f},
-        {-0.5f, -0.5f, -0.5f},
-        {-0.5f, -0.5f, 0.5f},
-        {-0.5f, 0.5f, 0.5f},
-
-        // pos y
-        {-0.5f, 0.5f, 0.5f},
-        {0.5f, 0.5f, 0.5f},
-        {0.5f, 0.5f, -0.5f},
-        {-0.5f, 0.5f, -0.5f},
-
-        // neg y
-        {-0.5f, -0.5f, -0.5f},
-        {0.5f, -0.5f, -0.5f},
-        {0.5f, -0.5f, 0.5f},
-        {-0.5f, -0.5f, 0.5f},
-
-        // pos z
-        {-0.5f, -0.5f, 0.5f},
-        {0.5f, -0.5f, 0.5f},
-        {0.5f, 0.5f, 0.5f},
-        {-0.5f, 0.5f, 0.5f},
-
-        // neg z
-        {-0.5f, 0.5f, -0.5f},
-        {0.5f, 0.5f, -0.5f},
-        {0.5f, -0.5f, -0.5f},
-        {-0.5f, -0.5f, -0.5f},
-    };
+    m_moving_cubes.clear();
+    rotation_manager.get_active_rows(m_active_rows);
+
+    for (const auto& row : m_active_rows) {
+        for_each_cube_in_row(row, [this](uint32_t i) {
+            m_moving_cubes.emplace_back(i);
+        });
+    }
+
+    // cube at the crossing of two active rows is rotated once.
+    if (m_active_rows.size() > 1) {
+        std::sort(m_moving_cubes.begin(), m_moving_cubes.end());
+        m_moving_cubes.erase(std::unique(m_moving_cubes.begin(), m_moving_cubes.end()), m_moving_cubes.end());
+    }
+}
+
 
-    std::vector<int> hit_surfaces;
-
-    auto world_to_model = math::inverse(m_transform);
-
-    math::vec4 ray_model_from{ray.from.x, ray.from.y, ray.from.z, 1};
-    ray_model_from = world_to_model * ray_model_from;
-
-    math::vec4 ray_model_to{ray.to.x, ray.to.y, ray.to.z, 1};
-    ray_model_to = world_to_model * ray_model_to;
-
-    ray.from = {ray_model_from.x, ray_model_from.y, ray_model_from.z};
-    ray.to = {ray_model_to.x, ray_model_to.y, ray_model_to.z};
-
-    bool intersection_success = false;
-    math::vec3 intersection_hit_point;
-    uint32_t intersection_face = 0;
-
-    for (int i = 0; i < std::size(vertices); i += 4) {
-        auto e1 = vertices[i + 1] - vertices[i];
-        auto e2 = vertices[i + 3] - vertices[i];
-        auto n = math::normalize(math::cross(e1, e2));
-        math::vec3 hit_point;
-        auto hit_success = math::hit_with_surface(ray, vertices[i] * m_size, n, hit_point);
-
-        if (hit_success) {
-            math::vec3 scaled_vertices[]{
-                vertices[i] * m_size,
-                vertices[i + 1] * m_size,
-                vertices[i + 2] * m_size,
-                vertices[i + 3] * m_size,
-            };
-
-            if (math::is_point_inside_polygon(hit_point, scaled_vertices, 4)) {
-                if (!intersection_success) {
-                    intersection_hit_point = hit_point;
-                    intersection_success = true;
-                    intersection_face = i / 4;
-                } else {
-                    auto dist = math::length(hit_point - ray.from);
-                    auto last_dist = math::length(intersection_hit_point - ray.from);
-                    if (dist < last_dist) {
-                        intersection_face = i / 4;
-                        intersection_hit_point = hit_point;
-                    }
-                }
+template<typename Func>
+void rubiks_cube::rubiks_cube::for_each_cube_in_row(const rotation_manager::row_index& row, Func&& f) const
+{
+    const int half_size = int(m_size) / 2;
+
+    for (int a = -half_size; a <= half_size; ++a) {
+        for (int b = -half_size; b <= half_size; ++b) {
+            math::ivec3 pos;
+
+            switch (row.axis) {
+                case rotation_manager::axis::x:
+                    pos = {int(row.index) - half_size, a, b};
+                    break;
+                case rotation_manager::axis::y:
+                    pos = {a, int(row.index) - half_size, b};
+                    break;
+                case rotation_manager::axis::z:
+                    pos = {a, b, half_size - int(row.index)};
+                    break;
             }
+
+            f(uint32_t(get_grid_index(pos)));
         }
     }
+}
+
+
+void rubiks_cube::rubiks_cube::upload_changed_faces_rows()
+{
+    if (m_changed_faces_rows.empty()) {
+        return;
+    }
+
+    std::sort(m_changed_faces_rows.begin(), m_changed_faces_rows.end());
+    m_changed_faces_rows.erase(std::unique(m_changed_faces_rows.begin(), m_changed_faces_rows.end()), m_changed_faces_rows.end());
+
+    const auto texture_size = get_faces_texture_size();
 
-    face = rubiks_cube::face(intersection_face);
-    out_hit_point = intersection_hit_point;
+    // adjacent texture rows are loaded with one call.
+    for (size_t i = 0; i < m_changed_faces_rows.size();) {
+        const auto first_row = m_changed_faces_rows[i];
+        auto rows_count = 1;
 
-    return intersection_success;
+        for (++i; i < m_changed_faces_rows.size() && m_changed_faces_rows[i] == first_row + rows_count; ++i) {
+            ++rows_count;
+        }
+
+        m_renderer->load_texture_region(
+            m_cubes_faces_texture,
+            {.width = 0, .height = first_row},
+            {.width = texture_size.width, .height = size_t(rows_count)},
+            m_faces_texture_data.data() + first_row * texture_size.width);
+    }
 }
 
 
-math::ivec2 rubiks_cube::rubiks_cube::get_row_col_by_hit_pos(face& face, math::vec3 hit_point)
+size_t rubiks_cube::rubiks_cube::get_grid_index(math::ivec3 pos) const
 {
-    float x_min = -float(m_size) / 2;
-    float y_min = -float(m_size) / 2;
-
-    math::ivec2 res;
-
-    for (int x = 0; x < m_size; ++x) {
-        switch (face) {
-            case pos_x:
-                [[fallthrough]];
-            case neg_x:
-                if (hit_point.z >= x_min && hit_point.z <= x_min + 1) {
-                    res.x = (m_size - 1) - x; // in reverse order
-                }
-                break;
-            case pos_y:
-                [[fallthrough]];
-            case neg_y:
-                if (hit_point.x >= x_min && hit_point.x <= x_min + 1) {
-                    res.y = x; // yes y = x
-                }
-            case pos_z:
-                [[fallthrough]];
-            case neg_z:
-                if (hit_point.x >= x_min && hit_point.x <= x_min + 1) {
-                    res.x = x;
-                }
-                break;
-            default:
-                throw std::runtime_error("invalid face");
-        }
+    const int half_size = int(m_size) / 2;
+    return (size_t(pos.x + half_size) * m_size + size_t(pos.y + half_size)) * m_size + size_t(pos.z + half_size);
+}
+
+
+bool rubiks_cube::rubiks_cube::hit(math::ray ray, face& face, math::vec3& out_hit_point)
+{
+    const auto half_size = float(m_size) / 2;
+    const math::bound_boxes::bound3 bound{{-half_size, -half_size, -half_size}, {half_size, half_size, half_size}};
+
+    math::vec4 from{ray.from.x, ray.from.y, ray.from.z, 1};
+    from = m_world_to_model * from;
+
+    math::vec4 to{ray.to.x, ray.to.y, ray.to.z, 1};
+    to = m_world_to_model * to;
 
-        x_min += 1;
+    const math::raytracing::ray3 model_ray{
+        .origin = {from.x, from.y, from.z},
+        .direction = {to.x - from.x, to.y - from.y, to.z - from.z}};
+
+    // ray is the segment from -> to, t is a fraction of it.
+    float t = 0;
+    if (!math::raytracing::intersect(model_ray, bound, &t, static_cast<float*>(nullptr), 1.f)) {
+        return false;
     }
 
-    for (int y = 0; y < m_size; ++y) {
-        switch (face) {
-            case pos_y:
-                [[fallthrough]];
-            case neg_y:
-                if (hit_point.z >= y_min && hit_point.z <= y_min + 1) {
-                    res.x = (m_size - 1) - y;
-                }
-                break;
-            case pos_x:
-                [[fallthrough]];
-            case neg_x:
-                [[fallthrough]];
-            case pos_z:
-                [[fallthrough]];
-            case neg_z:
-                if (hit_point.y >= y_min && hit_point.y <= y_min + 1) {
-                    res.y = y;
-                }
-                break;
-            default:
-                throw std::runtime_error("invalid face");
-        }
+    out_hit_point = model_ray(t);
 
-        y_min += 1;
+    // entry point lies on the face of its largest coordinate.
+    const float coords[]{out_hit_point.x, out_hit_point.y, out_hit_point.z};
+    uint32_t axis = 0;
+    for (uint32_t a = 1; a < 3; ++a) {
+        axis = std::abs(coords[a]) > std::abs(coords[axis]) ? a : axis;
     }
 
-    return res;
+    face = rubiks_cube::face(axis * 2 + (coords[axis] >= 0 ? 0 : 1));
+
+    return true;
+}
+
+
+math::ivec2 rubiks_cube::rubiks_cube::get_row_col_by_hit_pos(face& face, math::vec3 hit_point)
+{
+    const auto half_size = float(m_size) / 2;
+    const auto last = int32_t(m_size) - 1;
+
+    // point on the boundary of two cubes belongs to the upper one.
+    const auto get_cell = [half_size, last](float coord) {
+        return std::clamp(int32_t(std::floor(coord + half_size)), 0, last);
+    };
+
+    switch (face) {
+        case pos_x:
+            [[fallthrough]];
+        case neg_x:
+            return {last - get_cell(hit_point.z), get_cell(hit_point.y)}; // in reverse order
+        case pos_y:
+            [[fallthrough]];
+        case neg_y:
+            return {last - get_cell(hit_point.z), get_cell(hit_point.x)}; // yes y = x
+        case pos_z:
+            [[fallthrough]];
+        case neg_z:
+            return {get_cell(hit_point.x), get_cell(hit_point.y)};
+        default:
+            throw std::runtime_error("invalid face");
+    }
 }
 
 
@@ -401,85 +467,75 @@ void rubiks_cube::rubiks_cube::rotate(math::vec3 angles)
 
 void rubiks_cube::rubiks_cube::create_cubes_colors_texture()
 {
-    m_faces_texture_data.resize(6 * m_cubes.size());
-    upload_cube_faces_texture_data();
+    const auto size = get_faces_texture_size();
+    m_faces_texture_data.resize(size.width * size.height);
+
+    for (size_t i = 0; i < m_cubes.size(); ++i) {
+        update_cube_faces_texture_data(i);
+    }
 
     auto begin = reinterpret_cast<uint8_t*>(m_faces_texture_data.data());
-    auto end = begin + m_faces_texture_data.size() * sizeof(math::vec4);
+    auto end = begin + m_faces_texture_data.size() * sizeof(math::ubvec4);
 
     renderer::texture_descriptor descriptor{
         .pixels_data_type = renderer::data_type::u8,
         .format = renderer::texture_format::rgba,
         .type = renderer::texture_type::d2,
-        .size = {
-            .width = 6,
-            .height = m_cubes.size(),
-            .length = 1},
+        .size = size,
         .pixels = {begin, end}};
 
     m_cubes_faces_texture = m_renderer->create_texture(descriptor);
 }
 
 
-void rubiks_cube::rubiks_cube::get_faces_color_by_position(cube& cube, math::ivec3 pos)
+void rubiks_cube::rubiks_cube::update_cube_colors(size_t cube_index)
 {
-    const auto min_pos = -int(m_size) / 2;
-    const auto max_pos = int(m_size) / 2;
-
-    if (pos.x == min_pos) {
-        cube.faces[0].color = {255, 0, 0, 255};
-        cube.faces[1].color = {0, 0, 0, 255};
-    } else if (pos.x == max_pos) {
-        cube.faces[0].color = {0, 0, 0, 255};
-        cube.faces[1].color = {0, 255, 0, 255};
-    } else {
-        cube.faces[0].color = {0, 0, 0, 255};
-        cube.faces[1].color = {0, 0, 0, 255};
-    }
-
-    if (pos.y == min_pos) {
-        cube.faces[2].color = {0, 0, 255, 255};
-        cube.faces[3].color = {0, 0, 0, 255};
-    } else if (pos.y == max_pos) {
-        cube.faces[2].color = {0, 0, 0, 255};
-        cube.faces[3].color = {255, 255, 0, 255};
-    } else {
-        cube.faces[2].color = {0, 0, 0, 255};
-        cube.faces[3].color = {0, 0, 0, 255};
-    }
-
-    if (pos.z == min_pos) {
-        cube.faces[4].color = {255, 175, 0, 255};
-        cube.faces[5].color = {0, 0, 0, 255};
-    } else if (pos.z == max_pos) {
-        cube.faces[4].color = {0, 0, 0, 255};
-        cube.faces[5].color = {255, 255, 255, 255};
-    } else {
-        cube.faces[4].color = {0, 0, 0, 255};
-        cube.faces[5].color = {0, 0, 0, 255};
-    }
+    // colors of solved cube faces, in cube_model::face order.
+    constexpr math::ubvec4 colors[]{
+        {0, 255, 0, 255},
+        {255, 0, 0, 255},
+        {255, 255, 0, 255},
+        {0, 0, 255, 255},
+        {255, 255, 255, 255},
+        {255, 175, 0, 255}};
+
+    constexpr math::ubvec4 inner_color{0, 0, 0, 255};
+
+    const auto last = uint32_t(m_size) - 1;
+    const auto x = uint32_t(cube_index / (m_size * m_size));
+    const auto y = uint32_t(cube_index / m_size % m_size);
+    const auto z = uint32_t(cube_index % m_size);
+
+    auto& faces = m_cubes[cube_index].faces;
+
+    // face with normal n is drawn on the -n side of the cube mesh.
+    faces[0].color = x == 0 ? colors[m_state.get_color(cube_model::neg_x, y, z)] : inner_color;
+    faces[1].color = x == last ? colors[m_state.get_color(cube_model::pos_x, y, z)] : inner_color;
+    faces[2].color = y == 0 ? colors[m_state.get_color(cube_model::neg_y, z, x)] : inner_color;
+    faces[3].color = y == last ? colors[m_state.get_color(cube_model::pos_y, z, x)] : inner_color;
+    faces[4].color = z == 0 ? colors[m_state.get_color(cube_model::neg_z, y, x)] : inner_color;
+    faces[5].color = z == last ? colors[m_state.get_color(cube_model::pos_z, y, x)] : inner_color;
 }
 
 
-void rubiks_cube::rubiks_cube::upload_cube_faces_texture_data()
+void rubiks_cube::rubiks_cube::update_cube_faces_texture_data(size_t cube_index)
 {
-    for (int i = 0; i < m_cubes.size(); ++i) {
-        auto& cube = m_cubes[i];
-
-        for (const auto& face : cube.faces) {
-            auto index = std::abs(face.normal.x) > 0 ? face.normal.x * 0.5 + 0.5 : 0;
-            index += std::abs(face.normal.y) > 0 ? 2 + face.normal.y * 0.5 + 0.5 : 0;
-            index += std::abs(face.normal.z) > 0 ? 4 + face.normal.z * 0.5 + 0.5 : 0;
-            m_faces_texture_data[i * 6 + index] = face.color;
-        }
+    for (const auto& face : m_cubes[cube_index].faces) {
+        auto index = std::abs(face.normal.x) > 0 ? face.normal.x * 0.5 + 0.5 : 0;
+        index += std::abs(face.normal.y) > 0 ? 2 + face.normal.y * 0.5 + 0.5 : 0;
+        index += std::abs(face.normal.z) > 0 ? 4 + face.normal.z * 0.5 + 0.5 : 0;
+        // rows are cubes_per_faces_row cubes wide, so texel of the face is still at i * 6 + index.
+        m_faces_texture_data[cube_index * 6 + index] = face.color;
     }
 }
 
 
 rubiks_cube::rubiks_cube::~rubiks_cube()
 {
+    m_renderer->destroy_instance_stream(m_instances);
     m_renderer->destroy_parameters_list(m_params_list);
     m_renderer->destroy_shader(m_draw_shader);
+    m_renderer->destroy_mesh(m_cube_mesh);
     m_renderer->destroy_texture(m_cubes_faces_texture);
 }
 
@@ -490,81 +546,14 @@ size_t rubiks_cube::rubiks_cube::get_size()
 }
 
 
-bool rubiks_cube::rubiks_cube::is_assembled() const
+renderer::texture_size rubiks_cube::rubiks_cube::get_faces_texture_size() const
 {
-    const auto min_pos = -int(m_size) / 2;
-    const auto max_pos = int(m_size) / 2;
-
-    size_t neg_x_iters = 0;
-    size_t pos_x_iters = 0;
-
-    math::ubvec4 last_neg_x_color;
-    math::ubvec4 last_pos_x_color;
-
-    size_t neg_y_iters = 0;
-    size_t pos_y_iters = 0;
-
-    math::ubvec4 last_neg_y_color;
-    math::ubvec4 last_pos_y_color;
-
-    size_t neg_z_iters = 0;
-    size_t pos_z_iters = 0;
-
-    math::ubvec4 last_neg_z_color;
-    math::ubvec4 last_pos_z_color;
-
-    auto check_cube_face_color = [](math::vec4 normal, const cube& cube, math::ubvec4& check_color, size_t& iterations_counter) {
-        for (const auto& face : cube.faces) {
-            if (face.normal == normal) {
-                if (iterations_counter == 0) {
-                    check_color = face.color;
-                }
-                iterations_counter++;
-                return face.color == check_color;
-            }
-        }
-        return false;
-    };
-
-    for (auto& cube : m_cubes) {
-        auto pos = cube.get_position();
-
-        if (pos.x == min_pos) {
-            if (!check_cube_face_color({-1, 0, 0, 0}, cube, last_neg_x_color, neg_x_iters)) {
-                return false;
-            }
-        }
-
-        if (pos.x == max_pos) {
-            if (!check_cube_face_color({1, 0, 0, 0}, cube, last_pos_x_color, pos_x_iters)) {
-                return false;
-            }
-        }
-
-        if (pos.y == min_pos) {
-            if (!check_cube_face_color({0, -1, 0, 0}, cube, last_neg_y_color, neg_y_iters)) {
-                return false;
-            }
-        }
-
-        if (pos.y == max_pos) {
-            if (!check_cube_face_color({0, 1, 0, 0}, cube, last_pos_y_color, pos_y_iters)) {
-                return false;
-            }
-        }
-
-        if (pos.z == min_pos) {
-            if (!check_cube_face_color({0, 0, -1, 0}, cube, last_neg_z_color, neg_z_iters)) {
-                return false;
-            }
-        }
+    const auto row_cubes = std::min(m_cubes.size(), cubes_per_faces_row);
+    return {.width = 6 * row_cubes, .height = (m_cubes.size() + cubes_per_faces_row - 1) / cubes_per_faces_row, .length = 1};
+}
 
-        if (pos.z == min_pos) {
-            if (!check_cube_face_color({0, 0, 1, 0}, cube, last_pos_z_color, pos_z_iters)) {
-                return false;
-            }
-        }
-    }
 
-    return true;
+bool rubiks_cube::rubiks_cube::is_assembled() const
+{
+    return m_state.is_solved();
 }
@@ -5,6 +5,7 @@
 
 #include "cube.hpp"
 #include "rotation_manager.hpp"
+#include "cube_state.hpp"
 #include <ray.hpp>
 
 namespace rubiks_cube
@@ -30,6 +31,9 @@ namespace rubiks_cube
         rubiks_cube& operator=(rubiks_cube&&) = delete;
         ~rubiks_cube();
 
+        // compiles cubes shader into the program cache in background.
+        static void prewarm_shaders(renderer::renderer* renderer);
+
         void update(double delta_time);
         void draw();
         bool hit(math::ray ray, face& face, math::vec3& hit_point);
@@ -50,15 +54,29 @@ namespace rubiks_cube
         rotation_manager rotation_manager;
 
     private:
-        void get_faces_color_by_position(cube&, math::ivec3 pos);
-        void upload_cube_faces_texture_data();
+        void update_cube_colors(size_t cube_index);
+        void update_cube_faces_texture_data(size_t cube_index);
         void create_cubes_colors_texture();
+        renderer::texture_size get_faces_texture_size() const;
+
+        void collect_moving_cubes();
+
+        template<typename Func>
+        void for_each_cube_in_row(const rotation_manager::row_index&, Func&&) const;
+        void upload_changed_faces_rows();
+        size_t get_grid_index(math::ivec3 pos) const;
 
         std::vector<math::ubvec4> m_faces_texture_data;
 
         std::vector<cube> m_cubes;
+        std::vector<math::mat4> m_instances_data;
+
+        std::vector<rotation_manager::row_index> m_active_rows;
+        std::vector<uint32_t> m_moving_cubes;
+        std::vector<size_t> m_changed_faces_rows;
 
         renderer::shader_handler m_draw_shader;
+        renderer::instance_stream_handler m_instances;
         renderer::parameters_list_handler m_params_list;
         renderer::mesh_handler m_cube_mesh;
         renderer::texture_handler m_cubes_faces_texture;
@@ -66,10 +84,14 @@ namespace rubiks_cube
         renderer::renderer* m_renderer;
 
         math::mat4 m_transform;
+        math::mat4 m_world_to_model;
         math::vec3 m_rotation{0, 0, 0};
 
         size_t m_size;
 
+        // cubes only animate turns, colors come from the logical state. cube index is its grid index, x major.
+        cube_model::cube_state m_state;
+
         bool m_is_acquired = false;
     };
 } // namespace rubiks_cube
@@ -0,0 +1,432 @@
+
+
+#include "cubie_cube.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+    using namespace rubiks_cube;
+    using namespace rubiks_cube::solver;
+
+    using ivec3 = std::array<int32_t, 3>;
+
+    constexpr std::array<ivec3, cubie_cube::corners_count> corner_positions{{
+        {1, 1, 1},
+        {-1, 1, 1},
+        {-1, 1, -1},
+        {1, 1, -1},
+        {1, -1, 1},
+        {-1, -1, 1},
+        {-1, -1, -1},
+        {1, -1, -1},
+    }};
+
+    constexpr std::array<ivec3, cubie_cube::edges_count> edge_positions{{
+        {1, 1, 0},
+        {0, 1, 1},
+        {-1, 1, 0},
+        {0, 1, -1},
+        {1, -1, 0},
+        {0, -1, 1},
+        {-1, -1, 0},
+        {0, -1, -1},
+        {1, 0, 1},
+        {-1, 0, 1},
+        {-1, 0, -1},
+        {1, 0, -1},
+    }};
+
+
+    uint32_t get_facelet(ivec3 position, uint32_t normal_axis)
+    {
+        cube_model::detail::location l{};
+        for (uint32_t a = 0; a < 3; ++a) {
+            l.pos[a] = position[a] * 2;
+        }
+        l.normal[normal_axis] = position[normal_axis];
+        return cube_model::detail::get_facelet(3, l);
+    }
+
+
+    // facelets of corner position, u/d facelet first, then clockwise looking at the corner.
+    std::array<uint32_t, 3> get_corner_facelets(uint32_t corner)
+    {
+        const auto p = corner_positions[corner];
+        const auto clockwise = -p[0] * p[1] * p[2] > 0;
+
+        return clockwise
+                   ? std::array<uint32_t, 3>{get_facelet(p, cube_model::y), get_facelet(p, cube_model::x), get_facelet(p, cube_model::z)}
+                   : std::array<uint32_t, 3>{get_facelet(p, cube_model::y), get_facelet(p, cube_model::z), get_facelet(p, cube_model::x)};
+    }
+
+
+    // facelets of edge position, reference facelet (u/d, or f/b for e slice edges) first.
+    std::array<uint32_t, 2> get_edge_facelets(uint32_t edge)
+    {
+        const auto p = edge_positions[edge];
+
+        if (p[1] != 0) {
+            return {get_facelet(p, cube_model::y), get_facelet(p, p[0] != 0 ? cube_model::x : cube_model::z)};
+        }
+
+        return {get_facelet(p, cube_model::z), get_facelet(p, cube_model::x)};
+    }
+
+
+    // colors of solved cube are face indices, cubies are identified by set of their colors.
+    template<size_t Size>
+    uint32_t get_colors_mask(const std::array<uint8_t, Size>& colors)
+    {
+        uint32_t mask = 0;
+        for (auto c : colors) {
+            mask |= 1u << c;
+        }
+        return mask;
+    }
+
+
+    bool is_ud_color(uint8_t color)
+    {
+        return color == cube_model::pos_y || color == cube_model::neg_y;
+    }
+
+
+    constexpr uint32_t binomial(uint32_t n, uint32_t k)
+    {
+        if (k > n) {
+            return 0;
+        }
+
+        uint32_t res = 1;
+        for (uint32_t i = 1; i <= k; ++i) {
+            res = res * (n - k + i) / i;
+        }
+        return res;
+    }
+
+
+    template<typename T>
+    void rotate_left(T* arr, uint32_t left, uint32_t right)
+    {
+        std::rotate(arr + left, arr + left + 1, arr + right + 1);
+    }
+
+
+    template<typename T>
+    void rotate_right(T* arr, uint32_t left, uint32_t right)
+    {
+        std::rotate(arr + left, arr + right, arr + right + 1);
+    }
+
+
+    template<size_t Size>
+    uint16_t get_permutation_index(std::array<uint8_t, Size> perm, uint32_t count)
+    {
+        uint32_t res = 0;
+        for (uint32_t j = count - 1; j > 0; --j) {
+            uint32_t k = 0;
+            while (perm[j] != j) {
+                rotate_left(perm.data(), 0, j);
+                ++k;
+            }
+            res = (j + 1) * res + k;
+        }
+        return uint16_t(res);
+    }
+
+
+    template<size_t Size>
+    void set_permutation_index(std::array<uint8_t, Size>& perm, uint32_t count, uint32_t index)
+    {
+        for (uint32_t i = 0; i < count; ++i) {
+            perm[i] = uint8_t(i);
+        }
+
+        for (uint32_t j = 0; j < count; ++j) {
+            auto k = index % (j + 1);
+            index /= j + 1;
+            for (; k > 0; --k) {
+                rotate_right(perm.data(), 0, j);
+            }
+        }
+    }
+
+
+    template<size_t Size>
+    bool is_odd_permutation(const std::array<uint8_t, Size>& perm)
+    {
+        uint32_t inversions = 0;
+        for (uint32_t i = 0; i < Size; ++i) {
+            for (uint32_t j = i + 1; j < Size; ++j) {
+                inversions += perm[i] > perm[j] ? 1 : 0;
+            }
+        }
+        return inversions % 2 == 1;
+    }
+} // namespace
+
+
+std::optional<rubiks_cube::solver::cubie_cube> rubiks_cube::solver::cubie_cube::from_state(const cube_model::cube_state& state)
+{
+    if (state.get_size() != 3) {
+        return std::nullopt;
+    }
+
+    for (uint8_t f = 0; f < cube_model::faces_count; ++f) {
+        if (state.get_color(cube_model::face(f), 1, 1) != f) {
+            return std::nullopt;
+        }
+    }
+
+    cubie_cube res;
+    uint32_t found_corners = 0;
+    uint32_t found_edges = 0;
+
+    for (uint32_t i = 0; i < corners_count; ++i) {
+        const auto facelets = get_corner_facelets(i);
+        const std::array<uint8_t, 3> colors{state.get_color(facelets[0]), state.get_color(facelets[1]), state.get_color(facelets[2])};
+        const auto twist = std::find_if(colors.begin(), colors.end(), is_ud_color) - colors.begin();
+
+        for (uint32_t j = 0; j < corners_count; ++j) {
+            const auto home = get_corner_facelets(j);
+            const std::array<uint8_t, 3> home_colors{uint8_t(home[0] / 9), uint8_t(home[1] / 9), uint8_t(home[2] / 9)};
+
+            if (get_colors_mask(home_colors) == get_colors_mask(colors) && twist < 3) {
+                // colors have to go in the same cyclic order as on the home position.
+                if (colors[(twist + 1) % 3] != home_colors[1]) {
+                    return std::nullopt;
+                }
+
+                res.cp[i] = uint8_t(j);
+                res.co[i] = uint8_t(twist);
+                found_corners |= 1u << j;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < edges_count; ++i) {
+        const auto facelets = get_edge_facelets(i);
+        const std::array<uint8_t, 2> colors{state.get_color(facelets[0]), state.get_color(facelets[1])};
+
+        for (uint32_t j = 0; j < edges_count; ++j) {
+            const auto home = get_edge_facelets(j);
+            const std::array<uint8_t, 2> home_colors{uint8_t(home[0] / 9), uint8_t(home[1] / 9)};
+
+            if (get_colors_mask(home_colors) == get_colors_mask(colors)) {
+                // reference color is u/d color, or f/b color for e slice edges, it's the first one at home.
+                res.ep[i] = uint8_t(j);
+                res.eo[i] = colors[0] == home_colors[0] ? 0 : 1;
+                found_edges |= 1u << j;
+            }
+        }
+    }
+
+    if (found_corners != (1u << corners_count) - 1 || found_edges != (1u << edges_count) - 1) {
+        return std::nullopt;
+    }
+
+    return res;
+}
+
+
+rubiks_cube::solver::cubie_cube rubiks_cube::solver::cubie_cube::operator*(const cubie_cube& r) const
+{
+    cubie_cube res;
+
+    for (uint32_t i = 0; i < corners_count; ++i) {
+        res.cp[i] = cp[r.cp[i]];
+        res.co[i] = uint8_t((co[r.cp[i]] + r.co[i]) % 3);
+    }
+
+    for (uint32_t i = 0; i < edges_count; ++i) {
+        res.ep[i] = ep[r.ep[i]];
+        res.eo[i] = uint8_t((eo[r.ep[i]] + r.eo[i]) % 2);
+    }
+
+    return res;
+}
+
+
+bool rubiks_cube::solver::cubie_cube::is_solvable() const
+{
+    uint32_t twist = 0;
+    for (auto o : co) {
+        twist += o;
+    }
+
+    uint32_t flip = 0;
+    for (auto o : eo) {
+        flip += o;
+    }
+
+    return twist % 3 == 0 && flip % 2 == 0 && is_odd_permutation(cp) == is_odd_permutation(ep);
+}
+
+
+uint16_t rubiks_cube::solver::cubie_cube::get_twist() const
+{
+    uint32_t res = 0;
+    for (uint32_t i = 0; i < corners_count - 1; ++i) {
+        res = res * 3 + co[i];
+    }
+    return uint16_t(res);
+}
+
+
+void rubiks_cube::solver::cubie_cube::set_twist(uint16_t twist)
+{
+    uint32_t sum = 0;
+    for (int32_t i = corners_count - 2; i >= 0; --i) {
+        co[i] = uint8_t(twist % 3);
+        sum += co[i];
+        twist /= 3;
+    }
+    co[corners_count - 1] = uint8_t((3 - sum % 3) % 3);
+}
+
+
+uint16_t rubiks_cube::solver::cubie_cube::get_flip() const
+{
+    uint32_t res = 0;
+    for (uint32_t i = 0; i < edges_count - 1; ++i) {
+        res = res * 2 + eo[i];
+    }
+    return uint16_t(res);
+}
+
+
+void rubiks_cube::solver::cubie_cube::set_flip(uint16_t flip)
+{
+    uint32_t sum = 0;
+    for (int32_t i = edges_count - 2; i >= 0; --i) {
+        eo[i] = uint8_t(flip % 2);
+        sum += eo[i];
+        flip /= 2;
+    }
+    eo[edges_count - 1] = uint8_t(sum % 2);
+}
+
+
+uint16_t rubiks_cube::solver::cubie_cube::get_slice_sorted() const
+{
+    constexpr uint8_t first_slice_edge = 8;
+
+    uint32_t positions = 0;
+    uint32_t found = 0;
+    std::array<uint8_t, 4> slice_edges{};
+
+    for (int32_t j = edges_count - 1; j >= 0; --j) {
+        if (ep[j] >= first_slice_edge) {
+            positions += binomial(edges_count - 1 - j, found + 1);
+            slice_edges[3 - found] = ep[j];
+            ++found;
+        }
+    }
+
+    uint32_t order = 0;
+    for (uint32_t j = 3; j > 0; --j) {
+        uint32_t k = 0;
+        while (slice_edges[j] != j + first_slice_edge) {
+            rotate_left(slice_edges.data(), 0, j);
+            ++k;
+        }
+        order = (j + 1) * order + k;
+    }
+
+    return uint16_t(24 * positions + order);
+}
+
+
+void rubiks_cube::solver::cubie_cube::set_slice_sorted(uint16_t index)
+{
+    std::array<uint8_t, 4> slice_edges{8, 9, 10, 11};
+    std::array<uint8_t, 8> other_edges{0, 1, 2, 3, 4, 5, 6, 7};
+
+    auto order = uint32_t(index % 24);
+    auto positions = uint32_t(index / 24);
+
+    for (uint32_t j = 1; j < 4; ++j) {
+        auto k = order % (j + 1);
+        order /= j + 1;
+        for (; k > 0; --k) {
+            rotate_right(slice_edges.data(), 0, j);
+        }
+    }
+
+    ep.fill(uint8_t(-1));
+
+    uint32_t left = 4;
+    for (uint32_t j = 0; j < edges_count && left > 0; ++j) {
+        const auto c = binomial(edges_count - 1 - j, left);
+        if (positions >= c) {
+            ep[j] = slice_edges[4 - left];
+            positions -= c;
+            --left;
+        }
+    }
+
+    uint32_t next = 0;
+    for (auto& e : ep) {
+        if (e == uint8_t(-1)) {
+            e = other_edges[next++];
+        }
+    }
+}
+
+
+uint16_t rubiks_cube::solver::cubie_cube::get_corners() const
+{
+    return get_permutation_index(cp, corners_count);
+}
+
+
+void rubiks_cube::solver::cubie_cube::set_corners(uint16_t index)
+{
+    set_permutation_index(cp, corners_count, index);
+}
+
+
+uint16_t rubiks_cube::solver::cubie_cube::get_ud_edges() const
+{
+    return get_permutation_index(ep, 8);
+}
+
+
+void rubiks_cube::solver::cubie_cube::set_ud_edges(uint16_t index)
+{
+    set_permutation_index(ep, 8, index);
+    for (uint32_t i = 8; i < edges_count; ++i) {
+        ep[i] = uint8_t(i);
+    }
+}
+
+
+rubiks_cube::cube_model::move rubiks_cube::solver::get_model_move(uint32_t move)
+{
+    // u r f d l b, clockwise looking at the face is the negative rotation around its outer normal.
+    constexpr cube_model::axis faces_axes[]{cube_model::y, cube_model::x, cube_model::z, cube_model::y, cube_model::x, cube_model::z};
+
+    const auto face = move / 3;
+    const auto quarter_turns = int32_t(move % 3) + 1;
+    const auto is_positive_face = face < 3;
+
+    return {faces_axes[face], is_positive_face ? 2u : 0u, is_positive_face ? -quarter_turns : quarter_turns};
+}
+
+
+const rubiks_cube::solver::cubie_cube& rubiks_cube::solver::get_move_cube(uint32_t move)
+{
+    static const auto cubes = []() {
+        std::array<cubie_cube, moves_count> res;
+        for (uint32_t m = 0; m < moves_count; ++m) {
+            cube_model::cube_state state(3);
+            state.apply(get_model_move(m));
+            res[m] = *cubie_cube::from_state(state);
+        }
+        return res;
+    }();
+
+    return cubes[move];
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cube_state.hpp>
+
+#include <array>
+#include <cinttypes>
+#include <optional>
+
+namespace rubiks_cube::solver
+{
+    // 3x3 cube on the cubies level, u is +y, r is +x, f is +z.
+    // corners: urf, ufl, ulb, ubr, dfr, dlf, dbl, drb.
+    // edges: ur, uf, ul, ub, dr, df, dl, db, fr, fl, bl, br - the last four are e slice edges.
+    // cp[i] and ep[i] are cubies at position i, co and eo are their twists and flips.
+    struct cubie_cube
+    {
+        constexpr static uint32_t corners_count = 8;
+        constexpr static uint32_t edges_count = 12;
+
+        std::array<uint8_t, corners_count> cp{0, 1, 2, 3, 4, 5, 6, 7};
+        std::array<uint8_t, corners_count> co{};
+        std::array<uint8_t, edges_count> ep{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+        std::array<uint8_t, edges_count> eo{};
+
+        // state of 3x3 cube with centers at home, nullopt if colors don't form a valid cube.
+        static std::optional<cubie_cube> from_state(const cube_model::cube_state&);
+
+        // this cube followed by r.
+        cubie_cube operator*(const cubie_cube& r) const;
+        bool operator==(const cubie_cube&) const = default;
+
+        // reachable by moves: permutations parities match, twist and flip sums are 0.
+        bool is_solvable() const;
+
+        // kociemba coordinates.
+        uint16_t get_twist() const;
+        void set_twist(uint16_t);
+        uint16_t get_flip() const;
+        void set_flip(uint16_t);
+        // positions and order of e slice edges, slice_sorted / 24 is 0 in phase 2 subgroup.
+        uint16_t get_slice_sorted() const;
+        void set_slice_sorted(uint16_t);
+        uint16_t get_corners() const;
+        void set_corners(uint16_t);
+        // permutation of u and d layer edges, valid in phase 2 subgroup only.
+        uint16_t get_ud_edges() const;
+        void set_ud_edges(uint16_t);
+    };
+
+
+    // faces are u, r, f, d, l, b, moves are face * 3 + quarter turns clockwise - 1.
+    constexpr uint32_t moves_count = 18;
+
+    // cube model move of the face move.
+    cube_model::move get_model_move(uint32_t move);
+
+    // cubie cube of the single face move applied to solved cube.
+    const cubie_cube& get_move_cube(uint32_t move);
+} // namespace rubiks_cube::solver
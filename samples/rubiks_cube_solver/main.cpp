@@ -0,0 +1,181 @@
+#include "notation.hpp"
+#include "reduction_solver.hpp"
+#include "solver_tables.hpp"
+#include "two_phase_solver.hpp"
+
+#include <cube_state.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+    // face letters in cube_model::face order.
+    constexpr std::string_view faces_names = "RLUDFB";
+
+    void print_usage()
+    {
+        std::cout << "usage: rubiks_cube_solver [options] <scramble moves>\n"
+                     "       rubiks_cube_solver [options] --facelets <6 * size^2 face letters>\n"
+                     "       rubiks_cube_solver [options] --benchmark <solves count>\n"
+                     "facelets go face by face in " << faces_names << " order, rows and cols as in cube_model.\n"
+                     "options:\n"
+                     "  --size <n>           cube size, 3 or a bigger odd one (3)\n"
+                     "  --tables <path>      pruning tables file, generated if missing (rubiks_cube_solver.tables)\n"
+                     "  --threads <count>    search threads, 0 is hardware concurrency (0)\n"
+                     "  --max-length <n>     stop at the first solution of at most n moves (21)\n"
+                     "  --timeout <ms>       return the best solution found by then (10000)\n";
+    }
+
+
+    rubiks_cube::cube_model::cube_state parse_facelets(std::string_view facelets, size_t size)
+    {
+        std::vector<uint8_t> colors;
+        colors.reserve(facelets.size());
+
+        for (const auto c : facelets) {
+            const auto f = faces_names.find(c);
+            if (f == std::string_view::npos) {
+                throw std::runtime_error(std::string("unknown face ") + c + ".");
+            }
+            colors.emplace_back(uint8_t(f));
+        }
+
+        return rubiks_cube::cube_model::cube_state{size, colors};
+    }
+
+
+    // random moves of outer layers on 3x3 and of any layers on bigger cubes,
+    // not a uniformly random state, but far enough from solved one.
+    rubiks_cube::cube_model::cube_state make_scrambled_state(std::mt19937& engine, size_t size)
+    {
+        const auto scramble_length = uint32_t(size == 3 ? 40 : 20 * size);
+        rubiks_cube::cube_model::cube_state res{size};
+
+        std::uniform_int_distribution<uint32_t> axis(0, 2);
+        std::uniform_int_distribution<uint32_t> side(0, 1);
+        std::uniform_int_distribution<uint32_t> layer(0, uint32_t(size) - 1);
+        std::uniform_int_distribution<int32_t> turns(1, 3);
+
+        for (uint32_t i = 0; i < scramble_length; ++i) {
+            const auto a = rubiks_cube::cube_model::axis(axis(engine));
+            const auto l = size == 3 ? side(engine) * 2 : layer(engine);
+            res.apply(rubiks_cube::cube_model::move{a, l, turns(engine)});
+        }
+
+        return res;
+    }
+
+
+    int run_benchmark(const rubiks_cube::solver::reduction_solver& solver, const rubiks_cube::solver::solve_options& options, size_t size, uint32_t count)
+    {
+        std::mt19937 engine{42};
+        size_t moves_count = 0;
+        uint32_t failed_count = 0;
+
+        const auto begin = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto state = make_scrambled_state(engine, size);
+            const auto solution = solver.solve(state, options);
+
+            if (!solution) {
+                ++failed_count;
+                continue;
+            }
+
+            state.apply(*solution);
+            if (!state.is_solved()) {
+                std::cerr << "wrong solution " << rubiks_cube::solver::to_string(*solution, size) << std::endl;
+                return 1;
+            }
+
+            moves_count += solution->size();
+        }
+
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        const auto solved_count = count - failed_count;
+
+        std::cout << "solved " << solved_count << " of " << count << " in " << seconds << " s, "
+                  << double(count) / seconds << " solves/s, "
+                  << (solved_count > 0 ? double(moves_count) / solved_count : 0.) << " moves on average" << std::endl;
+
+        return failed_count == 0 ? 0 : 1;
+    }
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    std::string tables_path = "rubiks_cube_solver.tables";
+    std::string scramble;
+    std::string facelets;
+    uint32_t benchmark_count = 0;
+    size_t size = 3;
+    rubiks_cube::solver::solve_options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const auto has_value = i + 1 < argc;
+
+        if (std::strcmp(argv[i], "--tables") == 0 && has_value) {
+            tables_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            options.threads_count = uint32_t(std::stoul(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-length") == 0 && has_value) {
+            options.max_length = uint32_t(std::stoul(argv[++i]));
+        } else if (std::strcmp(argv[i], "--timeout") == 0 && has_value) {
+            options.timeout = std::chrono::milliseconds(std::stoul(argv[++i]));
+        } else if (std::strcmp(argv[i], "--size") == 0 && has_value) {
+            size = std::stoul(argv[++i]);
+        } else if (std::strcmp(argv[i], "--facelets") == 0 && has_value) {
+            facelets = argv[++i];
+        } else if (std::strcmp(argv[i], "--benchmark") == 0 && has_value) {
+            benchmark_count = uint32_t(std::stoul(argv[++i]));
+        } else if (argv[i][0] != '-') {
+            scramble += scramble.empty() ? "" : " ";
+            scramble += argv[i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (scramble.empty() && facelets.empty() && benchmark_count == 0) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        const auto tables_begin = std::chrono::steady_clock::now();
+        const auto tables = rubiks_cube::solver::tables::load_or_generate(tables_path);
+        const auto tables_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tables_begin).count();
+
+        const rubiks_cube::solver::two_phase_solver two_phase_solver{tables};
+        const rubiks_cube::solver::reduction_solver solver{two_phase_solver};
+
+        if (benchmark_count > 0) {
+            std::cout << "tables are ready in " << tables_seconds << " s" << std::endl;
+            return run_benchmark(solver, options, size, benchmark_count);
+        }
+
+        auto state = facelets.empty() ? rubiks_cube::cube_model::cube_state{size} : parse_facelets(facelets, size);
+        state.apply(rubiks_cube::solver::parse_moves(scramble, size));
+
+        const auto solution = solver.solve(state, options);
+
+        if (!solution) {
+            std::cerr << "no solution found in time" << std::endl;
+            return 1;
+        }
+
+        std::cout << rubiks_cube::solver::to_string(*solution, size) << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
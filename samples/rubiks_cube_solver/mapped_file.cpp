@@ -0,0 +1,114 @@
+
+
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+rubiks_cube::solver::mapped_file::mapped_file(const std::filesystem::path& path)
+{
+#if !defined(_WIN32)
+    const auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path.string() + ".");
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("cannot map " + path.string() + ".");
+    }
+
+    auto* data = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping keeps the file referenced.
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("cannot map " + path.string() + ".");
+    }
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = size_t(st.st_size);
+    m_mapped = true;
+#else
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if (!file) {
+        throw std::runtime_error("cannot open " + path.string() + ".");
+    }
+
+    m_storage.resize(size_t(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_storage.data()), std::streamsize(m_storage.size()));
+
+    if (!file) {
+        throw std::runtime_error("cannot read " + path.string() + ".");
+    }
+
+    m_data = m_storage.data();
+    m_size = m_storage.size();
+#endif
+}
+
+
+rubiks_cube::solver::mapped_file::mapped_file(std::vector<uint8_t> contents)
+    : m_storage(std::move(contents))
+{
+    m_data = m_storage.data();
+    m_size = m_storage.size();
+}
+
+
+rubiks_cube::solver::mapped_file::~mapped_file()
+{
+    reset();
+}
+
+
+rubiks_cube::solver::mapped_file::mapped_file(mapped_file&& src) noexcept
+{
+    *this = std::move(src);
+}
+
+
+rubiks_cube::solver::mapped_file& rubiks_cube::solver::mapped_file::operator=(mapped_file&& src) noexcept
+{
+    if (this != &src) {
+        reset();
+        m_data = std::exchange(src.m_data, nullptr);
+        m_size = std::exchange(src.m_size, 0);
+        m_mapped = std::exchange(src.m_mapped, false);
+        m_storage = std::move(src.m_storage);
+    }
+
+    return *this;
+}
+
+
+std::span<const uint8_t> rubiks_cube::solver::mapped_file::get_data() const
+{
+    return {m_data, m_size};
+}
+
+
+void rubiks_cube::solver::mapped_file::reset()
+{
+#if !defined(_WIN32)
+    if (m_mapped) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_storage.clear();
+}
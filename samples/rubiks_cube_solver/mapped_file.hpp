@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace rubiks_cube::solver
+{
+    // read only view of the whole file. memory mapped where mmap is available, read into memory elsewhere.
+    class mapped_file
+    {
+    public:
+        mapped_file() = default;
+        explicit mapped_file(const std::filesystem::path&);
+        // contents which could not be stored, served from memory.
+        explicit mapped_file(std::vector<uint8_t> contents);
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&&) noexcept;
+        mapped_file& operator=(mapped_file&&) noexcept;
+
+        std::span<const uint8_t> get_data() const;
+
+    private:
+        void reset();
+
+        const uint8_t* m_data{nullptr};
+        size_t m_size{0};
+        bool m_mapped{false};
+        std::vector<uint8_t> m_storage;
+    };
+} // namespace rubiks_cube::solver
@@ -0,0 +1,192 @@
+
+
+#include "notation.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace
+{
+    using namespace rubiks_cube;
+
+    // layers of the token, faces count depth from themselves.
+    enum class token_layers
+    {
+        negative_face,
+        middle,
+        positive_face,
+        all
+    };
+
+    // clockwise turn of the token, looking at its face, as quarter turns around the axis.
+    struct token
+    {
+        char name;
+        cube_model::axis axis;
+        token_layers layers;
+        int32_t turns;
+    };
+
+    constexpr token tokens[]{
+        {'R', cube_model::x, token_layers::positive_face, -1},
+        {'L', cube_model::x, token_layers::negative_face, 1},
+        {'M', cube_model::x, token_layers::middle, 1},
+        {'x', cube_model::x, token_layers::all, -1},
+        {'U', cube_model::y, token_layers::positive_face, -1},
+        {'D', cube_model::y, token_layers::negative_face, 1},
+        {'E', cube_model::y, token_layers::middle, 1},
+        {'y', cube_model::y, token_layers::all, -1},
+        {'F', cube_model::z, token_layers::positive_face, -1},
+        {'B', cube_model::z, token_layers::negative_face, 1},
+        {'S', cube_model::z, token_layers::middle, -1},
+        {'z', cube_model::z, token_layers::all, -1},
+    };
+
+
+    void append_token(std::string& str, const token& t, uint32_t depth, int32_t turns)
+    {
+        const auto quarter_turns = (turns * t.turns % 4 + 4) % 4;
+        if (quarter_turns == 0) {
+            return;
+        }
+
+        if (!str.empty()) {
+            str += ' ';
+        }
+
+        if (depth > 1) {
+            str += std::to_string(depth);
+        }
+
+        str += t.name;
+
+        if (quarter_turns == 2) {
+            str += '2';
+        } else if (quarter_turns == 3) {
+            str += '\'';
+        }
+    }
+} // namespace
+
+
+std::vector<rubiks_cube::cube_model::move> rubiks_cube::solver::parse_moves(std::string_view str, size_t size)
+{
+    std::vector<cube_model::move> res;
+
+    size_t pos = 0;
+    while (pos < str.size()) {
+        if (str[pos] == ' ') {
+            ++pos;
+            continue;
+        }
+
+        const auto end = std::min(str.find(' ', pos), str.size());
+        auto name = str.substr(pos, end - pos);
+        pos = end;
+
+        const auto full_name = std::string(name);
+
+        uint32_t depth = 0;
+        while (!name.empty() && name[0] >= '0' && name[0] <= '9') {
+            depth = depth * 10 + uint32_t(name[0] - '0');
+            name.remove_prefix(1);
+        }
+
+        const token* t = nullptr;
+        for (const auto& candidate : tokens) {
+            if (!name.empty() && candidate.name == name[0]) {
+                t = &candidate;
+            }
+        }
+
+        int32_t quarter_turns = 1;
+        if (name.size() == 2 && name[1] == '2') {
+            quarter_turns = 2;
+        } else if (name.size() == 2 && name[1] == '\'') {
+            quarter_turns = -1;
+        } else if (name.size() != 1) {
+            t = nullptr;
+        }
+
+        // depth is given for faces only, it has to stay inside of the cube. middle layer exists on odd cubes.
+        if (t != nullptr && full_name.size() != name.size()) {
+            const auto is_face = t->layers == token_layers::positive_face || t->layers == token_layers::negative_face;
+            if (!is_face || depth == 0 || depth > size) {
+                t = nullptr;
+            }
+        }
+
+        if (t != nullptr && t->layers == token_layers::middle && size % 2 == 0) {
+            t = nullptr;
+        }
+
+        if (t == nullptr) {
+            throw std::runtime_error("unknown move " + full_name + ".");
+        }
+
+        depth = std::max(depth, 1u);
+
+        switch (t->layers) {
+            case token_layers::negative_face:
+                res.emplace_back(cube_model::move{t->axis, depth - 1, t->turns * quarter_turns});
+                break;
+            case token_layers::middle:
+                res.emplace_back(cube_model::move{t->axis, uint32_t(size / 2), t->turns * quarter_turns});
+                break;
+            case token_layers::positive_face:
+                res.emplace_back(cube_model::move{t->axis, uint32_t(size) - depth, t->turns * quarter_turns});
+                break;
+            case token_layers::all:
+                for (uint32_t layer = 0; layer < size; ++layer) {
+                    res.emplace_back(cube_model::move{t->axis, layer, t->turns * quarter_turns});
+                }
+                break;
+        }
+    }
+
+    return res;
+}
+
+
+std::string rubiks_cube::solver::to_string(std::span<const cube_model::move> moves, size_t size)
+{
+    std::string res;
+
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const auto& m = moves[i];
+
+        auto is_rotation = i + size <= moves.size();
+        for (uint32_t layer = 0; layer < size && is_rotation; ++layer) {
+            const auto& next = moves[i + layer];
+            is_rotation = next.axis == m.axis && next.layer == layer && next.turns == m.turns;
+        }
+
+        auto layers = token_layers::all;
+        uint32_t depth = 1;
+
+        if (!is_rotation) {
+            if (size % 2 == 1 && m.layer == size / 2) {
+                layers = token_layers::middle;
+            } else if (m.layer < size / 2) {
+                layers = token_layers::negative_face;
+                depth = m.layer + 1;
+            } else {
+                layers = token_layers::positive_face;
+                depth = uint32_t(size) - m.layer;
+            }
+        }
+
+        for (const auto& t : tokens) {
+            if (t.axis == m.axis && t.layers == layers) {
+                append_token(res, t, depth, m.turns);
+            }
+        }
+
+        if (is_rotation) {
+            i += size - 1;
+        }
+    }
+
+    return res;
+}
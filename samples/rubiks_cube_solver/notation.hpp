@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cube_state.hpp>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rubiks_cube::solver
+{
+    // singmaster notation: faces u r f d l b, slices m e s, rotations x y z,
+    // suffixes ' and 2, tokens are separated by spaces. throws on unknown tokens.
+    // on bigger cubes a face may have depth of the single layer it turns, 3r is the third layer from r.
+    // m e s are the middle layers of odd cubes.
+    std::vector<cube_model::move> parse_moves(std::string_view, size_t size = 3);
+
+    // turns of all layers of an axis in a row are written as a rotation.
+    std::string to_string(std::span<const cube_model::move>, size_t size = 3);
+} // namespace rubiks_cube::solver
@@ -0,0 +1,651 @@
+
+
+#include "reduction_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <set>
+#include <span>
+#include <stdexcept>
+
+
+namespace
+{
+    using namespace rubiks_cube;
+    using namespace rubiks_cube::solver;
+
+    using cube_model::move;
+    using move_sequence = std::vector<move>;
+
+    constexpr uint32_t npos = uint32_t(-1);
+
+
+    move inverse(const move& m)
+    {
+        return {m.axis, m.layer, -m.turns};
+    }
+
+
+    // turns of the same layer in a row are merged into one move.
+    void append_move(move_sequence& moves, move m)
+    {
+        if (!moves.empty() && moves.back().axis == m.axis && moves.back().layer == m.layer) {
+            m.turns += moves.back().turns;
+            moves.pop_back();
+        }
+
+        const auto turns = (m.turns % 4 + 4) % 4;
+        if (turns != 0) {
+            moves.emplace_back(move{m.axis, m.layer, turns == 3 ? -1 : turns});
+        }
+    }
+
+
+    // where facelets go under layer turns. permutations of layers are built on first use.
+    class facelet_moves
+    {
+    public:
+        explicit facelet_moves(size_t size)
+            : m_size(size)
+            , m_tables(cube_model::get_move_tables(size))
+            , m_permutations(3 * size * 3)
+        {
+        }
+
+
+        uint32_t apply(uint32_t facelet, const move& m)
+        {
+            const auto turns = uint32_t(m.turns % 4 + 4) % 4;
+            return turns == 0 ? facelet : get_permutation(m.axis, m.layer, turns)[facelet];
+        }
+
+
+        uint32_t apply(uint32_t facelet, std::span<const move> moves)
+        {
+            for (const auto& m : moves) {
+                facelet = apply(facelet, m);
+            }
+            return facelet;
+        }
+
+
+        // facelet which apply(facelet, moves) brings to the given one.
+        uint32_t apply_inverse(uint32_t facelet, std::span<const move> moves)
+        {
+            for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+                facelet = apply(facelet, inverse(*it));
+            }
+            return facelet;
+        }
+
+
+        // every facelet which turns of the layer move.
+        void get_layer_facelets(cube_model::axis a, uint32_t layer, std::vector<uint32_t>& res) const
+        {
+            const auto index = a * m_size + layer;
+            for (auto i = m_tables.offsets[index]; i < m_tables.offsets[index + 1]; ++i) {
+                res.insert(res.end(), m_tables.cycles[i].begin(), m_tables.cycles[i].end());
+            }
+        }
+
+    private:
+        const std::vector<uint32_t>& get_permutation(cube_model::axis a, uint32_t layer, uint32_t turns)
+        {
+            const auto index = a * m_size + layer;
+            auto& res = m_permutations[index * 3 + turns - 1];
+
+            if (res.empty()) {
+                res.resize(cube_model::faces_count * m_size * m_size);
+                std::iota(res.begin(), res.end(), 0u);
+
+                for (auto i = m_tables.offsets[index]; i < m_tables.offsets[index + 1]; ++i) {
+                    const auto& c = m_tables.cycles[i];
+                    for (uint32_t k = 0; k < 4; ++k) {
+                        res[c[k]] = c[(k + turns) % 4];
+                    }
+                }
+            }
+
+            return res;
+        }
+
+        size_t m_size;
+        cube_model::move_tables_view m_tables;
+        std::vector<std::vector<uint32_t>> m_permutations;
+    };
+
+
+    uint32_t get_layer(size_t size, int32_t position)
+    {
+        return uint32_t((position + int32_t(size) - 1) / 2);
+    }
+
+
+    bool is_boundary(size_t size, int32_t position)
+    {
+        return position == int32_t(size) - 1 || position == 1 - int32_t(size);
+    }
+
+
+    // corners, middle edges and central centers, they move as 3x3 cube under turns of outer layers and of the middle one.
+    bool is_in_subcube(size_t size, uint32_t facelet)
+    {
+        const auto l = cube_model::detail::get_location(size, facelet);
+        return std::all_of(l.pos.begin(), l.pos.end(), [size](int32_t p) {
+            return p == 0 || is_boundary(size, p);
+        });
+    }
+
+
+    // axes along the face of the facelet where its position isn't on the face border, one for edges, two for centers.
+    std::vector<uint32_t> get_inner_axes(size_t size, const cube_model::detail::location& l)
+    {
+        std::vector<uint32_t> res;
+        for (uint32_t a = 0; a < 3; ++a) {
+            if (l.normal[a] == 0 && !is_boundary(size, l.pos[a])) {
+                res.emplace_back(a);
+            }
+        }
+        return res;
+    }
+
+
+    // color every facelet must have when the cube is reduced: centers match the central center of their face,
+    // wings match the middle edge they belong to. middle edges and central centers aren't moved till 3x3 stage.
+    std::vector<uint8_t> get_targets(const cube_model::cube_state& state)
+    {
+        const auto size = state.get_size();
+        std::vector<uint8_t> res(state.get_facelets_count());
+
+        for (uint32_t facelet = 0; facelet < res.size(); ++facelet) {
+            auto l = cube_model::detail::get_location(size, facelet);
+            for (const auto a : get_inner_axes(size, l)) {
+                l.pos[a] = 0;
+            }
+            res[facelet] = state.get_color(cube_model::detail::get_facelet(size, l));
+        }
+
+        return res;
+    }
+
+
+    // one facelet for centers, two for wings.
+    struct piece
+    {
+        std::array<uint32_t, 2> facelets;
+        uint32_t facelets_count;
+    };
+
+
+    // positions one piece reaches by turns.
+    struct orbit
+    {
+        std::vector<piece> pieces;
+        bool is_wings;
+    };
+
+
+    // other facelet of the wing, it lies on the face where this one touches the border.
+    uint32_t get_wing_partner(size_t size, uint32_t facelet)
+    {
+        auto l = cube_model::detail::get_location(size, facelet);
+
+        uint32_t border_axis = 0;
+        while (l.normal[border_axis] != 0 || !is_boundary(size, l.pos[border_axis])) {
+            ++border_axis;
+        }
+
+        l.normal = {};
+        l.normal[border_axis] = l.pos[border_axis] > 0 ? 1 : -1;
+        return cube_model::detail::get_facelet(size, l);
+    }
+
+
+    std::vector<orbit> get_orbits(facelet_moves& moves, size_t size)
+    {
+        const auto facelets_count = uint32_t(cube_model::faces_count * size * size);
+
+        std::vector<orbit> res;
+        std::vector<bool> visited(facelets_count);
+        std::vector<uint32_t> facelets;
+
+        for (uint32_t first = 0; first < facelets_count; ++first) {
+            if (visited[first] || is_in_subcube(size, first)) {
+                continue;
+            }
+
+            // quarter turns of the three layers of a facelet are enough to reach the whole orbit.
+            facelets.assign(1, first);
+            visited[first] = true;
+
+            for (size_t i = 0; i < facelets.size(); ++i) {
+                const auto l = cube_model::detail::get_location(size, facelets[i]);
+                for (uint32_t a = 0; a < 3; ++a) {
+                    const auto next = moves.apply(facelets[i], move{cube_model::axis(a), get_layer(size, l.pos[a]), 1});
+                    if (!visited[next]) {
+                        visited[next] = true;
+                        facelets.emplace_back(next);
+                    }
+                }
+            }
+
+            std::sort(facelets.begin(), facelets.end());
+
+            auto& o = res.emplace_back();
+            o.is_wings = get_inner_axes(size, cube_model::detail::get_location(size, first)).size() == 1;
+
+            // wings can't flip in place, so their other facelets make an orbit of their own, it is the same pieces.
+            for (const auto facelet : facelets) {
+                if (o.is_wings) {
+                    const auto other = get_wing_partner(size, facelet);
+                    visited[other] = true;
+                    o.pieces.emplace_back(piece{{facelet, other}, 2});
+                } else {
+                    o.pieces.emplace_back(piece{{facelet, npos}, 1});
+                }
+            }
+        }
+
+        return res;
+    }
+
+
+    // pieces of an orbit are put in place one by one. every step is a commutator which cycles three pieces
+    // of the orbit only, conjugated by setup moves. it brings a fitting piece into the next position
+    // and moves nothing but pieces which aren't placed yet.
+    class orbit_solver
+    {
+    public:
+        orbit_solver(facelet_moves& moves, const std::vector<uint8_t>& targets, const orbit& o, size_t size)
+            : m_moves(moves)
+            , m_targets(targets)
+            , m_orbit(o)
+            , m_size(size)
+            , m_piece_of(targets.size(), npos)
+            , m_sources(targets.size())
+            , m_marks(targets.size(), 0)
+        {
+            for (uint32_t i = 0; i < o.pieces.size(); ++i) {
+                for (uint32_t j = 0; j < o.pieces[i].facelets_count; ++j) {
+                    m_piece_of[o.pieces[i].facelets[j]] = i;
+                }
+            }
+
+            make_algorithms();
+            make_setups();
+        }
+
+
+        // false if some piece can't be placed, the state is left partially solved then.
+        bool solve(cube_model::cube_state& state, move_sequence& solution)
+        {
+            std::vector<bool> placed(m_orbit.pieces.size());
+
+            for (uint32_t i = 0; i < m_orbit.pieces.size(); ++i) {
+                if (!is_in_place(state, m_orbit.pieces[i]) && !place(state, solution, i, placed)) {
+                    return false;
+                }
+                placed[i] = true;
+            }
+
+            return true;
+        }
+
+    private:
+        struct algorithm
+        {
+            move_sequence moves;
+            // moved facelets and their destinations.
+            std::vector<std::pair<uint32_t, uint32_t>> mapping;
+        };
+
+
+        bool is_in_place(const cube_model::cube_state& state, const piece& p) const
+        {
+            for (uint32_t j = 0; j < p.facelets_count; ++j) {
+                if (state.get_color(p.facelets[j]) != m_targets[p.facelets[j]]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+
+        // inner layers which hold pieces of the orbit. the middle one moves the subcube, but commutators
+        // of it are kept only if they are pure, the orbits which cross it have no other way to meet.
+        std::vector<move> get_slices() const
+        {
+            std::set<std::pair<uint32_t, uint32_t>> layers;
+
+            for (const auto& p : m_orbit.pieces) {
+                const auto l = cube_model::detail::get_location(m_size, p.facelets[0]);
+                for (uint32_t a = 0; a < 3; ++a) {
+                    const auto layer = get_layer(m_size, l.pos[a]);
+                    if (layer != 0 && layer + 1 != m_size) {
+                        layers.emplace(a, layer);
+                    }
+                }
+            }
+
+            std::vector<move> res;
+            for (const auto& [a, layer] : layers) {
+                res.emplace_back(move{cube_model::axis(a), layer, 1});
+                res.emplace_back(move{cube_model::axis(a), layer, -1});
+            }
+            return res;
+        }
+
+
+        std::vector<move> get_face_turns() const
+        {
+            std::vector<move> res;
+            for (uint32_t a = 0; a < 3; ++a) {
+                for (const auto layer : {uint32_t(0), uint32_t(m_size - 1)}) {
+                    res.emplace_back(move{cube_model::axis(a), layer, 1});
+                    res.emplace_back(move{cube_model::axis(a), layer, -1});
+                }
+            }
+            return res;
+        }
+
+
+        // centers: [slice, face slice face'] with parallel slices, the conjugated slice crosses the first one
+        // at a single center. wings: [face face face', slice], the conjugated face touches the slice at a single wing.
+        void make_algorithms()
+        {
+            const auto slices = get_slices();
+            const auto faces = get_face_turns();
+            const auto moved_count = m_orbit.is_wings ? 6u : 3u;
+
+            for (const auto& s : slices) {
+                for (const auto& f : faces) {
+                    if (m_orbit.is_wings) {
+                        for (const auto& g : faces) {
+                            if (g.axis != f.axis) {
+                                add_commutator({f, g, inverse(f)}, {s}, moved_count);
+                            }
+                        }
+                        continue;
+                    }
+
+                    if (f.axis == s.axis) {
+                        continue;
+                    }
+
+                    for (const auto& other : slices) {
+                        if (other.axis == s.axis) {
+                            add_commutator({s}, {f, other, inverse(f)}, moved_count);
+                        }
+                    }
+                }
+            }
+        }
+
+
+        // both a b a' b' and its inverse b a b' a' are kept if the commutator moves exactly moved_count facelets.
+        void add_commutator(const move_sequence& a, const move_sequence& b, size_t moved_count)
+        {
+            for (const auto is_inverse : {false, true}) {
+                const auto& first = is_inverse ? b : a;
+                const auto& second = is_inverse ? a : b;
+
+                algorithm alg;
+                for (const auto& m : first) {
+                    append_move(alg.moves, m);
+                }
+                for (const auto& m : second) {
+                    append_move(alg.moves, m);
+                }
+                for (auto it = first.rbegin(); it != first.rend(); ++it) {
+                    append_move(alg.moves, inverse(*it));
+                }
+                for (auto it = second.rbegin(); it != second.rend(); ++it) {
+                    append_move(alg.moves, inverse(*it));
+                }
+
+                // facelets out of the turned layers stay in place.
+                ++m_mark;
+                m_candidates.clear();
+                for (const auto& m : alg.moves) {
+                    m_moves.get_layer_facelets(m.axis, m.layer, m_candidates);
+                }
+
+                bool is_pure = true;
+                for (const auto facelet : m_candidates) {
+                    if (m_marks[facelet] == m_mark) {
+                        continue;
+                    }
+                    m_marks[facelet] = m_mark;
+
+                    const auto to = m_moves.apply(facelet, alg.moves);
+                    if (to == facelet) {
+                        continue;
+                    }
+
+                    if (m_piece_of[facelet] == npos || alg.mapping.size() == moved_count) {
+                        is_pure = false;
+                        break;
+                    }
+                    alg.mapping.emplace_back(facelet, to);
+                }
+
+                if (!is_pure || alg.mapping.size() != moved_count) {
+                    continue;
+                }
+
+                std::sort(alg.mapping.begin(), alg.mapping.end());
+                if (!m_known_mappings.emplace(alg.mapping).second) {
+                    continue;
+                }
+
+                for (const auto& [from, to] : alg.mapping) {
+                    m_sources[to].emplace_back(uint32_t(m_algorithms.size()), from);
+                }
+                m_algorithms.emplace_back(std::move(alg));
+            }
+        }
+
+
+        // no setup, then single turns of every layer.
+        void make_setups()
+        {
+            m_setups.emplace_back();
+            for (uint32_t a = 0; a < 3; ++a) {
+                for (uint32_t layer = 0; layer < m_size; ++layer) {
+                    for (const auto turns : {1, 2, -1}) {
+                        m_setups.push_back({move{cube_model::axis(a), layer, turns}});
+                    }
+                }
+            }
+        }
+
+
+        bool place(cube_model::cube_state& state, move_sequence& solution, uint32_t index, const std::vector<bool>& placed)
+        {
+            for (const auto& setup : m_setups) {
+                if (try_place(state, solution, index, placed, setup)) {
+                    return true;
+                }
+            }
+
+            // rare positions near the end of the orbit need two setup turns.
+            for (size_t i = 1; i < m_setups.size(); ++i) {
+                for (size_t j = 1; j < m_setups.size(); ++j) {
+                    if (m_setups[i][0].axis == m_setups[j][0].axis && m_setups[i][0].layer == m_setups[j][0].layer) {
+                        continue;
+                    }
+                    if (try_place(state, solution, index, placed, {m_setups[i][0], m_setups[j][0]})) {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+
+        // setup, algorithm, setup undone. algorithm cycles the pieces which setup brings into its positions.
+        bool try_place(cube_model::cube_state& state, move_sequence& solution, uint32_t index, const std::vector<bool>& placed, const move_sequence& setup)
+        {
+            const auto& p = m_orbit.pieces[index];
+
+            for (const auto& [alg_index, source] : m_sources[m_moves.apply(p.facelets[0], setup)]) {
+                const auto& alg = m_algorithms[alg_index];
+
+                const auto is_movable = std::all_of(alg.mapping.begin(), alg.mapping.end(), [&](const auto& m) {
+                    return !placed[m_piece_of[m_moves.apply_inverse(m.first, setup)]];
+                });
+
+                if (!is_movable) {
+                    continue;
+                }
+
+                bool is_fitting = true;
+                for (uint32_t j = 0; j < p.facelets_count && is_fitting; ++j) {
+                    const auto to = m_moves.apply(p.facelets[j], setup);
+                    const auto m = std::find_if(alg.mapping.begin(), alg.mapping.end(), [to](const auto& m) {
+                        return m.second == to;
+                    });
+                    const auto from = m_moves.apply_inverse(m->first, setup);
+                    is_fitting = state.get_color(from) == m_targets[p.facelets[j]];
+                }
+
+                if (!is_fitting) {
+                    continue;
+                }
+
+                for (const auto& m : setup) {
+                    append(state, solution, m);
+                }
+                for (const auto& m : alg.moves) {
+                    append(state, solution, m);
+                }
+                for (auto it = setup.rbegin(); it != setup.rend(); ++it) {
+                    append(state, solution, inverse(*it));
+                }
+
+                return true;
+            }
+
+            return false;
+        }
+
+
+        static void append(cube_model::cube_state& state, move_sequence& solution, const move& m)
+        {
+            state.apply(m);
+            append_move(solution, m);
+        }
+
+        facelet_moves& m_moves;
+        const std::vector<uint8_t>& m_targets;
+        const orbit& m_orbit;
+        size_t m_size;
+
+        // per facelet.
+        std::vector<uint32_t> m_piece_of;
+        // algorithms which bring a facelet into the position, and the facelet.
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> m_sources;
+
+        std::vector<algorithm> m_algorithms;
+        std::set<std::vector<std::pair<uint32_t, uint32_t>>> m_known_mappings;
+        std::vector<move_sequence> m_setups;
+
+        std::vector<uint32_t> m_marks;
+        uint32_t m_mark{0};
+        std::vector<uint32_t> m_candidates;
+    };
+} // namespace
+
+
+rubiks_cube::solver::reduction_solver::reduction_solver(const two_phase_solver& solver)
+    : m_solver(solver)
+{
+}
+
+
+std::optional<std::vector<rubiks_cube::cube_model::move>> rubiks_cube::solver::reduction_solver::solve(
+    const cube_model::cube_state& state, const solve_options& options) const
+{
+    const auto size = state.get_size();
+
+    if (size == 3) {
+        return m_solver.solve(state, options);
+    }
+
+    if (size % 2 == 0) {
+        throw std::runtime_error("only odd cubes are supported by the solver.");
+    }
+
+    auto cube = state;
+    move_sequence res;
+
+    facelet_moves moves{size};
+    const auto targets = get_targets(cube);
+    auto orbits = get_orbits(moves, size);
+
+    // wings go first: fix of their parity turns an inner slice, which scrambles centers.
+    std::stable_partition(orbits.begin(), orbits.end(), [](const orbit& o) {
+        return o.is_wings;
+    });
+
+    for (const auto& o : orbits) {
+        orbit_solver solver{moves, targets, o, size};
+
+        if (solver.solve(cube, res)) {
+            continue;
+        }
+
+        // two wings are left swapped. quarter turn of an inner slice is a 4-cycle of the orbit's wings,
+        // the orbit becomes an even permutation, which 3-cycles solve.
+        if (o.is_wings) {
+            const auto l = cube_model::detail::get_location(size, o.pieces[0].facelets[0]);
+            const auto a = get_inner_axes(size, l)[0];
+            const move parity_fix{cube_model::axis(a), get_layer(size, l.pos[a]), 1};
+
+            cube.apply(parity_fix);
+            append_move(res, parity_fix);
+
+            if (solver.solve(cube, res)) {
+                continue;
+            }
+        }
+
+        throw std::runtime_error("invalid cube state.");
+    }
+
+    // reduced cube turns as its subcube when inner layers turn together.
+    const auto middle = uint32_t(size / 2);
+    const std::array<uint32_t, 3> subcube_lines{0, middle, uint32_t(size - 1)};
+
+    std::vector<uint8_t> colors;
+    colors.reserve(cube_model::faces_count * 9);
+
+    for (uint32_t f = 0; f < cube_model::faces_count; ++f) {
+        for (const auto row : subcube_lines) {
+            for (const auto col : subcube_lines) {
+                colors.emplace_back(cube.get_color(cube_model::face(f), row, col));
+            }
+        }
+    }
+
+    const auto subcube_solution = m_solver.solve(cube_model::cube_state{3, colors}, options);
+
+    if (!subcube_solution) {
+        return std::nullopt;
+    }
+
+    for (const auto& m : *subcube_solution) {
+        if (m.layer != 1) {
+            append_move(res, move{m.axis, m.layer == 0 ? 0 : uint32_t(size - 1), m.turns});
+            continue;
+        }
+
+        for (uint32_t layer = 1; layer + 1 < size; ++layer) {
+            append_move(res, move{m.axis, layer, m.turns});
+        }
+    }
+
+    return res;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cube_state.hpp>
+#include <two_phase_solver.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace rubiks_cube::solver
+{
+    // odd cubes larger than 3x3 are reduced to 3x3: edge wings are paired with middle edges and inner centers
+    // are solved by commutators which move nothing else, then the middle 3x3 subcube is solved by two phase solver,
+    // inner layers turn together as its middle slice. only the last stage is searched, solutions are long.
+    class reduction_solver
+    {
+    public:
+        explicit reduction_solver(const two_phase_solver&);
+
+        // same as two_phase_solver::solve, 3x3 cubes are passed to it as is. throws for even sizes and invalid states.
+        std::optional<std::vector<cube_model::move>> solve(const cube_model::cube_state&, const solve_options& = {}) const;
+
+    private:
+        const two_phase_solver& m_solver;
+    };
+} // namespace rubiks_cube::solver
@@ -0,0 +1,283 @@
+
+
+#include "solver_tables.hpp"
+
+#include <cubie_cube.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+
+namespace
+{
+    using namespace rubiks_cube::solver;
+
+    constexpr uint32_t tables_file_magic = 0x524b4354; // "TCKR"
+    constexpr uint32_t tables_file_version = 1;
+
+    struct tables_file_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t size;
+    };
+
+    enum section
+    {
+        twist_move_section,
+        flip_move_section,
+        slice_sorted_move_section,
+        corners_move_section,
+        ud_edges_move_section,
+        twist_slice_prune_section,
+        flip_slice_prune_section,
+        corners_slice_prune_section,
+        ud_edges_slice_prune_section,
+        sections_count
+    };
+
+    constexpr std::array<size_t, sections_count> sections_sizes{
+        twists_count * moves_count * sizeof(uint16_t),
+        flips_count * moves_count * sizeof(uint16_t),
+        slices_sorted_count * moves_count * sizeof(uint16_t),
+        corners_count * moves_count * sizeof(uint16_t),
+        ud_edges_count * moves_count * sizeof(uint16_t),
+        twists_count * slices_count,
+        flips_count * slices_count,
+        corners_count * slice_permutations_count,
+        ud_edges_count * slice_permutations_count};
+
+    constexpr auto sections_offsets = []() {
+        std::array<size_t, sections_count + 1> res{};
+        res[0] = sizeof(tables_file_header);
+        for (size_t i = 0; i < sections_count; ++i) {
+            res[i + 1] = (res[i] + sections_sizes[i] + 7) / 8 * 8;
+        }
+        return res;
+    }();
+
+    constexpr auto file_size = sections_offsets[sections_count];
+
+
+    template<typename T>
+    T* get_section(uint8_t* data, section s)
+    {
+        return reinterpret_cast<T*>(data + sections_offsets[s]);
+    }
+
+
+    template<typename T>
+    const T* get_section(const uint8_t* data, section s)
+    {
+        return reinterpret_cast<const T*>(data + sections_offsets[s]);
+    }
+
+
+    // coord_getter(cube) of cube with set coord followed by each move.
+    template<typename Setter, typename Getter>
+    void fill_move_table(uint16_t* table, uint32_t coords_count, Setter&& set, Getter&& get, bool phase2_only = false)
+    {
+        for (uint32_t coord = 0; coord < coords_count; ++coord) {
+            cubie_cube cube;
+            set(cube, uint16_t(coord));
+
+            for (uint32_t m = 0; m < moves_count; ++m) {
+                table[coord * moves_count + m] = !phase2_only || is_phase2_move(m) ? get(cube * get_move_cube(m)) : 0;
+            }
+        }
+    }
+
+
+    // breadth first, depth by depth, from the solved coords pair at index 0.
+    template<typename Next>
+    void fill_pruning_table(uint8_t* table, uint32_t size, bool phase2, Next&& next)
+    {
+        constexpr uint8_t unknown = 0xff;
+        std::fill(table, table + size, unknown);
+        table[0] = 0;
+
+        uint32_t found = 1;
+
+        for (uint8_t depth = 0; found < size && depth < unknown - 1; ++depth) {
+            const auto found_before = found;
+
+            for (uint32_t i = 0; i < size; ++i) {
+                if (table[i] != depth) {
+                    continue;
+                }
+
+                for (uint32_t m = 0; m < moves_count; ++m) {
+                    if (phase2 && !is_phase2_move(m)) {
+                        continue;
+                    }
+
+                    const auto n = next(i, m);
+                    if (table[n] == unknown) {
+                        table[n] = depth + 1;
+                        ++found;
+                    }
+                }
+            }
+
+            if (found == found_before) {
+                break;
+            }
+        }
+    }
+
+
+    std::vector<uint8_t> generate()
+    {
+        std::vector<uint8_t> res(file_size);
+        auto* data = res.data();
+
+        const tables_file_header header{.magic = tables_file_magic, .version = tables_file_version, .size = file_size};
+        std::copy_n(reinterpret_cast<const uint8_t*>(&header), sizeof(header), data);
+
+        auto* twist_move = get_section<uint16_t>(data, twist_move_section);
+        auto* flip_move = get_section<uint16_t>(data, flip_move_section);
+        auto* slice_sorted_move = get_section<uint16_t>(data, slice_sorted_move_section);
+        auto* corners_move = get_section<uint16_t>(data, corners_move_section);
+        auto* ud_edges_move = get_section<uint16_t>(data, ud_edges_move_section);
+
+        // tables are independent, large ones are built aside.
+        std::thread corners_thread([corners_move, ud_edges_move]() {
+            fill_move_table(
+                corners_move, corners_count, [](cubie_cube& c, uint16_t v) { c.set_corners(v); }, [](const cubie_cube& c) { return c.get_corners(); });
+            fill_move_table(
+                ud_edges_move, ud_edges_count, [](cubie_cube& c, uint16_t v) { c.set_ud_edges(v); }, [](const cubie_cube& c) { return c.get_ud_edges(); }, true);
+        });
+
+        fill_move_table(
+            twist_move, twists_count, [](cubie_cube& c, uint16_t v) { c.set_twist(v); }, [](const cubie_cube& c) { return c.get_twist(); });
+        fill_move_table(
+            flip_move, flips_count, [](cubie_cube& c, uint16_t v) { c.set_flip(v); }, [](const cubie_cube& c) { return c.get_flip(); });
+        fill_move_table(
+            slice_sorted_move, slices_sorted_count, [](cubie_cube& c, uint16_t v) { c.set_slice_sorted(v); }, [](const cubie_cube& c) { return c.get_slice_sorted(); });
+
+        corners_thread.join();
+
+        // slice coord is slice_sorted / 24, its value with sorted slice edges is slice * 24.
+        std::thread phase2_thread([data, corners_move, ud_edges_move, slice_sorted_move]() {
+            fill_pruning_table(get_section<uint8_t>(data, corners_slice_prune_section), corners_count * slice_permutations_count, true, [=](uint32_t i, uint32_t m) {
+                const auto c = i / slice_permutations_count;
+                const auto s = i % slice_permutations_count;
+                return corners_move[c * moves_count + m] * slice_permutations_count + slice_sorted_move[s * moves_count + m];
+            });
+            fill_pruning_table(get_section<uint8_t>(data, ud_edges_slice_prune_section), ud_edges_count * slice_permutations_count, true, [=](uint32_t i, uint32_t m) {
+                const auto e = i / slice_permutations_count;
+                const auto s = i % slice_permutations_count;
+                return ud_edges_move[e * moves_count + m] * slice_permutations_count + slice_sorted_move[s * moves_count + m];
+            });
+        });
+
+        fill_pruning_table(get_section<uint8_t>(data, twist_slice_prune_section), twists_count * slices_count, false, [=](uint32_t i, uint32_t m) {
+            const auto t = i / slices_count;
+            const auto s = i % slices_count;
+            return twist_move[t * moves_count + m] * slices_count + slice_sorted_move[s * slice_permutations_count * moves_count + m] / slice_permutations_count;
+        });
+        fill_pruning_table(get_section<uint8_t>(data, flip_slice_prune_section), flips_count * slices_count, false, [=](uint32_t i, uint32_t m) {
+            const auto f = i / slices_count;
+            const auto s = i % slices_count;
+            return flip_move[f * moves_count + m] * slices_count + slice_sorted_move[s * slice_permutations_count * moves_count + m] / slice_permutations_count;
+        });
+
+        phase2_thread.join();
+
+        return res;
+    }
+
+
+    bool is_valid(std::span<const uint8_t> data)
+    {
+        if (data.size() != file_size) {
+            return false;
+        }
+
+        const auto* header = reinterpret_cast<const tables_file_header*>(data.data());
+        return header->magic == tables_file_magic && header->version == tables_file_version && header->size == file_size;
+    }
+
+
+    uint64_t get_process_id()
+    {
+#if defined(_WIN32)
+        return uint64_t(_getpid());
+#else
+        return uint64_t(getpid());
+#endif
+    }
+
+
+    // written aside and renamed, so concurrent runs never map partially written file.
+    bool store(const std::filesystem::path& path, const std::vector<uint8_t>& data)
+    {
+        auto tmp_path = path;
+        // thread id hashes repeat across processes, pid makes the name unique between them.
+        tmp_path += "." + std::to_string(get_process_id()) + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+        {
+            std::ofstream file{tmp_path, std::ios::binary | std::ios::trunc};
+            file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+
+            if (!file) {
+                file.close();
+                std::error_code ec;
+                std::filesystem::remove(tmp_path, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        return !ec;
+    }
+} // namespace
+
+
+rubiks_cube::solver::tables rubiks_cube::solver::tables::load_or_generate(const std::filesystem::path& path)
+{
+    std::error_code ec;
+
+    if (std::filesystem::exists(path, ec)) {
+        mapped_file file{path};
+        if (is_valid(file.get_data())) {
+            return tables{std::move(file)};
+        }
+    }
+
+    auto data = generate();
+
+    if (!store(path, data)) {
+        return tables{mapped_file{std::move(data)}};
+    }
+
+    return tables{mapped_file{path}};
+}
+
+
+rubiks_cube::solver::tables::tables(mapped_file file)
+    : m_file(std::move(file))
+{
+    const auto* data = m_file.get_data().data();
+
+    twist_move = get_section<uint16_t>(data, twist_move_section);
+    flip_move = get_section<uint16_t>(data, flip_move_section);
+    slice_sorted_move = get_section<uint16_t>(data, slice_sorted_move_section);
+    corners_move = get_section<uint16_t>(data, corners_move_section);
+    ud_edges_move = get_section<uint16_t>(data, ud_edges_move_section);
+    twist_slice_prune = get_section<uint8_t>(data, twist_slice_prune_section);
+    flip_slice_prune = get_section<uint8_t>(data, flip_slice_prune_section);
+    corners_slice_prune = get_section<uint8_t>(data, corners_slice_prune_section);
+    ud_edges_slice_prune = get_section<uint8_t>(data, ud_edges_slice_prune_section);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mapped_file.hpp>
+
+#include <cinttypes>
+#include <filesystem>
+
+namespace rubiks_cube::solver
+{
+    constexpr uint32_t twists_count = 2187;
+    constexpr uint32_t flips_count = 2048;
+    constexpr uint32_t slices_count = 495;
+    constexpr uint32_t slices_sorted_count = 11880;
+    constexpr uint32_t corners_count = 40320;
+    constexpr uint32_t ud_edges_count = 40320;
+    constexpr uint32_t slice_permutations_count = 24;
+
+    // u, d and half turns of r, f, l, b keep cube in phase 2 subgroup.
+    constexpr bool is_phase2_move(uint32_t move)
+    {
+        const auto face = move / 3;
+        return face == 0 || face == 3 || move % 3 == 1;
+    }
+
+
+    // move tables are coord * moves_count + move -> coord.
+    // pruning tables are distances to the phase goal, in moves of the phase, for a pair of coords.
+    // built once and stored in the file, mapped on next runs.
+    class tables
+    {
+    public:
+        static tables load_or_generate(const std::filesystem::path&);
+
+        const uint16_t* twist_move;
+        const uint16_t* flip_move;
+        const uint16_t* slice_sorted_move;
+        const uint16_t* corners_move;
+        // phase 2 moves only.
+        const uint16_t* ud_edges_move;
+
+        // twist * slices_count + slice.
+        const uint8_t* twist_slice_prune;
+        // flip * slices_count + slice.
+        const uint8_t* flip_slice_prune;
+        // corners * slice_permutations_count + slice permutation.
+        const uint8_t* corners_slice_prune;
+        // ud_edges * slice_permutations_count + slice permutation.
+        const uint8_t* ud_edges_slice_prune;
+
+    private:
+        explicit tables(mapped_file);
+
+        mapped_file m_file;
+    };
+} // namespace rubiks_cube::solver
@@ -0,0 +1,349 @@
+
+
+#include "two_phase_solver.hpp"
+
+#include <cubie_cube.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+
+namespace
+{
+    using namespace rubiks_cube;
+    using namespace rubiks_cube::solver;
+
+    constexpr uint32_t max_solution_length = 31;
+    constexpr uint32_t no_move = moves_count;
+    // deadline is checked once per that many nodes.
+    constexpr uint64_t nodes_per_clock_check = 4096;
+
+
+    // same face twice in a row, or opposite faces in both orders, give the same states.
+    bool is_redundant(uint32_t prev, uint32_t m)
+    {
+        if (prev == no_move) {
+            return false;
+        }
+
+        const auto face = m / 3;
+        const auto prev_face = prev / 3;
+        return face == prev_face || (face % 3 == prev_face % 3 && face < prev_face);
+    }
+
+
+    struct search_state
+    {
+        search_state(const tables& tables, const cubie_cube& c, uint32_t length, std::chrono::steady_clock::time_point time)
+            : t(tables)
+            , cube(c)
+            , max_length(length)
+            , deadline(time)
+        {
+        }
+
+        const tables& t;
+        cubie_cube cube;
+        uint32_t max_length;
+        std::chrono::steady_clock::time_point deadline;
+
+        std::atomic<uint32_t> best_length{max_solution_length + 1};
+        std::atomic_bool stop{false};
+
+        std::mutex mutex;
+        std::vector<uint32_t> best_moves;
+    };
+
+
+    class search_thread
+    {
+    public:
+        search_thread(search_state& state, uint32_t index, uint32_t threads_count)
+            : m_state(state)
+            , m_index(index)
+            , m_threads_count(threads_count)
+        {
+        }
+
+
+        void run()
+        {
+            const auto& t = m_state.t;
+            const auto twist = m_state.cube.get_twist();
+            const auto flip = m_state.cube.get_flip();
+            const auto slice_sorted = m_state.cube.get_slice_sorted();
+
+            const auto slice = slice_sorted / slice_permutations_count;
+            const uint32_t h = std::max(t.twist_slice_prune[twist * slices_count + slice], t.flip_slice_prune[flip * slices_count + slice]);
+
+            for (auto depth = std::max(h, 1u); depth < m_state.best_length && !is_stopped(); ++depth) {
+                search_phase1(twist, flip, slice_sorted, 0, depth);
+            }
+        }
+
+
+        void search_phase2_from(uint32_t phase1_length)
+        {
+            const auto& t = m_state.t;
+
+            auto cube = m_state.cube;
+            for (uint32_t i = 0; i < phase1_length; ++i) {
+                cube = cube * get_move_cube(m_path[i]);
+            }
+
+            const auto corners = cube.get_corners();
+            const auto ud_edges = cube.get_ud_edges();
+            const auto slice_permutation = cube.get_slice_sorted();
+
+            const uint32_t h = std::max(
+                t.corners_slice_prune[corners * slice_permutations_count + slice_permutation],
+                t.ud_edges_slice_prune[ud_edges * slice_permutations_count + slice_permutation]);
+
+            for (auto depth = h; phase1_length + depth < m_state.best_length && !is_stopped(); ++depth) {
+                if (search_phase2(corners, ud_edges, slice_permutation, phase1_length, depth)) {
+                    store_solution(phase1_length + depth);
+                    return;
+                }
+            }
+        }
+
+    private:
+        bool is_stopped()
+        {
+            if (++m_nodes % nodes_per_clock_check == 0 && std::chrono::steady_clock::now() > m_state.deadline) {
+                m_state.stop = true;
+            }
+
+            return m_state.stop.load(std::memory_order_relaxed);
+        }
+
+
+        uint32_t get_prev_move(uint32_t depth) const
+        {
+            return depth == 0 ? no_move : m_path[depth - 1];
+        }
+
+
+        void search_phase1(uint16_t twist, uint16_t flip, uint16_t slice_sorted, uint32_t depth, uint32_t togo)
+        {
+            if (togo == 0) {
+                // phase 1 ending with a phase 2 move is a shorter phase 1 followed by a longer phase 2, searched already.
+                if (depth == 0 || !is_phase2_move(m_path[depth - 1])) {
+                    search_phase2_from(depth);
+                }
+                return;
+            }
+
+            const auto& t = m_state.t;
+
+            for (uint32_t m = 0; m < moves_count; ++m) {
+                if (depth == 0 && m % m_threads_count != m_index) {
+                    continue;
+                }
+
+                if (is_redundant(get_prev_move(depth), m)) {
+                    continue;
+                }
+
+                const auto new_twist = t.twist_move[twist * moves_count + m];
+                const auto new_flip = t.flip_move[flip * moves_count + m];
+                const auto new_slice_sorted = t.slice_sorted_move[slice_sorted * moves_count + m];
+                const auto slice = new_slice_sorted / slice_permutations_count;
+
+                const uint32_t h = std::max(t.twist_slice_prune[new_twist * slices_count + slice], t.flip_slice_prune[new_flip * slices_count + slice]);
+
+                // can't leave the subgroup and come back in less than 5 moves.
+                if (h > togo - 1 || (h == 0 && togo - 1 > 0 && togo - 1 < 5)) {
+                    continue;
+                }
+
+                m_path[depth] = uint8_t(m);
+                search_phase1(new_twist, new_flip, new_slice_sorted, depth + 1, togo - 1);
+
+                if (is_stopped()) {
+                    return;
+                }
+            }
+        }
+
+
+        bool search_phase2(uint16_t corners, uint16_t ud_edges, uint16_t slice_permutation, uint32_t depth, uint32_t togo)
+        {
+            if (togo == 0) {
+                return corners == 0 && ud_edges == 0 && slice_permutation == 0;
+            }
+
+            const auto& t = m_state.t;
+
+            for (uint32_t m = 0; m < moves_count; ++m) {
+                if (!is_phase2_move(m) || is_redundant(get_prev_move(depth), m)) {
+                    continue;
+                }
+
+                const auto new_corners = t.corners_move[corners * moves_count + m];
+                const auto new_ud_edges = t.ud_edges_move[ud_edges * moves_count + m];
+                const auto new_slice_permutation = t.slice_sorted_move[slice_permutation * moves_count + m];
+
+                const uint32_t h = std::max(
+                    t.corners_slice_prune[new_corners * slice_permutations_count + new_slice_permutation],
+                    t.ud_edges_slice_prune[new_ud_edges * slice_permutations_count + new_slice_permutation]);
+
+                if (h > togo - 1) {
+                    continue;
+                }
+
+                m_path[depth] = uint8_t(m);
+                if (search_phase2(new_corners, new_ud_edges, new_slice_permutation, depth + 1, togo - 1)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+
+        void store_solution(uint32_t length)
+        {
+            std::lock_guard lock{m_state.mutex};
+
+            if (length >= m_state.best_length) {
+                return;
+            }
+
+            m_state.best_length = length;
+            m_state.best_moves.assign(m_path.begin(), m_path.begin() + length);
+
+            if (length <= m_state.max_length) {
+                m_state.stop = true;
+            }
+        }
+
+
+        search_state& m_state;
+        uint32_t m_index;
+        uint32_t m_threads_count;
+        uint64_t m_nodes{0};
+        std::array<uint8_t, max_solution_length + 1> m_path{};
+    };
+
+
+    bool has_centers_at_home(const cube_model::cube_state& state)
+    {
+        for (uint32_t f = 0; f < cube_model::faces_count; ++f) {
+            if (state.get_color(cube_model::face(f), 1, 1) != f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    void append_rotation(std::vector<cube_model::move>& moves, cube_model::axis a, int32_t turns)
+    {
+        for (uint32_t layer = 0; layer < 3; ++layer) {
+            moves.emplace_back(cube_model::move{a, layer, turns});
+        }
+    }
+
+
+    // at most two whole cube rotations bring centers of 3x3 cube home.
+    std::vector<cube_model::move> get_orientation_moves(const cube_model::cube_state& state)
+    {
+        std::vector<cube_model::move> res;
+
+        if (has_centers_at_home(state)) {
+            return res;
+        }
+
+        // all single rotations go before pairs, so a single one is never written as two.
+        for (uint32_t count = 1; count <= 2; ++count) {
+            for (uint32_t first = 0; first < 9; ++first) {
+                for (uint32_t second = 0; second < (count == 1 ? 1u : 9u); ++second) {
+                    res.clear();
+                    append_rotation(res, cube_model::axis(first / 3), int32_t(first % 3) + 1);
+                    if (count == 2) {
+                        append_rotation(res, cube_model::axis(second / 3), int32_t(second % 3) + 1);
+                    }
+
+                    auto rotated = state;
+                    rotated.apply(res);
+
+                    if (has_centers_at_home(rotated)) {
+                        return res;
+                    }
+                }
+            }
+        }
+
+        throw std::runtime_error("invalid cube state.");
+    }
+} // namespace
+
+
+rubiks_cube::solver::two_phase_solver::two_phase_solver(const tables& t)
+    : m_tables(t)
+{
+}
+
+
+std::optional<std::vector<rubiks_cube::cube_model::move>> rubiks_cube::solver::two_phase_solver::solve(
+    const cube_model::cube_state& state, const solve_options& options) const
+{
+    if (state.get_size() != 3) {
+        throw std::runtime_error("only 3x3 cubes are supported by the solver.");
+    }
+
+    auto res = get_orientation_moves(state);
+
+    auto oriented = state;
+    oriented.apply(res);
+
+    const auto cube = cubie_cube::from_state(oriented);
+
+    if (!cube || !cube->is_solvable()) {
+        throw std::runtime_error("invalid cube state.");
+    }
+
+    if (*cube == cubie_cube{}) {
+        return res;
+    }
+
+    search_state search{m_tables, *cube, options.max_length, std::chrono::steady_clock::now() + options.timeout};
+
+    auto threads_count = options.threads_count != 0 ? options.threads_count : std::max(std::thread::hardware_concurrency(), 1u);
+    threads_count = std::min(threads_count, moves_count);
+
+    // phase 1 of length 0 has no first move to split.
+    if (cube->get_twist() == 0 && cube->get_flip() == 0 && cube->get_slice_sorted() / slice_permutations_count == 0) {
+        search_thread(search, 0, 1).search_phase2_from(0);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count - 1);
+
+    for (uint32_t i = 1; i < threads_count; ++i) {
+        threads.emplace_back([&search, i, threads_count]() {
+            search_thread(search, i, threads_count).run();
+        });
+    }
+
+    search_thread(search, 0, threads_count).run();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (search.best_moves.empty()) {
+        return std::nullopt;
+    }
+
+    for (const auto m : search.best_moves) {
+        res.emplace_back(get_model_move(m));
+    }
+
+    return res;
+}
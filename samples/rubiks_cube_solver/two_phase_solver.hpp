@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cube_state.hpp>
+#include <solver_tables.hpp>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace rubiks_cube::solver
+{
+    struct solve_options
+    {
+        // search stops at the first solution not longer than it, whole cube rotations are not counted.
+        uint32_t max_length = 21;
+        // the best solution found so far is returned after it, even if it is longer than max_length.
+        std::chrono::milliseconds timeout{10000};
+        // 0 is hardware concurrency.
+        uint32_t threads_count = 0;
+    };
+
+
+    // kociemba two phase algorithm: ida* to the <u, d, r2, f2, l2, b2> subgroup, then ida* to solved cube inside of it.
+    // first phase 1 moves are split between threads.
+    class two_phase_solver
+    {
+    public:
+        explicit two_phase_solver(const tables&);
+
+        // moves which solve the state, applicable to it with cube_state::apply.
+        // cube is rotated first if centers are not at home. throws for sizes other than 3 and invalid states,
+        // nullopt if nothing was found in time.
+        std::optional<std::vector<cube_model::move>> solve(const cube_model::cube_state&, const solve_options& = {}) const;
+
+    private:
+        const tables& m_tables;
+    };
+} // namespace rubiks_cube::solver
@@ -0,0 +1,156 @@
+
+
+#include <cube_state.hpp>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#define CHECK(expr)                                                        \
+    do {                                                                   \
+        if (!(expr)) {                                                     \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            ++failures;                                                    \
+        }                                                                  \
+    } while (false)
+
+namespace
+{
+    using namespace rubiks_cube::cube_model;
+
+    int failures = 0;
+
+    // whole cube rotation is the same turn of every layer of the axis.
+    void rotate_cube(cube_state& state, axis a, int32_t turns, std::vector<move>& history)
+    {
+        for (uint32_t layer = 0; layer < state.get_size(); ++layer) {
+            state.apply(move{a, layer, turns});
+            history.emplace_back(move{a, layer, turns});
+        }
+    }
+
+
+    // colors counts behind is_solved must agree with the full scan after every single move.
+    void check_solved_state(const cube_state& state, const move& m)
+    {
+        if (state.is_solved() != state.is_each_face_single_colored()) {
+            std::printf("size %zu, after move axis %d layer %u turns %d: is_solved %d, full scan %d\n",
+                        state.get_size(), int(m.axis), m.layer, m.turns,
+                        int(state.is_solved()), int(state.is_each_face_single_colored()));
+            ++failures;
+        }
+    }
+
+
+    void scramble_and_unscramble(size_t size, std::mt19937& random)
+    {
+        cube_state state{size};
+        CHECK(state.is_solved() && state.is_each_face_single_colored());
+
+        std::uniform_int_distribution<uint32_t> axis_dist{0, 2};
+        std::uniform_int_distribution<uint32_t> layer_dist{0, uint32_t(size) - 1};
+        std::uniform_int_distribution<int32_t> turns_dist{-2, 2};
+        std::uniform_int_distribution<uint32_t> kind_dist{0, 9};
+
+        std::vector<move> history;
+
+        for (uint32_t i = 0; i < 500; ++i) {
+            const auto a = axis(axis_dist(random));
+            const auto turns = turns_dist(random);
+
+            if (kind_dist(random) == 0) {
+                rotate_cube(state, a, turns, history);
+                check_solved_state(state, history.back());
+                continue;
+            }
+
+            // middle layers are as likely as outer ones.
+            const move m{a, layer_dist(random), turns};
+            state.apply(m);
+            history.emplace_back(m);
+            check_solved_state(state, m);
+
+            // turning the cube right back often reaches solved states which aren't the initial one.
+            if (kind_dist(random) == 0) {
+                const move back{m.axis, m.layer, -m.turns};
+                state.apply(back);
+                history.emplace_back(back);
+                check_solved_state(state, back);
+            }
+        }
+
+        // state rebuilt from colors has the same counts.
+        std::vector<uint8_t> colors(state.get_facelets_count());
+        for (uint32_t facelet = 0; facelet < colors.size(); ++facelet) {
+            colors[facelet] = state.get_color(facelet);
+        }
+        const cube_state copy{size, colors};
+        CHECK(copy == state);
+        CHECK(copy.is_solved() == state.is_solved());
+
+        // undoing every move goes through the same states backwards and ends solved.
+        for (auto it = history.rbegin(); it != history.rend(); ++it) {
+            const move back{it->axis, it->layer, -it->turns};
+            state.apply(back);
+            check_solved_state(state, back);
+        }
+
+        CHECK(state == cube_state{size});
+        CHECK(state.is_solved());
+    }
+
+
+    void rotated_cube_is_solved(size_t size)
+    {
+        cube_state state{size};
+        std::vector<move> history;
+
+        for (uint32_t a = 0; a < 3; ++a) {
+            rotate_cube(state, axis(a), 1, history);
+            CHECK(state.is_solved() && state.is_each_face_single_colored());
+        }
+
+        CHECK(!(state == cube_state{size}));
+    }
+
+
+    void middle_layer_turn_isnt_solved(size_t size)
+    {
+        cube_state state{size};
+        state.apply(move{x, uint32_t(size / 2), 1});
+
+        CHECK(!state.is_solved() && !state.is_each_face_single_colored());
+    }
+} // namespace
+
+
+int main()
+{
+    std::mt19937 random{20240601};
+
+    for (size_t size = 1; size <= 7; ++size) {
+        for (uint32_t i = 0; i < 4; ++i) {
+            scramble_and_unscramble(size, random);
+        }
+
+        if (size > 1) {
+            rotated_cube_is_solved(size);
+        }
+
+        if (size > 2) {
+            middle_layer_turn_isnt_solved(size);
+        }
+    }
+
+    // dynamic tables path.
+    scramble_and_unscramble(9, random);
+    scramble_and_unscramble(12, random);
+
+    if (failures > 0) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+
+    std::printf("all checks passed\n");
+    return 0;
+}
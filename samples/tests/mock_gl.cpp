@@ -0,0 +1,202 @@
+
+
+#include "mock_gl.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace
+{
+    tests::mock_gl* current = nullptr;
+} // namespace
+
+
+tests::mock_gl::mock_gl()
+    : m_get_integer(glad_glGetIntegerv)
+    , m_gen_buffers(glad_glGenBuffers)
+    , m_delete_buffers(glad_glDeleteBuffers)
+    , m_bind_buffer(glad_glBindBuffer)
+    , m_buffer_data(glad_glBufferData)
+    , m_map_buffer_range(glad_glMapBufferRange)
+    , m_flush_mapped_buffer_range(glad_glFlushMappedBufferRange)
+    , m_unmap_buffer(glad_glUnmapBuffer)
+    , m_bind_buffer_range(glad_glBindBufferRange)
+    , m_fence_sync(glad_glFenceSync)
+    , m_client_wait_sync(glad_glClientWaitSync)
+    , m_delete_sync(glad_glDeleteSync)
+{
+    if (current != nullptr) {
+        throw std::runtime_error("mock gl is already installed.");
+    }
+
+    current = this;
+
+    glad_glGetIntegerv = &get_integer;
+    glad_glGenBuffers = &gen_buffers;
+    glad_glDeleteBuffers = &delete_buffers;
+    glad_glBindBuffer = &bind_buffer;
+    glad_glBufferData = &buffer_data;
+    glad_glMapBufferRange = &map_buffer_range;
+    glad_glFlushMappedBufferRange = &flush_mapped_buffer_range;
+    glad_glUnmapBuffer = &unmap_buffer;
+    glad_glBindBufferRange = &bind_buffer_range;
+    glad_glFenceSync = &fence_sync;
+    glad_glClientWaitSync = &client_wait_sync;
+    glad_glDeleteSync = &delete_sync;
+}
+
+
+tests::mock_gl::~mock_gl()
+{
+    glad_glGetIntegerv = m_get_integer;
+    glad_glGenBuffers = m_gen_buffers;
+    glad_glDeleteBuffers = m_delete_buffers;
+    glad_glBindBuffer = m_bind_buffer;
+    glad_glBufferData = m_buffer_data;
+    glad_glMapBufferRange = m_map_buffer_range;
+    glad_glFlushMappedBufferRange = m_flush_mapped_buffer_range;
+    glad_glUnmapBuffer = m_unmap_buffer;
+    glad_glBindBufferRange = m_bind_buffer_range;
+    glad_glFenceSync = m_fence_sync;
+    glad_glClientWaitSync = m_client_wait_sync;
+    glad_glDeleteSync = m_delete_sync;
+
+    current = nullptr;
+}
+
+
+tests::mock_gl& tests::mock_gl::get()
+{
+    return *current;
+}
+
+
+void tests::mock_gl::reset_calls()
+{
+    mapped_ranges.clear();
+    flushed_ranges.clear();
+    bound_ranges.clear();
+    fence_waits = 0;
+}
+
+
+void APIENTRY tests::mock_gl::get_integer(GLenum name, GLint* data)
+{
+    auto it = get().integers.find(name);
+    if (it == get().integers.end()) {
+        throw std::runtime_error("mock gl has no value of integer " + std::to_string(name) + ".");
+    }
+    *data = it->second;
+}
+
+
+void APIENTRY tests::mock_gl::gen_buffers(GLsizei n, GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        buffers[i] = get().m_next_buffer++;
+        get().buffers[buffers[i]];
+    }
+}
+
+
+void APIENTRY tests::mock_gl::delete_buffers(GLsizei n, const GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; ++i) {
+        get().buffers.erase(buffers[i]);
+    }
+}
+
+
+void APIENTRY tests::mock_gl::bind_buffer(GLenum target, GLuint buffer)
+{
+    get().bound_buffers[target] = buffer;
+}
+
+
+void APIENTRY tests::mock_gl::buffer_data(GLenum target, GLsizeiptr size, const void* data, GLenum)
+{
+    auto& storage = get().buffers.at(get().bound_buffers.at(target));
+    storage.assign(size_t(size), 0);
+
+    if (data != nullptr) {
+        std::memcpy(storage.data(), data, size_t(size));
+    }
+}
+
+
+void* APIENTRY tests::mock_gl::map_buffer_range(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield)
+{
+    const auto buffer = get().bound_buffers.at(target);
+    const auto& storage = get().buffers.at(buffer);
+
+    if (size_t(offset + length) > storage.size() || get().m_mappings.count(target) > 0) {
+        throw std::runtime_error("invalid buffer mapping.");
+    }
+
+    get().mapped_ranges.push_back({buffer, size_t(offset), size_t(length)});
+
+    // mapping starts as garbage, gpu never sees bytes which aren't flushed.
+    auto& mapping = get().m_mappings[target];
+    mapping = {buffer, size_t(offset), std::vector<uint8_t>(size_t(length), 0xcd)};
+
+    return mapping.data.data();
+}
+
+
+void APIENTRY tests::mock_gl::flush_mapped_buffer_range(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+    const auto& mapping = get().m_mappings.at(target);
+
+    if (size_t(offset + length) > mapping.data.size()) {
+        throw std::runtime_error("flushed range is out of mapping.");
+    }
+
+    auto& storage = get().buffers.at(mapping.buffer);
+    std::copy_n(mapping.data.begin() + offset, length, storage.begin() + ptrdiff_t(mapping.offset) + offset);
+
+    get().flushed_ranges.push_back({mapping.buffer, mapping.offset + size_t(offset), size_t(length)});
+}
+
+
+GLboolean APIENTRY tests::mock_gl::unmap_buffer(GLenum target)
+{
+    return get().m_mappings.erase(target) > 0 ? GL_TRUE : GL_FALSE;
+}
+
+
+void APIENTRY tests::mock_gl::bind_buffer_range(GLenum, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    get().bound_ranges.push_back({index, buffer, size_t(offset), size_t(size)});
+}
+
+
+GLsync APIENTRY tests::mock_gl::fence_sync(GLenum, GLbitfield)
+{
+    auto fence = reinterpret_cast<GLsync>(get().m_next_fence++);
+    get().fences.insert(fence);
+    get().m_fence_timeouts_left[fence] = get().fence_timeouts;
+    return fence;
+}
+
+
+GLenum APIENTRY tests::mock_gl::client_wait_sync(GLsync sync, GLbitfield, GLuint64)
+{
+    get().fence_waits++;
+    auto& timeouts_left = get().m_fence_timeouts_left.at(sync);
+
+    if (timeouts_left > 0) {
+        --timeouts_left;
+        return GL_TIMEOUT_EXPIRED;
+    }
+
+    return GL_CONDITION_SATISFIED;
+}
+
+
+void APIENTRY tests::mock_gl::delete_sync(GLsync sync)
+{
+    get().fences.erase(sync);
+    get().m_fence_timeouts_left.erase(sync);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cinttypes>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace tests
+{
+    // replaces glad entry points of buffers, uniform bindings and fences with recording fakes,
+    // so renderer code runs without a context. previous entry points are restored on destruction.
+    class mock_gl
+    {
+    public:
+        struct buffer_range
+        {
+            GLuint buffer;
+            size_t offset;
+            size_t size;
+        };
+
+        struct binding_range
+        {
+            GLuint index;
+            GLuint buffer;
+            size_t offset;
+            size_t size;
+        };
+
+        mock_gl();
+        ~mock_gl();
+
+        mock_gl(const mock_gl&) = delete;
+        mock_gl& operator=(const mock_gl&) = delete;
+
+        static mock_gl& get();
+
+        // forgets recorded calls, buffers and fences stay.
+        void reset_calls();
+
+        // glGetIntegerv results.
+        std::map<GLenum, GLint> integers;
+
+        // what gpu sees, mapped bytes get here only when they are flushed.
+        std::map<GLuint, std::vector<uint8_t>> buffers;
+        std::map<GLenum, GLuint> bound_buffers;
+
+        // offsets are from the buffer start.
+        std::vector<buffer_range> mapped_ranges;
+        std::vector<buffer_range> flushed_ranges;
+        std::vector<binding_range> bound_ranges;
+
+        // every wait on a fence times out this many times before the fence is signaled.
+        uint32_t fence_timeouts{0};
+        uint32_t fence_waits{0};
+        std::set<GLsync> fences;
+
+    private:
+        struct mapping
+        {
+            GLuint buffer;
+            size_t offset;
+            std::vector<uint8_t> data;
+        };
+
+        static void APIENTRY get_integer(GLenum name, GLint* data);
+        static void APIENTRY gen_buffers(GLsizei n, GLuint* buffers);
+        static void APIENTRY delete_buffers(GLsizei n, const GLuint* buffers);
+        static void APIENTRY bind_buffer(GLenum target, GLuint buffer);
+        static void APIENTRY buffer_data(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+        static void* APIENTRY map_buffer_range(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+        static void APIENTRY flush_mapped_buffer_range(GLenum target, GLintptr offset, GLsizeiptr length);
+        static GLboolean APIENTRY unmap_buffer(GLenum target);
+        static void APIENTRY bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+        static GLsync APIENTRY fence_sync(GLenum condition, GLbitfield flags);
+        static GLenum APIENTRY client_wait_sync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+        static void APIENTRY delete_sync(GLsync sync);
+
+        std::map<GLenum, mapping> m_mappings;
+        GLuint m_next_buffer{1};
+        uintptr_t m_next_fence{1};
+        std::map<GLsync, uint32_t> m_fence_timeouts_left;
+
+        PFNGLGETINTEGERVPROC m_get_integer;
+        PFNGLGENBUFFERSPROC m_gen_buffers;
+        PFNGLDELETEBUFFERSPROC m_delete_buffers;
+        PFNGLBINDBUFFERPROC m_bind_buffer;
+        PFNGLBUFFERDATAPROC m_buffer_data;
+        PFNGLMAPBUFFERRANGEPROC m_map_buffer_range;
+        PFNGLFLUSHMAPPEDBUFFERRANGEPROC m_flush_mapped_buffer_range;
+        PFNGLUNMAPBUFFERPROC m_unmap_buffer;
+        PFNGLBINDBUFFERRANGEPROC m_bind_buffer_range;
+        PFNGLFENCESYNCPROC m_fence_sync;
+        PFNGLCLIENTWAITSYNCPROC m_client_wait_sync;
+        PFNGLDELETESYNCPROC m_delete_sync;
+    };
+} // namespace tests
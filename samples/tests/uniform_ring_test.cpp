@@ -0,0 +1,231 @@
+
+
+#include "mock_gl.hpp"
+
+#include <renderer/gl/binding_points.hpp>
+#include <renderer/gl/frame_sync.hpp>
+#include <renderer/gl/parameters_list.hpp>
+#include <renderer/gl/renderer.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#define CHECK(expr)                                                        \
+    do {                                                                   \
+        if (!(expr)) {                                                     \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            ++failures;                                                    \
+        }                                                                  \
+    } while (false)
+
+namespace
+{
+    int failures = 0;
+
+    template<typename Fn>
+    bool throws(Fn&& fn)
+    {
+        try {
+            fn();
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+
+
+    void binding_points_are_bounded()
+    {
+        tests::mock_gl gl;
+        gl.integers[GL_MAX_UNIFORM_BUFFER_BINDINGS] = 3;
+
+        renderer::gl::binding_points bindings;
+        CHECK(bindings.acquire() == 0);
+        CHECK(bindings.acquire() == 1);
+        CHECK(bindings.acquire() == 2);
+        CHECK(throws([&]() { bindings.acquire(); }));
+
+        bindings.release(1);
+        CHECK(bindings.acquire() == 1);
+        CHECK(throws([&]() { bindings.acquire(); }));
+
+        bindings.clear();
+        CHECK(bindings.acquire() == 0);
+    }
+
+
+    void renderer_reuses_released_binding_points()
+    {
+        tests::mock_gl gl;
+        gl.integers[GL_MAX_UNIFORM_BUFFER_BINDINGS] = 2;
+        gl.integers[GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT] = 256;
+
+        renderer::gl::renderer renderer;
+        const renderer::parameters_list_descriptor descriptor{.parameters = {renderer::parameter_type::vec4}};
+
+        const auto first = renderer.create_parameters_list(descriptor);
+        const auto second = renderer.create_parameters_list(descriptor);
+        CHECK(gl.buffers.size() == 2);
+
+        // overflow is an error in every build, and no list is left behind.
+        CHECK(throws([&]() { renderer.create_parameters_list(descriptor); }));
+        CHECK(gl.buffers.size() == 2);
+
+        renderer.destroy_parameters_list(first);
+        CHECK(gl.buffers.size() == 1);
+
+        const auto third = renderer.create_parameters_list(descriptor);
+        CHECK(third != renderer::null);
+        CHECK(throws([&]() { renderer.create_parameters_list(descriptor); }));
+
+        renderer.destroy_parameters_list(second);
+        renderer.destroy_parameters_list(third);
+        renderer.clear();
+        CHECK(gl.buffers.empty());
+    }
+
+
+    void parameters_are_written_into_ring_regions()
+    {
+        tests::mock_gl gl;
+        gl.integers[GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT] = 256;
+
+        constexpr size_t frames = renderer::gl::frame_sync::frames_in_flight;
+
+        // vec4, mat4, vec4 lie at 0, 16 and 80, region is aligned up to 256.
+        renderer::gl::parameters_list list({.parameters = {
+                                                renderer::parameter_type::vec4,
+                                                renderer::parameter_type::mat4,
+                                                renderer::parameter_type::vec4}});
+        CHECK(gl.buffers.size() == 1);
+        const auto buffer = gl.buffers.begin()->first;
+        CHECK(gl.buffers[buffer].size() == 256 * frames);
+
+        float color[4] = {1, 2, 3, 4};
+        float matrix[16];
+        float tint[4] = {5, 6, 7, 8};
+        for (size_t i = 0; i < 16; ++i) {
+            matrix[i] = float(i);
+        }
+
+        list.set_parameter_data(0, color);
+        list.set_parameter_data(1, matrix);
+        list.set_parameter_data(2, tint);
+
+        // every region gets all parameters once.
+        for (size_t frame = 0; frame < frames; ++frame) {
+            gl.reset_calls();
+            list.load_data_to_gpu(frame);
+
+            CHECK(gl.mapped_ranges.size() == 1);
+            CHECK(gl.mapped_ranges[0].offset == frame * 256 && gl.mapped_ranges[0].size == 96);
+            CHECK(gl.flushed_ranges.size() == 1);
+            CHECK(gl.flushed_ranges[0].offset == frame * 256 && gl.flushed_ranges[0].size == 96);
+            CHECK(gl.bound_ranges.size() == 1);
+            CHECK(gl.bound_ranges[0].buffer == buffer);
+            CHECK(gl.bound_ranges[0].offset == frame * 256 && gl.bound_ranges[0].size == 256);
+
+            const auto* region = gl.buffers[buffer].data() + frame * 256;
+            CHECK(std::memcmp(region, color, sizeof(color)) == 0);
+            CHECK(std::memcmp(region + 16, matrix, sizeof(matrix)) == 0);
+            CHECK(std::memcmp(region + 80, tint, sizeof(tint)) == 0);
+        }
+
+        // nothing is stale, the region is only bound.
+        gl.reset_calls();
+        list.load_data_to_gpu(0);
+        CHECK(gl.mapped_ranges.empty() && gl.flushed_ranges.empty());
+        CHECK(gl.bound_ranges.size() == 1 && gl.bound_ranges[0].offset == 0);
+
+        // the same data doesn't make the parameter stale.
+        list.set_parameter_data(1, matrix);
+        gl.reset_calls();
+        list.load_data_to_gpu(1);
+        CHECK(gl.mapped_ranges.empty());
+
+        // one changed parameter is written into the next frames_in_flight regions only.
+        matrix[5] = 42;
+        list.set_parameter_data(1, matrix);
+        for (size_t i = 0; i < frames + 1; ++i) {
+            const auto frame = (2 + i) % frames;
+            gl.reset_calls();
+            list.load_data_to_gpu(frame);
+
+            if (i < frames) {
+                CHECK(gl.mapped_ranges.size() == 1);
+                CHECK(gl.mapped_ranges[0].offset == frame * 256 + 16 && gl.mapped_ranges[0].size == 64);
+                CHECK(gl.flushed_ranges.size() == 1);
+                CHECK(gl.flushed_ranges[0].offset == frame * 256 + 16 && gl.flushed_ranges[0].size == 64);
+                CHECK(std::memcmp(gl.buffers[buffer].data() + frame * 256 + 16, matrix, sizeof(matrix)) == 0);
+            } else {
+                CHECK(gl.mapped_ranges.empty());
+            }
+        }
+
+        // parameters which aren't adjacent share a mapping, but are flushed separately.
+        color[0] = 10;
+        tint[3] = 20;
+        list.set_parameter_data(0, color);
+        list.set_parameter_data(2, tint);
+        gl.reset_calls();
+        list.load_data_to_gpu(2);
+
+        CHECK(gl.mapped_ranges.size() == 1);
+        CHECK(gl.mapped_ranges[0].offset == 2 * 256 && gl.mapped_ranges[0].size == 96);
+        CHECK(gl.flushed_ranges.size() == 2);
+        CHECK(gl.flushed_ranges[0].offset == 2 * 256 && gl.flushed_ranges[0].size == 16);
+        CHECK(gl.flushed_ranges[1].offset == 2 * 256 + 80 && gl.flushed_ranges[1].size == 16);
+
+        const auto* region = gl.buffers[buffer].data() + 2 * 256;
+        CHECK(std::memcmp(region, color, sizeof(color)) == 0);
+        CHECK(std::memcmp(region + 16, matrix, sizeof(matrix)) == 0);
+        CHECK(std::memcmp(region + 80, tint, sizeof(tint)) == 0);
+    }
+
+
+    void frames_wait_for_their_fences()
+    {
+        tests::mock_gl gl;
+        gl.fence_timeouts = 2;
+
+        renderer::gl::frame_sync sync;
+        constexpr size_t frames = renderer::gl::frame_sync::frames_in_flight;
+
+        // first frames_in_flight frames have nothing to wait for.
+        for (size_t frame = 0; frame < frames; ++frame) {
+            CHECK(sync.begin_frame() == frame);
+            sync.end_frame();
+        }
+        CHECK(gl.fence_waits == 0);
+        CHECK(gl.fences.size() == frames);
+
+        // region is reused only after its fence is signaled.
+        CHECK(sync.begin_frame() == 0);
+        CHECK(gl.fence_waits == 3);
+        CHECK(gl.fences.size() == frames - 1);
+        sync.end_frame();
+        CHECK(gl.fences.size() == frames);
+
+        sync.clear();
+        CHECK(gl.fences.empty());
+        CHECK(sync.current_frame() == 0);
+    }
+} // namespace
+
+
+int main()
+{
+    binding_points_are_bounded();
+    renderer_reuses_released_binding_points();
+    parameters_are_written_into_ring_regions();
+    frames_wait_for_their_fences();
+
+    if (failures > 0) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+
+    std::printf("all checks passed\n");
+    return 0;
+}
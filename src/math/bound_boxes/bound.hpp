@@ -83,7 +83,7 @@ namespace math::bound_boxes
                 return std::numeric_limits<DataType>::max();
             });
             math::detail::transform<Size - 1>::apply(max, max, max, [](auto& v1, auto& v2) {
-                return std::numeric_limits<DataType>::min();
+                return std::numeric_limits<DataType>::lowest();
             });
         };
 
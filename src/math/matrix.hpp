@@ -4,6 +4,7 @@
 #pragma once
 
 #include <math/vector.hpp>
+#include <math/simd/simd.hpp>
 
 #include <cstddef>
 #include <cassert>
@@ -44,6 +45,16 @@ namespace math
         {
         };
 
+        // tag for matrices which are fully overwritten right after construction.
+        struct uninitialized_t
+        {
+        };
+
+        constexpr uninitialized_t uninitialized{};
+
+        template<size_t Rows, size_t Cols, typename DataType>
+        constexpr bool is_simd_matrix = simd::enabled && std::is_same_v<DataType, float> && Rows == 4 && Cols == 4;
+
         template<typename X, typename Y>
         struct add_result
         {
@@ -256,6 +267,11 @@ namespace math
         }
 
 
+        explicit mat(detail::uninitialized_t)
+        {
+        }
+
+
         mat(std::initializer_list<DataType> init_values)
         {
             for (size_t row = 0; row < Rows; row++) {
@@ -293,6 +309,13 @@ namespace math
     auto operator*(const mat<RowsX, ColsX, DataTypeX>& x, const mat<RowsY, ColsY, DataTypeY>& y)
     {
         static_assert(ColsX == RowsY);
+
+        if constexpr (detail::is_simd_matrix<RowsX, ColsX, DataTypeX> && detail::is_simd_matrix<RowsY, ColsY, DataTypeY>) {
+            mat<RowsX, ColsY, float> res{detail::uninitialized};
+            simd::mat4_mul(&x[0][0], &y[0][0], &res[0][0]);
+            return res;
+        }
+
         mat<RowsX, ColsY, detail::mul_result_t<DataTypeX, DataTypeY>> res{};
         detail::for_i<ColsY - 1>::template call<detail::calc_row>(res, x, y);
         return res;
@@ -303,6 +326,12 @@ namespace math
     auto operator*(mat<MatRows, MatCols, MatDataType>& mat, vec<MatCols, VecDataType>& v)
     {
         vec<MatCols, detail::mul_result_t<MatDataType, VecDataType>> res{};
+
+        if constexpr (detail::is_simd_matrix<MatRows, MatCols, MatDataType> && std::is_same_v<VecDataType, float>) {
+            simd::store4(&res.x, simd::mat4_mul_vec4(&mat[0][0], simd::load4(&v.x)));
+            return res;
+        }
+
         detail::for_i<MatCols - 1>::template call<detail::mat_mul_vec>(res, v, mat);
         return res;
     }
@@ -312,6 +341,12 @@ namespace math
     auto operator*(vec<MatCols, VecDataType>& v, mat<MatRows, MatCols, MatDataType>& mat)
     {
         vec<MatCols, detail::mul_result_t<MatDataType, VecDataType>> res{};
+
+        if constexpr (detail::is_simd_matrix<MatRows, MatCols, MatDataType> && std::is_same_v<VecDataType, float>) {
+            simd::store4(&res.x, simd::vec4_mul_mat4(simd::load4(&v.x), &mat[0][0]));
+            return res;
+        }
+
         detail::for_i<MatRows - 1>::template call<detail::vec_mul_mat>(res, v, mat);
         return res;
     }
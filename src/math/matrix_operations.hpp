@@ -187,6 +187,10 @@ namespace math
 
     inline mat4 transpose(const mat4& m)
     {
+#ifdef MATH_SIMD_SSE
+        mat4 res{detail::uninitialized};
+        simd::mat4_transpose(&m[0][0], &res[0][0]);
+#else
         mat4 res;
 
         res[0][0] = m[0][0];
@@ -208,6 +212,7 @@ namespace math
         res[3][1] = m[1][3];
         res[3][2] = m[2][3];
         res[3][3] = m[3][3];
+#endif
 
         return res;
     }
@@ -215,6 +220,11 @@ namespace math
 
     inline mat4 inverse(const mat4& m)
     {
+#ifdef MATH_SIMD_SSE
+        mat4 dst{detail::uninitialized};
+        simd::mat4_inverse(&m[0][0], &dst[0][0]);
+        return dst;
+#else
         auto tmp_0 = m[2][2] * m[3][3];
         auto tmp_1 = m[3][2] * m[2][3];
         auto tmp_2 = m[1][2] * m[3][3];
@@ -266,6 +276,7 @@ namespace math
         dst[3][2] = d * ((tmp_18 * m[1][2] + tmp_23 * m[3][2] + tmp_15 * m[0][2]) - (tmp_22 * m[3][2] + tmp_14 * m[0][2] + tmp_19 * m[1][2]));
         dst[3][3] = d * ((tmp_22 * m[2][2] + tmp_16 * m[0][2] + tmp_21 * m[1][2]) - (tmp_20 * m[1][2] + tmp_23 * m[2][2] + tmp_17 * m[0][2]));
         return dst;
+#endif
     }
 
 
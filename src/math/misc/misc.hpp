@@ -3,8 +3,11 @@
 
 #pragma once
 
-#include <cstdlib>
 #include <math/vector.hpp>
+#include <math/misc/random.hpp>
+
+#include <algorithm>
+#include <cmath>
 
 namespace math::misc
 {
@@ -35,26 +38,43 @@ namespace math::misc
         return true;
     }
 
-    inline float rand_float()
+    inline float rand_float(pcg32& rng)
     {
-        return float(std::rand()) / RAND_MAX;
+        return rng.next_float();
     }
 
-    inline math::vec3 random_in_unit_sphere()
+    // uniformly distributed unit vector, so normal + random_in_unit_sphere is cosine distributed.
+    inline math::vec3 random_in_unit_sphere(pcg32& rng)
     {
-        auto x = rand_float() * 2.0f - 1.0f;
-        auto y = rand_float() * 2.0f - 1.0f;
-        auto z = rand_float() * 2.0f - 1.0f;
+        auto z = rand_float(rng) * 2.0f - 1.0f;
+        auto phi = rand_float(rng) * 2.0f * float(M_PI);
+        auto r = std::sqrt(std::max(0.0f, 1.0f - z * z));
 
-        return math::normalize(math::vec3{x, y, z});
+        return math::vec3{r * std::cos(phi), r * std::sin(phi), z};
     }
 
-    inline math::vec3 random_in_unit_disc()
+    inline math::vec3 random_in_unit_disc(pcg32& rng)
     {
-        auto x = rand_float() * 2.0f - 1.0f;
-        auto y = rand_float() * 2.0f - 1.0f;
+        auto x = rand_float(rng) * 2.0f - 1.0f;
+        auto y = rand_float(rng) * 2.0f - 1.0f;
 
         return math::normalize(math::vec3{x, y, 0.0});
     }
+
+    // same on generator of the calling thread.
+    inline float rand_float()
+    {
+        return rand_float(get_thread_rng());
+    }
+
+    inline math::vec3 random_in_unit_sphere()
+    {
+        return random_in_unit_sphere(get_thread_rng());
+    }
+
+    inline math::vec3 random_in_unit_disc()
+    {
+        return random_in_unit_disc(get_thread_rng());
+    }
 }
 
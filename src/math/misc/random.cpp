@@ -0,0 +1,13 @@
+
+
+#include "random.hpp"
+
+#include <atomic>
+
+
+math::misc::pcg32& math::misc::get_thread_rng()
+{
+    static std::atomic<uint64_t> next_stream{0};
+    thread_local pcg32 rng{pcg32::default_seed, next_stream.fetch_add(1, std::memory_order_relaxed)};
+    return rng;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cinttypes>
+
+namespace math::misc
+{
+    // pcg32 (xsh rr), 64 bit state, 2^63 independent streams.
+    class pcg32
+    {
+    public:
+        constexpr static uint64_t default_seed = 0x853c49e6748fea9bull;
+
+        explicit pcg32(uint64_t seed = default_seed, uint64_t stream = 0)
+        {
+            set_seed(seed, stream);
+        }
+
+        void set_seed(uint64_t seed, uint64_t stream = 0)
+        {
+            m_state = 0;
+            m_inc = (stream << 1u) | 1u;
+            next_uint();
+            m_state += seed;
+            next_uint();
+        }
+
+        uint32_t next_uint()
+        {
+            const auto old = m_state;
+            m_state = old * 6364136223846793005ull + m_inc;
+            const auto xorshifted = uint32_t(((old >> 18u) ^ old) >> 27u);
+            const auto rot = uint32_t(old >> 59u);
+            return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+        }
+
+        // [0, 1), 24 random bits.
+        float next_float()
+        {
+            return float(next_uint() >> 8) * 0x1p-24f;
+        }
+
+    private:
+        uint64_t m_state;
+        uint64_t m_inc;
+    };
+
+
+    // generator of the calling thread, every thread gets its own stream of default seed.
+    // reseed it per task (e.g. per pixel) to get results independent of threads scheduling.
+    pcg32& get_thread_rng();
+
+    // splitmix64 finalizer, mixes values into a seed or a stream index.
+    constexpr uint64_t mix_seed(uint64_t a, uint64_t b = 0)
+    {
+        auto z = a + 0x9e3779b97f4a7c15ull * (b + 1);
+        z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27u)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31u);
+    }
+} // namespace math::misc
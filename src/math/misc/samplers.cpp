@@ -0,0 +1,55 @@
+
+
+#include "samplers.hpp"
+
+
+namespace
+{
+    float wrap(float v)
+    {
+        return v - float(v >= 1.f);
+    }
+} // namespace
+
+
+void math::misc::sobol_2d(uint32_t first, size_t count, uint32_t scramble_x, uint32_t scramble_y, float* xs, float* ys)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const auto index = first + uint32_t(i);
+        xs[i] = fixed_to_float(sobol_x(index) ^ scramble_x);
+        ys[i] = fixed_to_float(sobol_y(index) ^ scramble_y);
+    }
+}
+
+
+void math::misc::halton_2d(uint32_t first, size_t count, float offset_x, float offset_y, float* xs, float* ys)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const auto index = first + uint32_t(i);
+        xs[i] = wrap(fixed_to_float(reverse_bits(index)) + offset_x);
+        ys[i] = wrap(radical_inverse(index, 3) + offset_y);
+    }
+}
+
+
+void math::misc::stratified_2d(pcg32& rng, uint32_t nx, uint32_t ny, float* xs, float* ys)
+{
+    const auto dx = 1.f / float(nx);
+    const auto dy = 1.f / float(ny);
+
+    for (uint32_t y = 0, i = 0; y < ny; ++y) {
+        for (uint32_t x = 0; x < nx; ++x, ++i) {
+            xs[i] = (float(x) + rng.next_float()) * dx;
+            ys[i] = (float(y) + rng.next_float()) * dy;
+        }
+    }
+}
+
+
+void math::misc::uniform_2d(pcg32& rng, size_t count, float* xs, float* ys)
+{
+    for (size_t i = 0; i < count; ++i) {
+        xs[i] = rng.next_float();
+        ys[i] = rng.next_float();
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <math/misc/random.hpp>
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace math::misc
+{
+    // bulk generators of 2d sample points in [0, 1)^2.
+    // points are written as separate x and y lanes, loops are branch free so compiler can vectorize them.
+
+    inline uint32_t reverse_bits(uint32_t v)
+    {
+        v = (v << 16u) | (v >> 16u);
+        v = ((v & 0x00ff00ffu) << 8u) | ((v & 0xff00ff00u) >> 8u);
+        v = ((v & 0x0f0f0f0fu) << 4u) | ((v & 0xf0f0f0f0u) >> 4u);
+        v = ((v & 0x33333333u) << 2u) | ((v & 0xccccccccu) >> 2u);
+        v = ((v & 0x55555555u) << 1u) | ((v & 0xaaaaaaaau) >> 1u);
+        return v;
+    }
+
+    // 0.32 fixed point to [0, 1).
+    inline float fixed_to_float(uint32_t v)
+    {
+        return float(v >> 8u) * 0x1p-24f;
+    }
+
+    // first dimension of sobol sequence, van der corput in base 2.
+    inline uint32_t sobol_x(uint32_t index)
+    {
+        return reverse_bits(index);
+    }
+
+    // second dimension of sobol sequence, direction numbers are v[i + 1] = v[i] ^ (v[i] >> 1).
+    inline uint32_t sobol_y(uint32_t index)
+    {
+        uint32_t res = 0;
+        for (uint32_t v = 1u << 31u; index != 0; index >>= 1u, v ^= v >> 1u) {
+            res ^= v & (0u - (index & 1u));
+        }
+        return res;
+    }
+
+    inline float radical_inverse(uint32_t index, uint32_t base)
+    {
+        const auto inv_base = 1.f / float(base);
+        auto inv = inv_base;
+        float res = 0.f;
+
+        for (; index != 0; index /= base, inv *= inv_base) {
+            res += float(index % base) * inv;
+        }
+
+        return res < 1.f ? res : 0x1.fffffep-1f;
+    }
+
+    // sobol (0, 2) points [first, first + count). scrambles are xor-ed into points bits,
+    // random scrambles decorrelate pixels and keep points stratification.
+    void sobol_2d(uint32_t first, size_t count, uint32_t scramble_x, uint32_t scramble_y, float* xs, float* ys);
+
+    // halton points of bases 2 and 3 [first, first + count) shifted by offset modulo 1.
+    void halton_2d(uint32_t first, size_t count, float offset_x, float offset_y, float* xs, float* ys);
+
+    // one jittered point per cell of nx * ny grid, cell i is (i % nx, i / nx).
+    void stratified_2d(pcg32& rng, uint32_t nx, uint32_t ny, float* xs, float* ys);
+
+    void uniform_2d(pcg32& rng, size_t count, float* xs, float* ys);
+} // namespace math::misc
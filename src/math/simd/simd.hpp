@@ -0,0 +1,442 @@
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+
+#if !defined(MATH_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define MATH_SIMD_SSE 1
+    #include <immintrin.h>
+    #if defined(__AVX__)
+        #define MATH_SIMD_AVX 1
+    #endif
+#endif
+
+// low level 4-wide float kernels behind math::mat<4, 4, float> operations and math::soa batches.
+// every kernel keeps the operations order of the generic templates from matrix.hpp,
+// so results are bitwise equal to the scalar path (inverse is the only exception, see below).
+namespace math::simd
+{
+#ifdef MATH_SIMD_SSE
+    constexpr bool enabled = true;
+
+    using float4 = __m128;
+
+    inline float4 load4(const float* p)
+    {
+        return _mm_loadu_ps(p);
+    }
+
+    inline void store4(float* p, float4 v)
+    {
+        _mm_storeu_ps(p, v);
+    }
+
+    inline float4 splat(float v)
+    {
+        return _mm_set1_ps(v);
+    }
+
+    inline float4 add(float4 l, float4 r)
+    {
+        return _mm_add_ps(l, r);
+    }
+
+    inline float4 sub(float4 l, float4 r)
+    {
+        return _mm_sub_ps(l, r);
+    }
+
+    inline float4 mul(float4 l, float4 r)
+    {
+        return _mm_mul_ps(l, r);
+    }
+
+    inline float4 div(float4 l, float4 r)
+    {
+        return _mm_div_ps(l, r);
+    }
+
+    inline float4 sqrt(float4 v)
+    {
+        return _mm_sqrt_ps(v);
+    }
+
+    inline float4 min(float4 l, float4 r)
+    {
+        return _mm_min_ps(l, r);
+    }
+
+    inline float4 max(float4 l, float4 r)
+    {
+        return _mm_max_ps(l, r);
+    }
+
+    // lane masks, all bits of a lane are set where comparison holds.
+    using mask4 = __m128;
+
+    inline mask4 cmp_lt(float4 l, float4 r)
+    {
+        return _mm_cmplt_ps(l, r);
+    }
+
+    inline mask4 cmp_le(float4 l, float4 r)
+    {
+        return _mm_cmple_ps(l, r);
+    }
+
+    inline mask4 cmp_ge(float4 l, float4 r)
+    {
+        return _mm_cmpge_ps(l, r);
+    }
+
+    inline mask4 mask_and(mask4 l, mask4 r)
+    {
+        return _mm_and_ps(l, r);
+    }
+
+    inline mask4 mask_or(mask4 l, mask4 r)
+    {
+        return _mm_or_ps(l, r);
+    }
+
+    // l & ~r
+    inline mask4 mask_and_not(mask4 l, mask4 r)
+    {
+        return _mm_andnot_ps(r, l);
+    }
+
+    // bit i is set if lane i is.
+    inline int mask_bits(mask4 m)
+    {
+        return _mm_movemask_ps(m);
+    }
+
+    // lanes of l where mask is set, lanes of r elsewhere.
+    inline float4 select(mask4 m, float4 l, float4 r)
+    {
+        return _mm_or_ps(_mm_and_ps(m, l), _mm_andnot_ps(m, r));
+    }
+
+    // res = x * y, row major 4x4.
+    inline void mat4_mul(const float* x, const float* y, float* res)
+    {
+    #ifdef MATH_SIMD_AVX
+        const auto y0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(y + 0));
+        const auto y1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(y + 4));
+        const auto y2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(y + 8));
+        const auto y3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(y + 12));
+
+        for (size_t row = 0; row < 4; row += 2) {
+            const auto x_rows = _mm256_loadu_ps(x + row * 4);
+            auto t = _mm256_mul_ps(_mm256_permute_ps(x_rows, _MM_SHUFFLE(0, 0, 0, 0)), y0);
+            t = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(x_rows, _MM_SHUFFLE(1, 1, 1, 1)), y1), t);
+            t = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(x_rows, _MM_SHUFFLE(2, 2, 2, 2)), y2), t);
+            t = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(x_rows, _MM_SHUFFLE(3, 3, 3, 3)), y3), t);
+            _mm256_storeu_ps(res + row * 4, t);
+        }
+    #else
+        const auto y0 = _mm_loadu_ps(y + 0);
+        const auto y1 = _mm_loadu_ps(y + 4);
+        const auto y2 = _mm_loadu_ps(y + 8);
+        const auto y3 = _mm_loadu_ps(y + 12);
+
+        for (size_t row = 0; row < 4; ++row) {
+            const auto* x_row = x + row * 4;
+            auto t = _mm_mul_ps(_mm_set1_ps(x_row[0]), y0);
+            t = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(x_row[1]), y1), t);
+            t = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(x_row[2]), y2), t);
+            t = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(x_row[3]), y3), t);
+            _mm_storeu_ps(res + row * 4, t);
+        }
+    #endif
+    }
+
+    // rows are linear combination of v components, res = m * v.
+    inline float4 mat4_mul_vec4(const float* m, float4 v)
+    {
+        auto c0 = _mm_loadu_ps(m + 0);
+        auto c1 = _mm_loadu_ps(m + 4);
+        auto c2 = _mm_loadu_ps(m + 8);
+        auto c3 = _mm_loadu_ps(m + 12);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        auto t = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        t = _mm_add_ps(_mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))), t);
+        t = _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))), t);
+        t = _mm_add_ps(_mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))), t);
+        return t;
+    }
+
+    // res = v * m.
+    inline float4 vec4_mul_mat4(float4 v, const float* m)
+    {
+        auto t = _mm_mul_ps(_mm_loadu_ps(m + 0), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        t = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m + 4), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))), t);
+        t = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m + 8), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))), t);
+        t = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m + 12), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))), t);
+        return t;
+    }
+
+    inline void mat4_transpose(const float* m, float* res)
+    {
+        auto r0 = _mm_loadu_ps(m + 0);
+        auto r1 = _mm_loadu_ps(m + 4);
+        auto r2 = _mm_loadu_ps(m + 8);
+        auto r3 = _mm_loadu_ps(m + 12);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(res + 0, r0);
+        _mm_storeu_ps(res + 4, r1);
+        _mm_storeu_ps(res + 8, r2);
+        _mm_storeu_ps(res + 12, r3);
+    }
+
+    namespace detail
+    {
+        template<int X, int Y, int Z, int W>
+        inline __m128 swizzle(__m128 v)
+        {
+            return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        template<int X, int Y, int Z, int W>
+        inline __m128 shuffle(__m128 l, __m128 r)
+        {
+            return _mm_shuffle_ps(l, r, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        // 2x2 row major blocks packed as (m00, m01, m10, m11).
+        inline __m128 mat2_mul(__m128 l, __m128 r)
+        {
+            return _mm_add_ps(
+                _mm_mul_ps(l, swizzle<0, 3, 0, 3>(r)),
+                _mm_mul_ps(swizzle<1, 0, 3, 2>(l), swizzle<2, 1, 2, 1>(r)));
+        }
+
+        // adj(l) * r
+        inline __m128 mat2_adj_mul(__m128 l, __m128 r)
+        {
+            return _mm_sub_ps(
+                _mm_mul_ps(swizzle<3, 3, 0, 0>(l), r),
+                _mm_mul_ps(swizzle<1, 1, 2, 2>(l), swizzle<2, 3, 0, 1>(r)));
+        }
+
+        // l * adj(r)
+        inline __m128 mat2_mul_adj(__m128 l, __m128 r)
+        {
+            return _mm_sub_ps(
+                _mm_mul_ps(l, swizzle<3, 0, 3, 0>(r)),
+                _mm_mul_ps(swizzle<1, 0, 3, 2>(l), swizzle<2, 1, 2, 1>(r)));
+        }
+    } // namespace detail
+
+    // block-wise (2x2 adjugate) inverse. rounding differs from the cofactor expansion
+    // in matrix_operations.hpp, results are equal within float tolerance.
+    inline void mat4_inverse(const float* m, float* res)
+    {
+        const auto r0 = _mm_loadu_ps(m + 0);
+        const auto r1 = _mm_loadu_ps(m + 4);
+        const auto r2 = _mm_loadu_ps(m + 8);
+        const auto r3 = _mm_loadu_ps(m + 12);
+
+        const auto a = _mm_movelh_ps(r0, r1);
+        const auto b = _mm_movehl_ps(r1, r0);
+        const auto c = _mm_movelh_ps(r2, r3);
+        const auto d = _mm_movehl_ps(r3, r2);
+
+        // (|a|, |b|, |c|, |d|)
+        const auto det_sub = _mm_sub_ps(
+            _mm_mul_ps(detail::shuffle<0, 2, 0, 2>(r0, r2), detail::shuffle<1, 3, 1, 3>(r1, r3)),
+            _mm_mul_ps(detail::shuffle<1, 3, 1, 3>(r0, r2), detail::shuffle<0, 2, 0, 2>(r1, r3)));
+
+        const auto det_a = detail::swizzle<0, 0, 0, 0>(det_sub);
+        const auto det_b = detail::swizzle<1, 1, 1, 1>(det_sub);
+        const auto det_c = detail::swizzle<2, 2, 2, 2>(det_sub);
+        const auto det_d = detail::swizzle<3, 3, 3, 3>(det_sub);
+
+        const auto d_c = detail::mat2_adj_mul(d, c);
+        const auto a_b = detail::mat2_adj_mul(a, b);
+
+        auto x = _mm_sub_ps(_mm_mul_ps(det_d, a), detail::mat2_mul(b, d_c));
+        auto w = _mm_sub_ps(_mm_mul_ps(det_a, d), detail::mat2_mul(c, a_b));
+        auto y = _mm_sub_ps(_mm_mul_ps(det_b, c), detail::mat2_mul_adj(d, a_b));
+        auto z = _mm_sub_ps(_mm_mul_ps(det_c, b), detail::mat2_mul_adj(a, d_c));
+
+        auto det_m = _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c));
+
+        auto tr = _mm_mul_ps(a_b, detail::swizzle<0, 2, 1, 3>(d_c));
+        tr = _mm_add_ps(tr, detail::swizzle<2, 3, 0, 1>(tr));
+        tr = _mm_add_ps(tr, detail::swizzle<1, 0, 3, 2>(tr));
+        det_m = _mm_sub_ps(det_m, tr);
+
+        const auto r_det_m = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det_m);
+
+        x = _mm_mul_ps(x, r_det_m);
+        y = _mm_mul_ps(y, r_det_m);
+        z = _mm_mul_ps(z, r_det_m);
+        w = _mm_mul_ps(w, r_det_m);
+
+        _mm_storeu_ps(res + 0, detail::shuffle<3, 1, 3, 1>(x, y));
+        _mm_storeu_ps(res + 4, detail::shuffle<2, 0, 2, 0>(x, y));
+        _mm_storeu_ps(res + 8, detail::shuffle<3, 1, 3, 1>(z, w));
+        _mm_storeu_ps(res + 12, detail::shuffle<2, 0, 2, 0>(z, w));
+    }
+#else
+    constexpr bool enabled = false;
+
+    // portable stand-in with the same interface, never selected by vec/mat operators
+    // (they fall back to the generic templates). math::soa kernels use it as their scalar path.
+    struct float4
+    {
+        float v[4];
+    };
+
+    inline float4 load4(const float* p)
+    {
+        return {p[0], p[1], p[2], p[3]};
+    }
+
+    inline void store4(float* p, float4 v)
+    {
+        for (size_t i = 0; i < 4; ++i) {
+            p[i] = v.v[i];
+        }
+    }
+
+    inline float4 splat(float v)
+    {
+        return {v, v, v, v};
+    }
+
+    template<typename Functional>
+    inline float4 lanewise(float4 l, float4 r, Functional f)
+    {
+        return {f(l.v[0], r.v[0]), f(l.v[1], r.v[1]), f(l.v[2], r.v[2]), f(l.v[3], r.v[3])};
+    }
+
+    inline float4 add(float4 l, float4 r)
+    {
+        return lanewise(l, r, [](float a, float b) { return a + b; });
+    }
+
+    inline float4 sub(float4 l, float4 r)
+    {
+        return lanewise(l, r, [](float a, float b) { return a - b; });
+    }
+
+    inline float4 mul(float4 l, float4 r)
+    {
+        return lanewise(l, r, [](float a, float b) { return a * b; });
+    }
+
+    inline float4 div(float4 l, float4 r)
+    {
+        return lanewise(l, r, [](float a, float b) { return a / b; });
+    }
+
+    inline float4 sqrt(float4 v)
+    {
+        return {std::sqrt(v.v[0]), std::sqrt(v.v[1]), std::sqrt(v.v[2]), std::sqrt(v.v[3])};
+    }
+
+    inline float4 min(float4 l, float4 r)
+    {
+        return lanewise(l, r, [](float a, float b) { return a < b ? a : b; });
+    }
+
+    inline float4 max(float4 l, float4 r)
+    {
+        return lanewise(l, r, [](float a, float b) { return a > b ? a : b; });
+    }
+
+    struct mask4
+    {
+        bool v[4];
+    };
+
+    template<typename Functional>
+    inline mask4 lanewise_mask(float4 l, float4 r, Functional f)
+    {
+        return {f(l.v[0], r.v[0]), f(l.v[1], r.v[1]), f(l.v[2], r.v[2]), f(l.v[3], r.v[3])};
+    }
+
+    inline mask4 cmp_lt(float4 l, float4 r)
+    {
+        return lanewise_mask(l, r, [](float a, float b) { return a < b; });
+    }
+
+    inline mask4 cmp_le(float4 l, float4 r)
+    {
+        return lanewise_mask(l, r, [](float a, float b) { return a <= b; });
+    }
+
+    inline mask4 cmp_ge(float4 l, float4 r)
+    {
+        return lanewise_mask(l, r, [](float a, float b) { return a >= b; });
+    }
+
+    inline mask4 mask_and(mask4 l, mask4 r)
+    {
+        return {l.v[0] && r.v[0], l.v[1] && r.v[1], l.v[2] && r.v[2], l.v[3] && r.v[3]};
+    }
+
+    inline mask4 mask_or(mask4 l, mask4 r)
+    {
+        return {l.v[0] || r.v[0], l.v[1] || r.v[1], l.v[2] || r.v[2], l.v[3] || r.v[3]};
+    }
+
+    inline mask4 mask_and_not(mask4 l, mask4 r)
+    {
+        return {l.v[0] && !r.v[0], l.v[1] && !r.v[1], l.v[2] && !r.v[2], l.v[3] && !r.v[3]};
+    }
+
+    inline int mask_bits(mask4 m)
+    {
+        return int(m.v[0]) | int(m.v[1]) << 1 | int(m.v[2]) << 2 | int(m.v[3]) << 3;
+    }
+
+    inline float4 select(mask4 m, float4 l, float4 r)
+    {
+        return {m.v[0] ? l.v[0] : r.v[0], m.v[1] ? l.v[1] : r.v[1], m.v[2] ? l.v[2] : r.v[2], m.v[3] ? l.v[3] : r.v[3]};
+    }
+
+    inline void mat4_mul(const float* x, const float* y, float* res)
+    {
+        for (size_t row = 0; row < 4; ++row) {
+            for (size_t col = 0; col < 4; ++col) {
+                float t = x[row * 4] * y[col];
+                for (size_t i = 1; i < 4; ++i) {
+                    t = x[row * 4 + i] * y[i * 4 + col] + t;
+                }
+                res[row * 4 + col] = t;
+            }
+        }
+    }
+
+    inline float4 mat4_mul_vec4(const float* m, float4 v)
+    {
+        float4 res;
+        for (size_t row = 0; row < 4; ++row) {
+            float t = m[row * 4] * v.v[0];
+            for (size_t i = 1; i < 4; ++i) {
+                t = m[row * 4 + i] * v.v[i] + t;
+            }
+            res.v[row] = t;
+        }
+        return res;
+    }
+
+    inline float4 vec4_mul_mat4(float4 v, const float* m)
+    {
+        float4 res;
+        for (size_t col = 0; col < 4; ++col) {
+            float t = m[col] * v.v[0];
+            for (size_t i = 1; i < 4; ++i) {
+                t = m[i * 4 + col] * v.v[i] + t;
+            }
+            res.v[col] = t;
+        }
+        return res;
+    }
+
+#endif
+} // namespace math::simd
@@ -0,0 +1,3 @@
+
+
+#include "mat_batch.hpp"
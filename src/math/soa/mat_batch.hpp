@@ -0,0 +1,217 @@
+
+
+#pragma once
+
+#include <math/matrix.hpp>
+#include <math/matrix_operations.hpp>
+#include <math/soa/vec_soa.hpp>
+
+#include <vector>
+
+namespace math::soa
+{
+    // contiguous batch of matrices. batch kernels walk it linearly,
+    // so mat4 products stay in the simd kernels without any per call overhead.
+    template<size_t Rows, size_t Cols, typename DataType>
+    class mat_batch
+    {
+    public:
+        using value_type = mat<Rows, Cols, DataType>;
+
+        mat_batch() = default;
+
+        explicit mat_batch(size_t size)
+            : m_matrices(size)
+        {
+        }
+
+        size_t size() const
+        {
+            return m_matrices.size();
+        }
+
+        bool empty() const
+        {
+            return m_matrices.empty();
+        }
+
+        void resize(size_t size)
+        {
+            m_matrices.resize(size);
+        }
+
+        void reserve(size_t size)
+        {
+            m_matrices.reserve(size);
+        }
+
+        void clear()
+        {
+            m_matrices.clear();
+        }
+
+        void push_back(const value_type& m)
+        {
+            m_matrices.push_back(m);
+        }
+
+        value_type& operator[](size_t i)
+        {
+            ASSERT(i < m_matrices.size());
+            return m_matrices[i];
+        }
+
+        const value_type& operator[](size_t i) const
+        {
+            ASSERT(i < m_matrices.size());
+            return m_matrices[i];
+        }
+
+        value_type* data()
+        {
+            return m_matrices.data();
+        }
+
+        const value_type* data() const
+        {
+            return m_matrices.data();
+        }
+
+        auto begin()
+        {
+            return m_matrices.begin();
+        }
+
+        auto end()
+        {
+            return m_matrices.end();
+        }
+
+        auto begin() const
+        {
+            return m_matrices.begin();
+        }
+
+        auto end() const
+        {
+            return m_matrices.end();
+        }
+
+    private:
+        std::vector<value_type> m_matrices;
+    };
+
+
+    template<size_t Rows, size_t Common, size_t Cols, typename DataType>
+    void mul(const mat<Rows, Common, DataType>& l, const mat_batch<Common, Cols, DataType>& r, mat_batch<Rows, Cols, DataType>& res)
+    {
+        res.resize(r.size());
+        for (size_t i = 0; i < r.size(); ++i) {
+            res[i] = l * r[i];
+        }
+    }
+
+
+    template<size_t Rows, size_t Common, size_t Cols, typename DataType>
+    void mul(const mat_batch<Rows, Common, DataType>& l, const mat<Common, Cols, DataType>& r, mat_batch<Rows, Cols, DataType>& res)
+    {
+        res.resize(l.size());
+        for (size_t i = 0; i < l.size(); ++i) {
+            res[i] = l[i] * r;
+        }
+    }
+
+
+    template<size_t Rows, size_t Common, size_t Cols, typename DataType>
+    void mul(const mat_batch<Rows, Common, DataType>& l, const mat_batch<Common, Cols, DataType>& r, mat_batch<Rows, Cols, DataType>& res)
+    {
+        ASSERT(l.size() == r.size());
+        res.resize(l.size());
+        for (size_t i = 0; i < l.size(); ++i) {
+            res[i] = l[i] * r[i];
+        }
+    }
+
+
+    inline void transpose(const mat_batch<4, 4, float>& m, mat_batch<4, 4, float>& res)
+    {
+        res.resize(m.size());
+        for (size_t i = 0; i < m.size(); ++i) {
+            res[i] = math::transpose(m[i]);
+        }
+    }
+
+
+    inline void inverse(const mat_batch<4, 4, float>& m, mat_batch<4, 4, float>& res)
+    {
+        res.resize(m.size());
+        for (size_t i = 0; i < m.size(); ++i) {
+            res[i] = math::inverse(m[i]);
+        }
+    }
+
+
+    namespace detail
+    {
+        // res[row] = m[row] * (x, y, z, w) for every element, w lane is optional (constant w is passed instead).
+        // accumulation order is the same as in the scalar dot_product: ((x * m0 + y * m1) + z * m2) + w * m3.
+        inline void transform_row(const float* row, const float* x, const float* y, const float* z, const float* w, float w_const, float* res, size_t count)
+        {
+            for_each_chunk<float>(
+                count,
+                [&](auto i) {
+                    auto acc = simd::mul(simd::splat(row[0]), simd::load4(x + i));
+                    acc = simd::add(simd::mul(simd::splat(row[1]), simd::load4(y + i)), acc);
+                    acc = simd::add(simd::mul(simd::splat(row[2]), simd::load4(z + i)), acc);
+                    const auto w4 = w != nullptr ? simd::load4(w + i) : simd::splat(w_const);
+                    simd::store4(res + i, simd::add(simd::mul(simd::splat(row[3]), w4), acc));
+                },
+                [&](size_t i) {
+                    auto acc = row[0] * x[i];
+                    acc = row[1] * y[i] + acc;
+                    acc = row[2] * z[i] + acc;
+                    res[i] = row[3] * (w != nullptr ? w[i] : w_const) + acc;
+                });
+        }
+    } // namespace detail
+
+
+    // res must not alias v.
+    inline void transform(const mat4& m, const vec_soa<4, float>& v, vec_soa<4, float>& res)
+    {
+        ASSERT(&v != &res);
+        res.resize(v.size());
+        for (size_t row = 0; row < 4; ++row) {
+            detail::transform_row(&m[row][0], v.lane(0), v.lane(1), v.lane(2), v.lane(3), 0.f, res.lane(row), v.size());
+        }
+    }
+
+
+    // xyz of m * vec4(p, 1), no perspective divide. res must not alias p.
+    inline void transform_points(const mat4& m, const vec_soa<3, float>& p, vec_soa<3, float>& res)
+    {
+        ASSERT(&p != &res);
+        res.resize(p.size());
+        for (size_t row = 0; row < 3; ++row) {
+            detail::transform_row(&m[row][0], p.lane(0), p.lane(1), p.lane(2), nullptr, 1.f, res.lane(row), p.size());
+        }
+    }
+
+
+    // xyz of m * vec4(v, 0). res must not alias v.
+    inline void transform_vectors(const mat4& m, const vec_soa<3, float>& v, vec_soa<3, float>& res)
+    {
+        ASSERT(&v != &res);
+        res.resize(v.size());
+        for (size_t row = 0; row < 3; ++row) {
+            detail::transform_row(&m[row][0], v.lane(0), v.lane(1), v.lane(2), nullptr, 0.f, res.lane(row), v.size());
+        }
+    }
+} // namespace math::soa
+
+
+namespace math
+{
+    using mat4_batch = soa::mat_batch<4, 4, float>;
+    using mat3_batch = soa::mat_batch<3, 3, float>;
+} // namespace math
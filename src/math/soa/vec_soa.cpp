@@ -0,0 +1,3 @@
+
+
+#include "vec_soa.hpp"
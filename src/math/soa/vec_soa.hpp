@@ -0,0 +1,364 @@
+
+
+#pragma once
+
+#include <math/vector.hpp>
+#include <math/simd/simd.hpp>
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+// structure of arrays containers for batch math.
+// every component lives in its own contiguous lane, so kernels below walk lanes 4 elements at once
+// instead of shuffling xyz(w) of a single vector. per element results keep the operations order
+// of the scalar vec functions from vector.hpp.
+namespace math::soa
+{
+    template<size_t Size, typename DataType>
+    class vec_soa;
+
+    namespace detail
+    {
+        template<size_t Index>
+        struct lane_store
+        {
+            template<size_t Size, typename DataType>
+            inline static void call(vec_soa<Size, DataType>& soa, const vec<Size, DataType>& v, size_t i)
+            {
+                soa.lane(Index)[i] = math::detail::vector_element<Index>::get(v);
+            }
+        };
+
+
+        template<size_t Index>
+        struct lane_load
+        {
+            template<size_t Size, typename DataType>
+            inline static void call(const vec_soa<Size, DataType>& soa, vec<Size, DataType>& v, size_t i)
+            {
+                math::detail::vector_element<Index>::get(v) = soa.lane(Index)[i];
+            }
+        };
+
+
+        template<size_t Index>
+        struct lane_resize
+        {
+            template<size_t Size, typename DataType>
+            inline static void call(std::array<std::vector<DataType>, Size>& lanes, size_t size)
+            {
+                lanes[Index].resize(size);
+            }
+        };
+
+
+        // runs simd_op over 4-wide chunks (float lanes only) and scalar_op over the tail.
+        // simd ops are generic lambdas, so they are never instantiated for non float lanes.
+        template<typename DataType, typename SimdOp, typename ScalarOp>
+        inline void for_each_chunk(size_t count, SimdOp simd_op, ScalarOp scalar_op)
+        {
+            size_t i = 0;
+            if constexpr (std::is_same_v<DataType, float>) {
+                for (; i + 4 <= count; i += 4) {
+                    simd_op(i);
+                }
+            }
+
+            for (; i < count; ++i) {
+                scalar_op(i);
+            }
+        }
+
+
+        template<typename DataType, typename SimdFunc, typename ScalarFunc>
+        inline void lane_transform(const DataType* l, const DataType* r, DataType* res, size_t count, SimdFunc simd_f, ScalarFunc scalar_f)
+        {
+            for_each_chunk<DataType>(
+                count,
+                [&](auto i) {
+                    simd::store4(res + i, simd_f(simd::load4(l + i), simd::load4(r + i)));
+                },
+                [&](size_t i) {
+                    res[i] = scalar_f(l[i], r[i]);
+                });
+        }
+
+
+        template<typename DataType, typename SimdFunc, typename ScalarFunc>
+        inline void lane_transform(const DataType* l, DataType r, DataType* res, size_t count, SimdFunc simd_f, ScalarFunc scalar_f)
+        {
+            for_each_chunk<DataType>(
+                count,
+                [&, r4 = simd::splat(float(r))](auto i) {
+                    simd::store4(res + i, simd_f(simd::load4(l + i), r4));
+                },
+                [&](size_t i) {
+                    res[i] = scalar_f(l[i], r);
+                });
+        }
+
+
+        template<size_t Size, typename DataType, typename SimdFunc, typename ScalarFunc>
+        inline void transform(const vec_soa<Size, DataType>& l, const vec_soa<Size, DataType>& r, vec_soa<Size, DataType>& res, SimdFunc simd_f, ScalarFunc scalar_f)
+        {
+            ASSERT(l.size() == r.size());
+            res.resize(l.size());
+            for (size_t lane = 0; lane < Size; ++lane) {
+                lane_transform(l.lane(lane), r.lane(lane), res.lane(lane), l.size(), simd_f, scalar_f);
+            }
+        }
+
+
+        template<size_t Size, typename DataType, typename SimdFunc, typename ScalarFunc>
+        inline void transform(const vec_soa<Size, DataType>& l, vec<Size, DataType> r, vec_soa<Size, DataType>& res, SimdFunc simd_f, ScalarFunc scalar_f)
+        {
+            res.resize(l.size());
+            const DataType* r_ptr = &r.x;
+            for (size_t lane = 0; lane < Size; ++lane) {
+                lane_transform(l.lane(lane), r_ptr[lane], res.lane(lane), l.size(), simd_f, scalar_f);
+            }
+        }
+
+
+        template<size_t Size, typename DataType, typename SimdFunc, typename ScalarFunc>
+        inline void transform(const vec_soa<Size, DataType>& l, DataType r, vec_soa<Size, DataType>& res, SimdFunc simd_f, ScalarFunc scalar_f)
+        {
+            res.resize(l.size());
+            for (size_t lane = 0; lane < Size; ++lane) {
+                lane_transform(l.lane(lane), r, res.lane(lane), l.size(), simd_f, scalar_f);
+            }
+        }
+
+
+        constexpr auto add4 = [](simd::float4 l, simd::float4 r) { return simd::add(l, r); };
+        constexpr auto sub4 = [](simd::float4 l, simd::float4 r) { return simd::sub(l, r); };
+        constexpr auto mul4 = [](simd::float4 l, simd::float4 r) { return simd::mul(l, r); };
+        constexpr auto div4 = [](simd::float4 l, simd::float4 r) { return simd::div(l, r); };
+    } // namespace detail
+
+
+    template<size_t Size, typename DataType>
+    class vec_soa
+    {
+    public:
+        using value_type = vec<Size, DataType>;
+
+        vec_soa() = default;
+
+        explicit vec_soa(size_t size)
+        {
+            resize(size);
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        void resize(size_t size)
+        {
+            math::detail::for_i<Size - 1>::template call<detail::lane_resize>(m_lanes, size);
+            m_size = size;
+        }
+
+        void reserve(size_t size)
+        {
+            for (auto& lane : m_lanes) {
+                lane.reserve(size);
+            }
+        }
+
+        void clear()
+        {
+            resize(0);
+        }
+
+        void push_back(const value_type& v)
+        {
+            resize(m_size + 1);
+            set(m_size - 1, v);
+        }
+
+        value_type get(size_t i) const
+        {
+            ASSERT(i < m_size);
+            value_type res{};
+            math::detail::for_i<Size - 1>::template call<detail::lane_load>(*this, res, i);
+            return res;
+        }
+
+        void set(size_t i, const value_type& v)
+        {
+            ASSERT(i < m_size);
+            math::detail::for_i<Size - 1>::template call<detail::lane_store>(*this, v, i);
+        }
+
+        DataType* lane(size_t i)
+        {
+            ASSERT(i < Size);
+            return m_lanes[i].data();
+        }
+
+        const DataType* lane(size_t i) const
+        {
+            ASSERT(i < Size);
+            return m_lanes[i].data();
+        }
+
+    private:
+        std::array<std::vector<DataType>, Size> m_lanes{};
+        size_t m_size{0};
+    };
+
+
+    template<size_t Size, typename DataType, typename Rhs>
+    void add(const vec_soa<Size, DataType>& l, const Rhs& r, vec_soa<Size, DataType>& res)
+    {
+        detail::transform(l, r, res, detail::add4, [](DataType a, DataType b) { return a + b; });
+    }
+
+
+    template<size_t Size, typename DataType, typename Rhs>
+    void sub(const vec_soa<Size, DataType>& l, const Rhs& r, vec_soa<Size, DataType>& res)
+    {
+        detail::transform(l, r, res, detail::sub4, [](DataType a, DataType b) { return a - b; });
+    }
+
+
+    template<size_t Size, typename DataType, typename Rhs>
+    void mul(const vec_soa<Size, DataType>& l, const Rhs& r, vec_soa<Size, DataType>& res)
+    {
+        detail::transform(l, r, res, detail::mul4, [](DataType a, DataType b) { return a * b; });
+    }
+
+
+    template<size_t Size, typename DataType, typename Rhs>
+    void div(const vec_soa<Size, DataType>& l, const Rhs& r, vec_soa<Size, DataType>& res)
+    {
+        detail::transform(l, r, res, detail::div4, [](DataType a, DataType b) { return a / b; });
+    }
+
+
+    template<size_t Size, typename DataType>
+    void dot(const vec_soa<Size, DataType>& l, const vec_soa<Size, DataType>& r, std::vector<DataType>& res)
+    {
+        ASSERT(l.size() == r.size());
+        res.resize(l.size());
+
+        detail::for_each_chunk<DataType>(
+            l.size(),
+            [&](auto i) {
+                auto acc = simd::mul(simd::load4(l.lane(0) + i), simd::load4(r.lane(0) + i));
+                for (size_t lane = 1; lane < Size; ++lane) {
+                    acc = simd::add(simd::mul(simd::load4(l.lane(lane) + i), simd::load4(r.lane(lane) + i)), acc);
+                }
+                simd::store4(res.data() + i, acc);
+            },
+            [&](size_t i) {
+                DataType acc = l.lane(0)[i] * r.lane(0)[i];
+                for (size_t lane = 1; lane < Size; ++lane) {
+                    acc = l.lane(lane)[i] * r.lane(lane)[i] + acc;
+                }
+                res[i] = acc;
+            });
+    }
+
+
+    template<size_t Size, typename DataType>
+    void dot(const vec_soa<Size, DataType>& l, vec<Size, DataType> r, std::vector<DataType>& res)
+    {
+        res.resize(l.size());
+        const DataType* r_ptr = &r.x;
+
+        detail::for_each_chunk<DataType>(
+            l.size(),
+            [&](auto i) {
+                auto acc = simd::mul(simd::load4(l.lane(0) + i), simd::splat(r_ptr[0]));
+                for (size_t lane = 1; lane < Size; ++lane) {
+                    acc = simd::add(simd::mul(simd::load4(l.lane(lane) + i), simd::splat(r_ptr[lane])), acc);
+                }
+                simd::store4(res.data() + i, acc);
+            },
+            [&](size_t i) {
+                DataType acc = l.lane(0)[i] * r_ptr[0];
+                for (size_t lane = 1; lane < Size; ++lane) {
+                    acc = l.lane(lane)[i] * r_ptr[lane] + acc;
+                }
+                res[i] = acc;
+            });
+    }
+
+
+    template<typename DataType>
+    void cross(const vec_soa<3, DataType>& l, const vec_soa<3, DataType>& r, vec_soa<3, DataType>& res)
+    {
+        ASSERT(l.size() == r.size());
+        ASSERT(&l != &res && &r != &res);
+        res.resize(l.size());
+
+        const auto* lx = l.lane(0);
+        const auto* ly = l.lane(1);
+        const auto* lz = l.lane(2);
+        const auto* rx = r.lane(0);
+        const auto* ry = r.lane(1);
+        const auto* rz = r.lane(2);
+
+        detail::for_each_chunk<DataType>(
+            l.size(),
+            [&](auto i) {
+                const auto lx4 = simd::load4(lx + i), ly4 = simd::load4(ly + i), lz4 = simd::load4(lz + i);
+                const auto rx4 = simd::load4(rx + i), ry4 = simd::load4(ry + i), rz4 = simd::load4(rz + i);
+                simd::store4(res.lane(0) + i, simd::sub(simd::mul(ly4, rz4), simd::mul(ry4, lz4)));
+                simd::store4(res.lane(1) + i, simd::sub(simd::mul(lz4, rx4), simd::mul(rz4, lx4)));
+                simd::store4(res.lane(2) + i, simd::sub(simd::mul(lx4, ry4), simd::mul(rx4, ly4)));
+            },
+            [&](size_t i) {
+                res.lane(0)[i] = ly[i] * rz[i] - ry[i] * lz[i];
+                res.lane(1)[i] = lz[i] * rx[i] - rz[i] * lx[i];
+                res.lane(2)[i] = lx[i] * ry[i] - rx[i] * ly[i];
+            });
+    }
+
+
+    template<size_t Size, typename DataType>
+    void length(const vec_soa<Size, DataType>& v, std::vector<DataType>& res)
+    {
+        dot(v, v, res);
+        detail::for_each_chunk<DataType>(
+            res.size(),
+            [&](auto i) {
+                simd::store4(res.data() + i, simd::sqrt(simd::load4(res.data() + i)));
+            },
+            [&](size_t i) {
+                res[i] = ::sqrt(res[i]);
+            });
+    }
+
+
+    // res may alias v.
+    template<size_t Size, typename DataType>
+    void normalize(const vec_soa<Size, DataType>& v, vec_soa<Size, DataType>& res)
+    {
+        thread_local std::vector<DataType> lengths;
+        length(v, lengths);
+        res.resize(v.size());
+
+        for (size_t lane = 0; lane < Size; ++lane) {
+            detail::lane_transform(v.lane(lane), lengths.data(), res.lane(lane), v.size(), detail::div4, [](DataType a, DataType b) { return a / b; });
+        }
+    }
+} // namespace math::soa
+
+
+namespace math
+{
+    using vec2_soa = soa::vec_soa<2, float>;
+    using vec3_soa = soa::vec_soa<3, float>;
+    using vec4_soa = soa::vec_soa<4, float>;
+} // namespace math
@@ -0,0 +1,45 @@
+
+
+#pragma once
+
+#include <misc/debug.hpp>
+
+#include <cstdint>
+
+namespace memory
+{
+    // 64-bit handle: slot index in low bits, slot generation in high bits.
+    // generation is bumped every time the slot dies, so stale handles never alias a new object.
+    // 44 generation bits don't wrap within any realistic run, even with per-frame churn of a slot.
+    using handle = uint64_t;
+
+    constexpr static handle null_handle = handle(-1);
+
+    namespace handles
+    {
+        // index width is kept small, sort keys of draw commands pack slot indices.
+        constexpr static uint32_t index_bits = 20;
+        constexpr static uint32_t generation_bits = 64 - index_bits;
+
+        constexpr static uint64_t index_mask = (uint64_t(1) << index_bits) - 1;
+        constexpr static uint64_t generation_mask = (uint64_t(1) << generation_bits) - 1;
+
+        // last index is reserved, null_handle must never be valid.
+        constexpr static uint64_t max_index = index_mask - 1;
+
+        constexpr handle make(uint64_t index, uint64_t generation)
+        {
+            return (generation & generation_mask) << index_bits | (index & index_mask);
+        }
+
+        constexpr uint32_t index(handle h)
+        {
+            return uint32_t(h & index_mask);
+        }
+
+        constexpr uint64_t generation(handle h)
+        {
+            return h >> index_bits;
+        }
+    } // namespace handles
+} // namespace memory
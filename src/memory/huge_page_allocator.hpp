@@ -0,0 +1,73 @@
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace memory
+{
+    // allocator for big pool chunks (e.g. chunked_pool<T, 1 << 16, huge_page_allocator>).
+    // blocks of huge page size and bigger are huge page aligned and advised to the kernel as huge pages,
+    // smaller ones (and every block on platforms without transparent huge pages) come from std::allocator.
+    template<typename T>
+    struct huge_page_allocator
+    {
+        using value_type = T;
+
+        constexpr static size_t huge_page_size = 2 * 1024 * 1024;
+
+        huge_page_allocator() = default;
+
+        template<typename U>
+        huge_page_allocator(const huge_page_allocator<U>&)
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+#if defined(__linux__)
+            const auto bytes = n * sizeof(T);
+            if (bytes >= huge_page_size) {
+                const auto aligned_bytes = (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+                void* ptr = std::aligned_alloc(huge_page_size, aligned_bytes);
+                if (ptr == nullptr) {
+                    throw std::bad_alloc();
+                }
+                madvise(ptr, aligned_bytes, MADV_HUGEPAGE);
+                return static_cast<T*>(ptr);
+            }
+#endif
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* ptr, size_t n)
+        {
+#if defined(__linux__)
+            if (n * sizeof(T) >= huge_page_size) {
+                std::free(ptr);
+                return;
+            }
+#endif
+            std::allocator<T>{}.deallocate(ptr, n);
+        }
+
+        template<typename U>
+        bool operator==(const huge_page_allocator<U>&) const
+        {
+            return true;
+        }
+
+        template<typename U>
+        bool operator!=(const huge_page_allocator<U>&) const
+        {
+            return false;
+        }
+    };
+} // namespace memory
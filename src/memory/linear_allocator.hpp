@@ -0,0 +1,95 @@
+
+
+#pragma once
+
+#include <misc/debug.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace memory
+{
+    // bump allocator over a list of blocks. nothing is freed one by one,
+    // reset() rewinds to the first block and keeps every block for the next round,
+    // so after a warm-up frame recording doesn't touch the heap at all.
+    // not thread safe, every thread is expected to own its allocator.
+    class linear_allocator
+    {
+    public:
+        constexpr static size_t default_block_size = 64 * 1024;
+
+        explicit linear_allocator(size_t block_size = default_block_size)
+            : m_block_size(block_size)
+        {
+        }
+
+        linear_allocator(const linear_allocator&) = delete;
+        linear_allocator& operator=(const linear_allocator&) = delete;
+        linear_allocator(linear_allocator&&) noexcept = default;
+        linear_allocator& operator=(linear_allocator&&) noexcept = default;
+
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+        {
+            ASSERT(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0);
+
+            while (m_current < m_blocks.size()) {
+                auto& b = m_blocks[m_current];
+                const auto offset = (m_offset + alignment - 1) & ~(alignment - 1);
+
+                if (offset + size <= b.size) {
+                    m_offset = offset + size;
+                    return b.data.get() + offset;
+                }
+
+                ++m_current;
+                m_offset = 0;
+            }
+
+            // oversized requests get a block of their own.
+            const auto size_to_alloc = std::max(size, m_block_size);
+            m_blocks.emplace_back(block{.data = std::unique_ptr<std::byte[]>(new std::byte[size_to_alloc]), .size = size_to_alloc});
+            m_current = m_blocks.size() - 1;
+            m_offset = size;
+
+            return m_blocks.back().data.get();
+        }
+
+        template<typename T>
+        T* allocate_array(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "linear allocator never calls destructors.");
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        void reset()
+        {
+            m_current = 0;
+            m_offset = 0;
+        }
+
+        size_t capacity() const
+        {
+            size_t res = 0;
+            for (const auto& b : m_blocks) {
+                res += b.size;
+            }
+            return res;
+        }
+
+    private:
+        struct block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
+
+        std::vector<block> m_blocks;
+        size_t m_current{0};
+        size_t m_offset{0};
+        size_t m_block_size;
+    };
+} // namespace memory
@@ -2,17 +2,144 @@
 
 #pragma once
 
+#include <memory/handle.hpp>
 #include <misc/debug.hpp>
 
 #include <vector>
-#include <deque>
 #include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
 
 namespace memory
 {
-    template<typename ObjectType, template<typename> typename Allocator = std::allocator>
+    // iterates over alive objects only, dead slots are skipped word by word with bit scan.
+    template<typename PoolType, typename ObjectType>
+    class pool_iterator
+    {
+    public:
+        using value_type = std::remove_const_t<ObjectType>;
+        using reference = ObjectType&;
+        using pointer = ObjectType*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        pool_iterator() = default;
+
+        pool_iterator(PoolType* pool, size_t index)
+            : m_pool(pool)
+            , m_index(index)
+        {
+        }
+
+        reference operator*() const
+        {
+            return m_pool->object_at(m_index);
+        }
+
+        pointer operator->() const
+        {
+            return &m_pool->object_at(m_index);
+        }
+
+        pool_iterator& operator++()
+        {
+            m_index = m_pool->next_alive_index(m_index + 1);
+            return *this;
+        }
+
+        pool_iterator operator++(int)
+        {
+            auto copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        // handle of the current object.
+        handle id() const
+        {
+            return m_pool->handle_at(m_index);
+        }
+
+        bool operator==(const pool_iterator& r) const
+        {
+            return m_index == r.m_index;
+        }
+
+        bool operator!=(const pool_iterator& r) const
+        {
+            return m_index != r.m_index;
+        }
+
+    private:
+        PoolType* m_pool{nullptr};
+        size_t m_index{0};
+    };
+
+
+    template<typename Iterator>
+    class objects_range
+    {
+    public:
+        objects_range() = default;
+
+        objects_range(Iterator begin, Iterator end)
+            : m_begin(begin)
+            , m_end(end)
+        {
+        }
+
+        Iterator begin() const
+        {
+            return m_begin;
+        }
+
+        Iterator end() const
+        {
+            return m_end;
+        }
+
+        bool empty() const
+        {
+            return m_begin == m_end;
+        }
+
+    private:
+        Iterator m_begin{};
+        Iterator m_end{};
+    };
+
+
+    // ChunkSize == 0: one contiguous block, doubled (objects are moved) on growth.
+    // ChunkSize > 0: fixed size blocks allocated on demand, objects never move,
+    // so pointers to them stay valid for the whole object lifetime.
+    template<typename ObjectType, template<typename> typename Allocator = std::allocator, size_t ChunkSize = 0>
     class pool
     {
+        static_assert((ChunkSize & (ChunkSize - 1)) == 0, "chunk size must be a power of two.");
+
+        // dead slots keep index of the next dead slot, so free list costs no extra memory.
+        union slot
+        {
+            slot() {}
+            ~slot() {}
+
+            ObjectType object;
+            size_t next_free;
+        };
+
+        constexpr static size_t npos = std::numeric_limits<size_t>::max();
+        constexpr static size_t word_bits = 64;
+        constexpr static bool chunked = ChunkSize != 0;
+        constexpr static size_t chunk_shift = chunked ? std::countr_zero(ChunkSize) : 0;
+
+        template<typename, typename>
+        friend class pool_iterator;
+
     public:
         pool() = default;
 
@@ -24,127 +151,256 @@ namespace memory
         ~pool()
         {
             clear();
-            m_allocator.deallocate(m_data_pointer, m_storage_size);
+
+            if constexpr (chunked) {
+                for (auto chunk : m_chunks) {
+                    m_allocator.deallocate(chunk, ChunkSize);
+                }
+            } else {
+                m_allocator.deallocate(m_data_pointer, m_storage_size);
+            }
         }
 
-        using iterator = ObjectType*;
-        using const_iterator = const ObjectType*;
+        using iterator = pool_iterator<pool, ObjectType>;
+        using const_iterator = pool_iterator<const pool, const ObjectType>;
+        using range = objects_range<iterator>;
+        using const_range = objects_range<const_iterator>;
 
-        ObjectType& operator[](size_t index)
+        // no generation check here, pool_view asserts it.
+        ObjectType& operator[](handle h)
         {
-            return *std::launder(m_data_pointer + index);
+            return object_at(handles::index(h));
         }
 
-        const ObjectType& operator[](size_t index) const
+        const ObjectType& operator[](handle h) const
         {
-            return *std::launder(m_data_pointer + index);
+            return object_at(handles::index(h));
         }
 
         iterator begin()
         {
-            return m_data_pointer;
+            return {this, next_alive_index(0)};
         }
 
         iterator end()
         {
-            return m_data_pointer + m_size;
+            return {this, m_size};
+        }
+
+        const_iterator begin() const
+        {
+            return {this, next_alive_index(0)};
+        }
+
+        const_iterator end() const
+        {
+            return {this, m_size};
+        }
+
+        // alive objects count.
+        size_t size() const
+        {
+            return m_alive_count;
+        }
+
+        // upper bound of slot indices given away so far.
+        size_t ids_bound() const
+        {
+            return m_size;
         }
 
         template<typename... Args>
-        size_t create(Args&&... args) noexcept(std::is_nothrow_move_constructible_v<ObjectType>&& std::is_nothrow_constructible_v<ObjectType, Args...>)
+        handle create(Args&&... args)
         {
-            if (m_free_objects.empty()) {
+            size_t id;
+
+            if (m_free_head == npos) {
                 ASSERT(m_size <= m_storage_size);
+                // handles can't address more slots, checked in release builds too.
+                if (m_size > handles::max_index) {
+                    throw std::length_error("pool is out of handle indices.");
+                }
 
-                if (m_size + 1 >= m_storage_size) {
+                if constexpr (chunked) {
+                    if (m_size == m_storage_size) {
+                        add_chunk();
+                    }
+                } else if (m_size + 1 >= m_storage_size) {
                     reallocate(m_storage_size == 0 ? 10 : m_storage_size * 2);
                 }
 
-                new (m_data_pointer + m_size) ObjectType(std::forward<Args>(args)...);
-                return m_size++;
+                id = m_size;
+                new (&slot_at(id).object) ObjectType(std::forward<Args>(args)...);
+                m_size++;
             } else {
-                const auto id = m_free_objects.back();
-                auto object_ptr = m_data_pointer + id;
-                new (object_ptr) ObjectType(std::forward<Args>(args)...);
-                m_free_objects.pop_back();
-                return id;
+                id = m_free_head;
+                const auto next_free = slot_at(id).next_free;
+                new (&slot_at(id).object) ObjectType(std::forward<Args>(args)...);
+                m_free_head = next_free;
             }
+
+            set_alive(id, true);
+            m_alive_count++;
+
+            return handle_at(id);
         }
 
-        ObjectType* object_ptr(size_t id)
+        // nullptr for dead or stale handles.
+        ObjectType* object_ptr(handle h)
         {
-            return is_id_expired(id) ? nullptr : std::launder(m_data_pointer + id);
+            return is_id_expired(h) ? nullptr : &object_at(handles::index(h));
         }
 
-        void destroy(size_t id) noexcept
+        void destroy(handle h) noexcept
         {
-            if (id >= m_size) {
+            if (is_id_expired(h)) {
                 return;
-            } else {
-                m_free_objects.emplace_back(id);
-                std::launder(m_data_pointer + id)->~ObjectType();
             }
+
+            const auto id = handles::index(h);
+            object_at(id).~ObjectType();
+            push_free(id);
         }
 
-        std::vector<ObjectType*> objects_view()
+        range objects_view()
         {
-            std::vector<ObjectType*> res;
+            return {begin(), end()};
+        }
 
-            res.reserve(m_size);
+        const_range objects_view() const
+        {
+            return {begin(), end()};
+        }
 
-            for (int i = 0; i < m_size; ++i) {
-                if (!is_id_expired(i)) {
-                    res.emplace_back(std::launder(m_data_pointer + i));
+        void reserve(size_t n)
+        {
+            if constexpr (chunked) {
+                while (m_storage_size < n) {
+                    add_chunk();
                 }
+            } else if (n > m_storage_size) {
+                reallocate(n);
+            }
+        }
+
+        void clear()
+        {
+            for (auto id = next_alive_index(0); id < m_size; id = next_alive_index(id + 1)) {
+                object_at(id).~ObjectType();
+                bump_generation(id);
             }
 
-            return res;
+            std::fill(m_alive_bits.begin(), m_alive_bits.end(), 0);
+            m_free_head = npos;
+            m_alive_count = 0;
+            m_size = 0;
         }
 
-        std::vector<const ObjectType*> objects_view() const
+        // true for dead slots and for handles from previous generations of the slot.
+        bool is_id_expired(handle h) const
         {
-            std::vector<ObjectType*> res;
+            const auto id = handles::index(h);
+            return !is_index_alive(id) || m_generations[id] != handles::generation(h);
+        }
 
-            res.reserve(m_size);
+    private:
+        slot& slot_at(size_t index)
+        {
+            if constexpr (chunked) {
+                return m_chunks[index >> chunk_shift][index & (ChunkSize - 1)];
+            } else {
+                return m_data_pointer[index];
+            }
+        }
 
-            for (int i = 0; i < m_size; ++i) {
-                if (!is_id_expired(i)) {
-                    res.emplace_back(std::launder(m_data_pointer + i));
-                }
+        const slot& slot_at(size_t index) const
+        {
+            if constexpr (chunked) {
+                return m_chunks[index >> chunk_shift][index & (ChunkSize - 1)];
+            } else {
+                return m_data_pointer[index];
             }
+        }
 
-            return res;
+        ObjectType& object_at(size_t index)
+        {
+            return *std::launder(&slot_at(index).object);
         }
 
-        void reserve(size_t n)
+        const ObjectType& object_at(size_t index) const
         {
-            if (n > m_storage_size) {
-                reallocate(n);
-            }
+            return *std::launder(&slot_at(index).object);
         }
 
-        void clear()
+        bool is_index_alive(size_t index) const
+        {
+            return index < m_size && (m_alive_bits[index / word_bits] & (uint64_t(1) << (index % word_bits))) != 0;
+        }
+
+        handle handle_at(size_t index) const
+        {
+            return handles::make(index, m_generations[index]);
+        }
+
+        // first alive index >= from, ids_bound() if there is no such.
+        size_t next_alive_index(size_t from) const
         {
-            for (int i = 0; i < m_size; ++i) {
-                if (is_id_expired(i)) {
-                    continue;
+            if (from >= m_size) {
+                return m_size;
+            }
+
+            auto word_index = from / word_bits;
+            auto word = m_alive_bits[word_index] & (~uint64_t(0) << (from % word_bits));
+
+            while (word == 0) {
+                if (++word_index >= m_alive_bits.size()) {
+                    return m_size;
                 }
-                std::launder(m_data_pointer + i)->~ObjectType();
-                m_free_objects.emplace_back(i);
+                word = m_alive_bits[word_index];
             }
 
-            m_size = 0;
+            const auto id = word_index * word_bits + std::countr_zero(word);
+            return id < m_size ? id : m_size;
         }
 
-        bool is_id_expired(size_t id)
+        void bump_generation(size_t id)
         {
-            if (id >= m_size) {
-                return true;
+            m_generations[id] = (m_generations[id] + 1) & handles::generation_mask;
+        }
+
+        void set_alive(size_t id, bool alive)
+        {
+            const auto mask = uint64_t(1) << (id % word_bits);
+            if (alive) {
+                m_alive_bits[id / word_bits] |= mask;
+            } else {
+                m_alive_bits[id / word_bits] &= ~mask;
             }
-            return std::find(m_free_objects.begin(), m_free_objects.end(), id) != m_free_objects.end();
         }
 
-    private:
+        void push_free(size_t id)
+        {
+            bump_generation(id);
+            set_alive(id, false);
+            slot_at(id).next_free = m_free_head;
+            m_free_head = id;
+            m_alive_count--;
+        }
+
+        void resize_slots_metadata(size_t new_storage_size)
+        {
+            m_alive_bits.resize((new_storage_size + word_bits - 1) / word_bits, 0);
+            m_generations.resize(new_storage_size, 0);
+        }
+
+        // O(1) growth, existing chunks are untouched.
+        void add_chunk()
+        {
+            m_chunks.emplace_back(m_allocator.allocate(ChunkSize));
+            m_storage_size += ChunkSize;
+            resize_slots_metadata(m_storage_size);
+        }
+
         void reallocate(size_t new_storage_size) noexcept(std::is_nothrow_move_constructible_v<ObjectType> || std::is_nothrow_copy_constructible_v<ObjectType>)
         {
             if (new_storage_size <= m_storage_size) {
@@ -157,33 +413,67 @@ namespace memory
 
             try {
                 for (; i < m_size; ++i) {
-                    if (is_id_expired(i)) {
+                    if (!is_index_alive(i)) {
+                        ptr[i].next_free = m_data_pointer[i].next_free;
                         continue;
                     }
 
                     if constexpr (std::is_nothrow_move_constructible_v<ObjectType>) {
-                        new (ptr + i) ObjectType(std::move(m_data_pointer[i]));
+                        new (&ptr[i].object) ObjectType(std::move(m_data_pointer[i].object));
                     } else {
-                        new (ptr + i) ObjectType(m_data_pointer[i]);
+                        new (&ptr[i].object) ObjectType(m_data_pointer[i].object);
                     }
                 }
             } catch (...) {
-                for (size_t j; j < i; ++j) {
-                    std::launder(ptr + i)->~ObjectType();
+                for (size_t j = 0; j < i; ++j) {
+                    if (is_index_alive(j)) {
+                        std::launder(&ptr[j].object)->~ObjectType();
+                    }
                 }
                 m_allocator.deallocate(ptr, new_storage_size);
                 throw;
             }
 
+            for (auto id = next_alive_index(0); id < m_size; id = next_alive_index(id + 1)) {
+                object_at(id).~ObjectType();
+            }
+
             m_allocator.deallocate(m_data_pointer, m_storage_size);
             m_data_pointer = ptr;
             m_storage_size = new_storage_size;
+            resize_slots_metadata(new_storage_size);
         }
 
-        Allocator<ObjectType> m_allocator{};
+        Allocator<slot> m_allocator{};
         size_t m_storage_size{0};
         size_t m_size{0};
-        ObjectType* m_data_pointer{nullptr};
-        std::deque<size_t> m_free_objects{};
+        size_t m_alive_count{0};
+        size_t m_free_head{npos};
+        slot* m_data_pointer{nullptr};
+        std::vector<slot*> m_chunks{};
+        std::vector<uint64_t> m_alive_bits{};
+        std::vector<uint64_t> m_generations{};
+    };
+
+
+    template<typename ObjectType, size_t ChunkSize = 256, template<typename> typename Allocator = std::allocator>
+    using chunked_pool = pool<ObjectType, Allocator, ChunkSize>;
+
+
+    // pool used for ObjectType by pool_factory/pool_view.
+    // types with static constexpr size_t pool_chunk_size get chunked_pool with such chunk size.
+    template<typename ObjectType, typename = void>
+    struct pool_traits
+    {
+        using type = pool<ObjectType>;
     };
+
+    template<typename ObjectType>
+    struct pool_traits<ObjectType, std::void_t<decltype(ObjectType::pool_chunk_size)>>
+    {
+        using type = chunked_pool<ObjectType, ObjectType::pool_chunk_size>;
+    };
+
+    template<typename ObjectType>
+    using pool_t = typename pool_traits<ObjectType>::type;
 } // namespace memory
@@ -7,6 +7,7 @@
 #include <misc/debug.hpp>
 
 #include <memory>
+#include <utility>
 
 namespace memory
 {
@@ -14,29 +15,30 @@ namespace memory
     class pool_view
     {
     public:
-        using iterator = ObjectType*;
-        using const_iterator = const ObjectType*;
+        using pool_type = pool_t<ObjectType>;
+        using iterator = typename pool_type::iterator;
+        using const_iterator = typename pool_type::const_iterator;
 
-        explicit pool_view(pool<ObjectType>* pool)
+        explicit pool_view(pool_type* pool)
             : m_pool(pool)
         {
         }
 
-        ObjectType& operator[](size_t i)
+        ObjectType& operator[](handle i)
         {
             ASSERT(m_pool != nullptr);
             ASSERT(!m_pool->is_id_expired(i));
             return m_pool->operator[](i);
         }
 
-        const ObjectType& operator[](size_t i) const
+        const ObjectType& operator[](handle i) const
         {
             ASSERT(m_pool != nullptr);
             ASSERT(!m_pool->is_id_expired(i));
             return m_pool->operator[](i);
         }
 
-        pool<ObjectType>* get_pool()
+        pool_type* get_pool()
         {
             return m_pool;
         }
@@ -46,15 +48,16 @@ namespace memory
             return m_pool != nullptr;
         }
 
+        // alive objects count.
         size_t size() const
         {
-            return m_pool->end() - m_pool->begin();
+            return m_pool == nullptr ? 0 : m_pool->size();
         }
 
         iterator begin()
         {
             if (m_pool == nullptr) {
-                return nullptr;
+                return {};
             } else {
                 return m_pool->begin();
             }
@@ -63,7 +66,7 @@ namespace memory
         iterator end()
         {
             if (m_pool == nullptr) {
-                return nullptr;
+                return {};
             } else {
                 return m_pool->end();
             }
@@ -72,23 +75,23 @@ namespace memory
         const_iterator cbegin() const
         {
             if (m_pool == nullptr) {
-                return nullptr;
+                return {};
             } else {
-                return m_pool->begin();
+                return std::as_const(*m_pool).begin();
             }
         }
 
         const_iterator cend() const
         {
             if (m_pool == nullptr) {
-                return nullptr;
+                return {};
             } else {
-                return m_pool->end();
+                return std::as_const(*m_pool).end();
             }
         }
 
     private:
-        pool<ObjectType>* m_pool;
+        pool_type* m_pool;
     };
 
     template<typename Registrator>
@@ -105,7 +108,7 @@ namespace memory
         }
 
         template<typename ObjectType, typename... Args>
-        size_t create(Args&&... args)
+        handle create(Args&&... args)
         {
             using T = std::remove_reference_t<std::remove_cv_t<ObjectType>>;
             const auto index = get_type_id<T>();
@@ -122,7 +125,7 @@ namespace memory
         }
 
         template<typename ObjectType>
-        void destroy(size_t id)
+        void destroy(handle id)
         {
             auto* pool = get_pool<ObjectType>();
 
@@ -133,7 +136,7 @@ namespace memory
             pool->destroy(id);
         }
 
-        void destroy(size_t type_id, size_t id)
+        void destroy(size_t type_id, handle id)
         {
             if (type_id >= m_pools_list.size()) {
                 return;
@@ -173,7 +176,7 @@ namespace memory
                 return static_cast<pool_wrapper<T>*>(this);
             }
 
-            virtual void destroy(size_t) = 0;
+            virtual void destroy(handle) = 0;
         };
 
         template<typename Object>
@@ -184,16 +187,16 @@ namespace memory
                 return std::make_unique<pool_wrapper>();
             }
 
-            void destroy(size_t id) override
+            void destroy(handle id) override
             {
                 pool.destroy(id);
             }
 
-            pool<Object> pool;
+            pool_t<Object> pool;
         };
 
         template<typename ObjectType>
-        pool<ObjectType>* get_pool() const
+        pool_t<ObjectType>* get_pool() const
         {
             using T = std::remove_reference_t<std::remove_cv_t<ObjectType>>;
             const auto index = misc::type_traits::type_id<pool_factory>::template get<T>();
@@ -0,0 +1,47 @@
+
+
+#include "command_encoder.hpp"
+
+#include <new>
+
+
+renderer::command_encoder::command_encoder()
+    : m_allocator(sizeof(draw_command) * commands_per_block)
+{
+}
+
+
+void renderer::command_encoder::encode_draw_command(const draw_command& command)
+{
+    if (m_blocks.empty() || m_blocks.back().size == commands_per_block) {
+        m_blocks.emplace_back(block{.commands = m_allocator.allocate_array<draw_command>(commands_per_block), .size = 0});
+    }
+
+    auto& b = m_blocks.back();
+    new (b.commands + b.size++) draw_command(command);
+    m_size++;
+}
+
+
+size_t renderer::command_encoder::size() const
+{
+    return m_size;
+}
+
+
+void renderer::command_encoder::append_to(std::vector<draw_command>& dst) const
+{
+    dst.reserve(dst.size() + m_size);
+
+    for (const auto& b : m_blocks) {
+        dst.insert(dst.end(), b.commands, b.commands + b.size);
+    }
+}
+
+
+void renderer::command_encoder::reset()
+{
+    m_allocator.reset();
+    m_blocks.clear();
+    m_size = 0;
+}
@@ -0,0 +1,42 @@
+
+
+#pragma once
+
+#include <renderer/renderer.hpp>
+#include <memory/linear_allocator.hpp>
+
+#include <vector>
+
+namespace renderer
+{
+    // records draw commands of one thread. commands are stored in blocks of own linear allocator,
+    // memory is kept between frames, so steady state recording doesn't allocate.
+    // encoder must not be filled by two threads at once, give every worker its own one.
+    class command_encoder
+    {
+    public:
+        constexpr static size_t commands_per_block = 1024;
+
+        command_encoder();
+
+        void encode_draw_command(const draw_command& command);
+
+        size_t size() const;
+
+        // appends recorded commands to dst in recording order.
+        void append_to(std::vector<draw_command>& dst) const;
+
+        void reset();
+
+    private:
+        struct block
+        {
+            draw_command* commands;
+            size_t size;
+        };
+
+        memory::linear_allocator m_allocator;
+        std::vector<block> m_blocks;
+        size_t m_size{0};
+    };
+} // namespace renderer
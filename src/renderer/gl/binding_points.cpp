@@ -0,0 +1,41 @@
+
+
+#include "binding_points.hpp"
+
+#include <misc/debug.hpp>
+
+#include <stdexcept>
+
+
+GLuint renderer::gl::binding_points::acquire()
+{
+    if (!m_free.empty()) {
+        const auto binding = m_free.back();
+        m_free.pop_back();
+        return binding;
+    }
+
+    if (m_max < 0) {
+        glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &m_max);
+    }
+
+    if (GLint(m_next) >= m_max) {
+        throw std::runtime_error("out of uniform buffer binding points.");
+    }
+
+    return m_next++;
+}
+
+
+void renderer::gl::binding_points::release(GLuint binding)
+{
+    ASSERT(binding < m_next);
+    m_free.emplace_back(binding);
+}
+
+
+void renderer::gl::binding_points::clear()
+{
+    m_free.clear();
+    m_next = 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <vector>
+
+namespace renderer::gl
+{
+    // uniform buffer binding points of parameters lists. there are only GL_MAX_UNIFORM_BUFFER_BINDINGS of them,
+    // released points are reused before new ones are taken.
+    class binding_points
+    {
+    public:
+        // throws when every binding point is taken. limit is queried on the first call, context must be current.
+        GLuint acquire();
+        void release(GLuint binding);
+        void clear();
+
+    private:
+        std::vector<GLuint> m_free;
+        GLuint m_next{0};
+        GLint m_max{-1};
+    };
+} // namespace renderer::gl
@@ -32,6 +32,8 @@ namespace renderer::gl
     class buffer
     {
         friend class renderer;
+        friend class parameters_list;
+        friend class instance_stream;
 
     public:
         explicit buffer(size_t size)
@@ -63,6 +65,28 @@ namespace renderer::gl
             }
         }
 
+        // buffer must be bound. ranges written into the mapping must be flushed before unmap.
+        void* map_range(size_t offset, size_t size, GLbitfield access)
+        {
+            return glMapBufferRange(BufferType, (GLintptr) offset, (GLsizeiptr) size, access);
+        }
+
+        // offset is relative to the mapped range.
+        void flush_range(size_t offset, size_t size)
+        {
+            glFlushMappedBufferRange(BufferType, (GLintptr) offset, (GLsizeiptr) size);
+        }
+
+        void unmap()
+        {
+            glUnmapBuffer(BufferType);
+        }
+
+        size_t size() const
+        {
+            return m_storage_size;
+        }
+
     private:
         raii_storage<detail::buffer_create_policy, detail::buffer_destroy_policy> m_handler;
         size_t m_storage_size;
@@ -0,0 +1,66 @@
+
+
+#include "commands_sort.hpp"
+
+#include <memory/handle.hpp>
+
+#include <array>
+#include <bit>
+
+
+uint64_t renderer::gl::make_sort_key(const ::renderer::shader_state& state, shader_handler shader, mesh_handler mesh, float depth)
+{
+    static_assert(memory::handles::index_bits == 20, "sort key layout expects 20 bit slot indices.");
+
+    const uint64_t state_bits = uint64_t(state.depth_test) << 5 | uint64_t(state.cull) << 3 | uint64_t(state.blend) << 1 | uint64_t(state.color_write);
+
+    // float bits flipped to unsigned order: negatives reversed, positives above them.
+    auto depth_bits = std::bit_cast<uint32_t>(depth);
+    depth_bits = (depth_bits & 0x80000000u) != 0 ? ~depth_bits : depth_bits | 0x80000000u;
+
+    return state_bits << 56
+           | uint64_t(memory::handles::index(shader)) << 36
+           | uint64_t(memory::handles::index(mesh)) << 16
+           | uint64_t(depth_bits >> 16);
+}
+
+
+bool renderer::gl::is_order_independent(const ::renderer::shader_state& state)
+{
+    return state.blend == blend_mode::off && state.depth_write && state.depth_test != depth_test_mode::off;
+}
+
+
+void renderer::gl::radix_sort(std::vector<sort_item>& items, std::vector<sort_item>& scratch)
+{
+    if (items.size() < 2) {
+        return;
+    }
+
+    scratch.resize(items.size());
+
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        std::array<size_t, 256> offsets{};
+
+        for (const auto& item : items) {
+            offsets[(item.key >> shift) & 0xff]++;
+        }
+
+        if (offsets[(items.front().key >> shift) & 0xff] == items.size()) {
+            continue;
+        }
+
+        size_t sum = 0;
+        for (auto& offset : offsets) {
+            const auto count = offset;
+            offset = sum;
+            sum += count;
+        }
+
+        for (const auto& item : items) {
+            scratch[offsets[(item.key >> shift) & 0xff]++] = item;
+        }
+
+        items.swap(scratch);
+    }
+}
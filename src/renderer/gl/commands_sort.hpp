@@ -0,0 +1,29 @@
+
+
+#pragma once
+
+#include <renderer/renderer.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace renderer::gl
+{
+    struct sort_item
+    {
+        uint64_t key;
+        uint32_t command;
+    };
+
+    // key layout, high to low bits:
+    // gpu state (8) | shader slot (20) | mesh slot (20) | depth (16, front to back).
+    // samplers belong to the shader, so draws with the same shader share textures too.
+    uint64_t make_sort_key(const ::renderer::shader_state& state, shader_handler shader, mesh_handler mesh, float depth);
+
+    // opaque draws with depth test and depth write give the same image in any order,
+    // everything else is drawn in submission order.
+    bool is_order_independent(const ::renderer::shader_state& state);
+
+    // stable lsd radix sort by key, 8 bits per pass. passes where every key has the same byte are skipped.
+    void radix_sort(std::vector<sort_item>& items, std::vector<sort_item>& scratch);
+} // namespace renderer::gl
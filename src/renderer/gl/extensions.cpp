@@ -0,0 +1,48 @@
+
+
+#include "extensions.hpp"
+
+#include <cstring>
+
+
+renderer::gl::extensions::multi_draw_elements_indirect_proc renderer::gl::extensions::multi_draw_elements_indirect = nullptr;
+
+
+namespace
+{
+    bool has_extension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+        for (GLint i = 0; i < count; ++i) {
+            const auto* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, GLuint(i)));
+            if (ext != nullptr && std::strcmp(ext, name) == 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    bool has_version(GLint major, GLint minor)
+    {
+        GLint ctx_major = 0;
+        GLint ctx_minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &ctx_major);
+        glGetIntegerv(GL_MINOR_VERSION, &ctx_minor);
+        return ctx_major > major || (ctx_major == major && ctx_minor >= minor);
+    }
+} // namespace
+
+
+void renderer::gl::extensions::load(void* (*get_proc_address)(const char*))
+{
+    multi_draw_elements_indirect = nullptr;
+
+    // multi draw indirect relies on base instance (4.2) to pass draw ids, 4.3 and the extension imply it.
+    if (has_version(4, 3) || (has_extension("GL_ARB_multi_draw_indirect") && has_extension("GL_ARB_base_instance"))) {
+        multi_draw_elements_indirect = reinterpret_cast<multi_draw_elements_indirect_proc>(get_proc_address("glMultiDrawElementsIndirect"));
+    }
+}
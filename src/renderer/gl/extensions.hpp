@@ -0,0 +1,17 @@
+
+
+#pragma once
+
+#include <glad/glad.h>
+
+namespace renderer::gl::extensions
+{
+    // glad is generated for 4.1 core, entry points of newer versions are loaded here.
+    using multi_draw_elements_indirect_proc = void(APIENTRYP)(GLenum mode, GLenum type, const void* indirect, GLsizei draw_count, GLsizei stride);
+
+    // null if driver has neither gl 4.3 nor ARB_multi_draw_indirect.
+    extern multi_draw_elements_indirect_proc multi_draw_elements_indirect;
+
+    // context must be current and glad loaded.
+    void load(void* (*get_proc_address)(const char*));
+} // namespace renderer::gl::extensions
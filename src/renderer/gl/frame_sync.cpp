@@ -0,0 +1,66 @@
+
+
+#include "frame_sync.hpp"
+
+#include <cstdint>
+
+
+namespace
+{
+    void wait_and_delete(GLsync& fence)
+    {
+        if (fence == nullptr) {
+            return;
+        }
+
+        // with three frames in flight the fence is almost always signaled already, first poll is free.
+        auto status = glClientWaitSync(fence, 0, 0);
+
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+} // namespace
+
+
+renderer::gl::frame_sync::~frame_sync()
+{
+    for (auto fence : m_fences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+}
+
+
+size_t renderer::gl::frame_sync::begin_frame()
+{
+    wait_and_delete(m_fences[m_frame]);
+    return m_frame;
+}
+
+
+void renderer::gl::frame_sync::end_frame()
+{
+    m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_frame = (m_frame + 1) % frames_in_flight;
+}
+
+
+size_t renderer::gl::frame_sync::current_frame() const
+{
+    return m_frame;
+}
+
+
+void renderer::gl::frame_sync::clear()
+{
+    for (auto& fence : m_fences) {
+        wait_and_delete(fence);
+    }
+
+    m_frame = 0;
+}
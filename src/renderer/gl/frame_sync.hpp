@@ -0,0 +1,38 @@
+
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+
+namespace renderer::gl
+{
+    // fences of the frames in flight. cpu writes into the ring region of the current frame
+    // only after gpu finished the frame which used that region frames_in_flight frames ago.
+    class frame_sync
+    {
+    public:
+        constexpr static size_t frames_in_flight = 3;
+
+        frame_sync() = default;
+        ~frame_sync();
+
+        frame_sync(const frame_sync&) = delete;
+        frame_sync& operator=(const frame_sync&) = delete;
+
+        // waits (if needed) for the region of the current frame and returns its index.
+        size_t begin_frame();
+        void end_frame();
+
+        size_t current_frame() const;
+
+        // waits for all frames in flight and deletes their fences, context must be still alive.
+        void clear();
+
+    private:
+        std::array<GLsync, frames_in_flight> m_fences{};
+        size_t m_frame{0};
+    };
+} // namespace renderer::gl
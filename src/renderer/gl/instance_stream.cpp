@@ -0,0 +1,87 @@
+
+
+#include "instance_stream.hpp"
+
+#include <renderer/gl/traits.hpp>
+#include <misc/debug.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+
+renderer::gl::instance_stream::instance_stream(const ::renderer::instance_stream_descriptor& descriptor)
+    : m_element_size(traits::get_parameter_size(descriptor.element_type))
+{
+    const auto storage_size = std::max<size_t>(descriptor.elements_count, 1) * m_element_size;
+
+    m_data.resize(storage_size);
+
+    for (size_t i = 0; i < frame_sync::frames_in_flight; ++i) {
+        m_dirty_ranges[i] = {0, storage_size};
+        m_gpu_storages[i].emplace(storage_size);
+    }
+}
+
+
+void renderer::gl::instance_stream::set_data(uint32_t first_element, uint32_t elements_count, const void* data)
+{
+    const auto begin = first_element * m_element_size;
+    const auto size = elements_count * m_element_size;
+
+    ASSERT(begin + size <= m_data.size());
+
+    auto* dst = m_data.data() + begin;
+    const auto* src = static_cast<const uint8_t*>(data);
+
+    // only elements between the first and the last changed ones go to the gpu.
+    size_t first = 0;
+    size_t last = size;
+
+    while (first < last && std::memcmp(dst + first, src + first, m_element_size) == 0) {
+        first += m_element_size;
+    }
+
+    if (first == last) {
+        return;
+    }
+
+    while (std::memcmp(dst + last - m_element_size, src + last - m_element_size, m_element_size) == 0) {
+        last -= m_element_size;
+    }
+
+    std::memcpy(dst + first, src + first, last - first);
+
+    for (auto& range : m_dirty_ranges) {
+        if (range.begin >= range.end) {
+            range = {begin + first, begin + last};
+        } else {
+            range.begin = std::min(range.begin, begin + first);
+            range.end = std::max(range.end, begin + last);
+        }
+    }
+}
+
+
+void renderer::gl::instance_stream::load_data_to_gpu(size_t frame, texture& texture)
+{
+    auto& range = m_dirty_ranges[frame];
+    auto& storage = m_gpu_storages[frame].value();
+
+    if (range.begin < range.end) {
+        bind_guard bind(storage);
+
+        // buffer of this frame isn't used by gpu anymore (see frame_sync), so no implicit sync is needed.
+        auto* mapped = storage.map_range(
+            range.begin,
+            range.end - range.begin,
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+        std::memcpy(mapped, m_data.data() + range.begin, range.end - range.begin);
+        storage.unmap();
+
+        range = {0, 0};
+    }
+
+    bind_guard bind(texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, storage.m_handler);
+}
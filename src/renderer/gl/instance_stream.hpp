@@ -0,0 +1,46 @@
+#pragma once
+
+#include <renderer/gl/buffer.hpp>
+#include <renderer/gl/frame_sync.hpp>
+#include <renderer/gl/texture.hpp>
+#include <renderer/renderer.hpp>
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace renderer::gl
+{
+    // per instance data of any count, shaders read it from samplerBuffer with texelFetch.
+    // storage is a ring of frame_sync::frames_in_flight buffers, every frame only the range
+    // changed during the last frames_in_flight frames is written into the buffer of the current frame,
+    // then that buffer is attached to the buffer texture.
+    class instance_stream
+    {
+        friend class renderer;
+
+    public:
+        explicit instance_stream(const ::renderer::instance_stream_descriptor&);
+        void set_data(uint32_t first_element, uint32_t elements_count, const void* data);
+        void load_data_to_gpu(size_t frame, texture& texture);
+
+    private:
+        using texel_buffer = buffer<GL_TEXTURE_BUFFER, false>;
+
+        // bytes range, empty if begin >= end.
+        struct dirty_range
+        {
+            size_t begin;
+            size_t end;
+        };
+
+        size_t m_element_size;
+        std::vector<uint8_t> m_data;
+
+        std::array<dirty_range, frame_sync::frames_in_flight> m_dirty_ranges;
+        std::array<std::optional<texel_buffer>, frame_sync::frames_in_flight> m_gpu_storages;
+
+        // buffer texture in the textures pool, shaders sample it as any other texture.
+        texture_handler m_texture{::renderer::null};
+    };
+} // namespace renderer::gl
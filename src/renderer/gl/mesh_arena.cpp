@@ -0,0 +1,334 @@
+
+
+#include "mesh_arena.hpp"
+
+#include <renderer/gl/extensions.hpp>
+#include <renderer/gl/traits.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+
+namespace
+{
+    constexpr size_t min_vertices_capacity = 16 * 1024;
+    constexpr size_t min_indices_capacity = 64 * 1024;
+
+    // every instance of a multi draw command reads draw id at base instance.
+    constexpr GLuint draw_id_divisor = GLuint(1) << 30;
+
+
+    void copy_buffer(GLuint src, GLuint dst, size_t size)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, src);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, dst);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, GLsizeiptr(size));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+
+    void upload(GLuint buffer, size_t offset, const void* data, size_t size)
+    {
+        // copy write target doesn't touch vao state.
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(offset), GLsizeiptr(size), data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+} // namespace
+
+
+size_t renderer::gl::range_allocator::allocate(size_t size)
+{
+    for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+        if (it->second < size) {
+            continue;
+        }
+
+        const auto offset = it->first;
+        const auto rest = it->second - size;
+        m_free.erase(it);
+
+        if (rest > 0) {
+            m_free.emplace(offset + size, rest);
+        }
+
+        return offset;
+    }
+
+    return npos;
+}
+
+
+void renderer::gl::range_allocator::free(size_t offset, size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+
+    auto next = m_free.lower_bound(offset);
+
+    if (next != m_free.end() && offset + size == next->first) {
+        size += next->second;
+        next = m_free.erase(next);
+    }
+
+    if (next != m_free.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            return;
+        }
+    }
+
+    m_free.emplace(offset, size);
+}
+
+
+void renderer::gl::range_allocator::grow(size_t new_capacity)
+{
+    ASSERT(new_capacity >= m_capacity);
+    free(m_capacity, new_capacity - m_capacity);
+    m_capacity = new_capacity;
+}
+
+
+size_t renderer::gl::range_allocator::capacity() const
+{
+    return m_capacity;
+}
+
+
+renderer::gl::mesh_arena::allocation::allocation(mesh_arena* arena, range r)
+    : m_arena(arena)
+    , m_range(r)
+{
+}
+
+
+renderer::gl::mesh_arena::allocation::~allocation()
+{
+    if (m_arena != nullptr) {
+        m_arena->free(m_range);
+    }
+}
+
+
+renderer::gl::mesh_arena::allocation::allocation(allocation&& src) noexcept
+    : m_arena(src.m_arena)
+    , m_range(src.m_range)
+{
+    src.m_arena = nullptr;
+}
+
+
+renderer::gl::mesh_arena::allocation& renderer::gl::mesh_arena::allocation::operator=(allocation&& src) noexcept
+{
+    if (this != &src) {
+        if (m_arena != nullptr) {
+            m_arena->free(m_range);
+        }
+
+        m_arena = src.m_arena;
+        m_range = src.m_range;
+        src.m_arena = nullptr;
+    }
+
+    return *this;
+}
+
+
+renderer::gl::mesh_arena& renderer::gl::mesh_arena::allocation::get_arena() const
+{
+    return *m_arena;
+}
+
+
+const renderer::gl::mesh_arena::range& renderer::gl::mesh_arena::allocation::get_range() const
+{
+    return m_range;
+}
+
+
+renderer::gl::mesh_arena::mesh_arena(const std::vector<vertex_attribute>& attributes, GLenum topology)
+    : m_attributes(attributes)
+    , m_topology(topology)
+{
+    for (const auto& attr : m_attributes) {
+        m_stride += traits::get_gl_type(attr.data_type).type_size * attr.elements_count;
+    }
+
+    grow(m_vertices_buffer, m_vertices, m_stride, min_vertices_capacity);
+    grow(m_indices_buffer, m_indices, sizeof(uint32_t), min_indices_capacity);
+    reserve_draw_ids(1);
+}
+
+
+bool renderer::gl::mesh_arena::is_compatible(const mesh_layout_descriptor& descriptor) const
+{
+    if (traits::get_gl_geom_topology(descriptor.topology, descriptor.adjacent) != m_topology) {
+        return false;
+    }
+
+    return std::equal(
+        m_attributes.begin(), m_attributes.end(),
+        descriptor.vertex_attributes.begin(), descriptor.vertex_attributes.end(),
+        [](const auto& l, const auto& r) {
+            return l.data_type == r.data_type && l.elements_count == r.elements_count;
+        });
+}
+
+
+renderer::gl::mesh_arena::allocation renderer::gl::mesh_arena::allocate(const mesh_layout_descriptor& descriptor)
+{
+    ASSERT(is_compatible(descriptor));
+
+    const auto vertices_count = descriptor.vertex_data.size() / m_stride;
+
+    std::vector<uint32_t> indices;
+
+    if (descriptor.index_data.empty()) {
+        indices.resize(vertices_count);
+        std::iota(indices.begin(), indices.end(), 0);
+    } else if (descriptor.indices_data_type == data_type::u16) {
+        indices.resize(descriptor.index_data.size() / sizeof(uint16_t));
+        const auto* src = reinterpret_cast<const uint16_t*>(descriptor.index_data.data());
+        std::copy(src, src + indices.size(), indices.begin());
+    } else {
+        indices.resize(descriptor.index_data.size() / sizeof(uint32_t));
+        std::memcpy(indices.data(), descriptor.index_data.data(), indices.size() * sizeof(uint32_t));
+    }
+
+    auto base_vertex = m_vertices.allocate(vertices_count);
+    if (base_vertex == range_allocator::npos) {
+        grow(m_vertices_buffer, m_vertices, m_stride, m_vertices.capacity() + vertices_count);
+        base_vertex = m_vertices.allocate(vertices_count);
+    }
+
+    auto first_index = m_indices.allocate(indices.size());
+    if (first_index == range_allocator::npos) {
+        grow(m_indices_buffer, m_indices, sizeof(uint32_t), m_indices.capacity() + indices.size());
+        first_index = m_indices.allocate(indices.size());
+    }
+
+    upload(m_vertices_buffer, base_vertex * m_stride, descriptor.vertex_data.data(), vertices_count * m_stride);
+    upload(m_indices_buffer, first_index * sizeof(uint32_t), indices.data(), indices.size() * sizeof(uint32_t));
+
+    return allocation{
+        this,
+        range{
+            .base_vertex = uint32_t(base_vertex),
+            .vertices_count = uint32_t(vertices_count),
+            .first_index = uint32_t(first_index),
+            .indices_count = uint32_t(indices.size())}};
+}
+
+
+bool renderer::gl::mesh_arena::reserve_draw_ids(uint32_t count)
+{
+    if (count <= m_draw_ids_count) {
+        return false;
+    }
+
+    const auto new_count = std::max(count, m_draw_ids_count * 2);
+
+    std::vector<uint32_t> ids(new_count);
+    std::iota(ids.begin(), ids.end(), 0);
+
+    buffer_handler buffer;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(ids.size() * sizeof(uint32_t)), ids.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    m_draw_ids_buffer = std::move(buffer);
+    m_draw_ids_count = new_count;
+
+    setup_vao();
+    return true;
+}
+
+
+GLuint renderer::gl::mesh_arena::get_vao_handler()
+{
+    return m_vao;
+}
+
+
+GLenum renderer::gl::mesh_arena::get_topology() const
+{
+    return m_topology;
+}
+
+
+void renderer::gl::mesh_arena::bind()
+{
+    glBindVertexArray(m_vao);
+}
+
+
+void renderer::gl::mesh_arena::unbind()
+{
+    glBindVertexArray(0);
+}
+
+
+void renderer::gl::mesh_arena::free(const range& r)
+{
+    m_vertices.free(r.base_vertex, r.vertices_count);
+    m_indices.free(r.first_index, r.indices_count);
+}
+
+
+void renderer::gl::mesh_arena::grow(buffer_handler& buffer, range_allocator& allocator, size_t element_size, size_t min_capacity)
+{
+    const auto old_capacity = allocator.capacity();
+    const auto new_capacity = std::max(min_capacity, old_capacity * 2);
+
+    buffer_handler new_buffer;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(new_capacity * element_size), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (old_capacity > 0) {
+        copy_buffer(buffer, new_buffer, old_capacity * element_size);
+    }
+
+    buffer = std::move(new_buffer);
+    allocator.grow(new_capacity);
+
+    if (m_draw_ids_count > 0) {
+        setup_vao();
+    }
+}
+
+
+void renderer::gl::mesh_arena::setup_vao()
+{
+    bind_guard bind(*this);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertices_buffer);
+
+    size_t offset = 0;
+
+    for (GLuint i = 0; i < m_attributes.size(); ++i) {
+        const auto& attr = m_attributes[i];
+        auto gl_type = traits::get_gl_type(attr.data_type);
+        glEnableVertexAttribArray(i);
+        glVertexAttribPointer(i, attr.elements_count, gl_type.gl_format, GL_FALSE, GLsizei(m_stride), (void*) offset);
+        offset += gl_type.type_size * attr.elements_count;
+    }
+
+    // without multi draw indirect the renderer sets draw id as constant attribute value before each draw.
+    if (extensions::multi_draw_elements_indirect != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_draw_ids_buffer);
+        glEnableVertexAttribArray(draw_id_attribute_location);
+        glVertexAttribIPointer(draw_id_attribute_location, 1, GL_UNSIGNED_INT, 0, nullptr);
+        glVertexAttribDivisor(draw_id_attribute_location, draw_id_divisor);
+    } else {
+        glDisableVertexAttribArray(draw_id_attribute_location);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices_buffer);
+}
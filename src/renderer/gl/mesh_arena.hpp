@@ -0,0 +1,110 @@
+
+
+#pragma once
+
+#include <renderer/renderer.hpp>
+#include <renderer/gl/buffer.hpp>
+#include <renderer/gl/raii_storage.hpp>
+#include <renderer/gl/vao.hpp>
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace renderer::gl
+{
+    // first fit allocator of [0, capacity) ranges, freed neighbours are merged back.
+    class range_allocator
+    {
+    public:
+        constexpr static size_t npos = size_t(-1);
+
+        // npos if there is no free range big enough.
+        size_t allocate(size_t size);
+        void free(size_t offset, size_t size);
+        void grow(size_t new_capacity);
+        size_t capacity() const;
+
+    private:
+        // offset -> size.
+        std::map<size_t, size_t> m_free;
+        size_t m_capacity{0};
+    };
+
+
+    // vertex and index buffers shared by all meshes of one vertex layout and topology.
+    // meshes are sub-allocated ranges drawn with base vertex, so all of them use one vao
+    // and one multi draw call can render many of them. indices are always stored as u32.
+    class mesh_arena
+    {
+    public:
+        struct range
+        {
+            uint32_t base_vertex;
+            uint32_t vertices_count;
+            uint32_t first_index;
+            uint32_t indices_count;
+        };
+
+        // returns its ranges to the arena on destruction.
+        class allocation
+        {
+        public:
+            allocation(mesh_arena* arena, range r);
+            ~allocation();
+
+            allocation(const allocation&) = delete;
+            allocation& operator=(const allocation&) = delete;
+            allocation(allocation&&) noexcept;
+            allocation& operator=(allocation&&) noexcept;
+
+            mesh_arena& get_arena() const;
+            const range& get_range() const;
+
+        private:
+            mesh_arena* m_arena;
+            range m_range;
+        };
+
+        mesh_arena(const std::vector<vertex_attribute>& attributes, GLenum topology);
+
+        mesh_arena(const mesh_arena&) = delete;
+        mesh_arena& operator=(const mesh_arena&) = delete;
+
+        bool is_compatible(const mesh_layout_descriptor&) const;
+
+        // uploads mesh data, buffers grow when they are full.
+        allocation allocate(const mesh_layout_descriptor&);
+
+        // makes draw ids buffer hold [0, count), returns true if vao was rebound to a new buffer.
+        bool reserve_draw_ids(uint32_t count);
+
+        GLuint get_vao_handler();
+        GLenum get_topology() const;
+
+        void bind();
+        void unbind();
+
+    private:
+        using buffer_handler = raii_storage<detail::buffer_create_policy, detail::buffer_destroy_policy>;
+
+        void free(const range&);
+        void grow(buffer_handler& buffer, range_allocator& allocator, size_t element_size, size_t min_capacity);
+        void setup_vao();
+
+        raii_storage<detail::vao_create_policy, detail::vao_destroy_policy> m_vao;
+        buffer_handler m_vertices_buffer;
+        buffer_handler m_indices_buffer;
+        buffer_handler m_draw_ids_buffer;
+
+        std::vector<vertex_attribute> m_attributes;
+        size_t m_stride{0};
+        GLenum m_topology;
+
+        range_allocator m_vertices;
+        range_allocator m_indices;
+        uint32_t m_draw_ids_count{0};
+    };
+} // namespace renderer::gl
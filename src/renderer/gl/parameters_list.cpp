@@ -23,24 +23,88 @@ renderer::gl::parameters_list::parameters_list(const ::renderer::parameters_list
     GLint alignment;
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
 
-    storage_size = std::max((GLint(storage_size) + alignment - 1) / alignment, 1) * alignment;
+    // regions are bound with glBindBufferRange, so every region starts at aligned offset.
+    m_region_size = std::max((GLint(storage_size) + alignment - 1) / alignment, 1) * alignment;
 
-    m_parameters_data.resize(storage_size);
-    m_gpu_storage.emplace(storage_size);
+    m_parameters_data.resize(m_region_size);
+    m_stale_regions.resize(m_parameters.size(), frame_sync::frames_in_flight);
+    m_stale_parameters_count = m_parameters.size();
+    m_gpu_storage.emplace(m_region_size * frame_sync::frames_in_flight);
 }
 
 
 void renderer::gl::parameters_list::set_parameter_data(uint32_t parameter_index, void* data)
 {
     const auto& param = m_parameters[parameter_index];
-    std::memcpy(m_parameters_data.data() + param.offset, data, param.size);
+    auto* dst = m_parameters_data.data() + param.offset;
+
+    if (std::memcmp(dst, data, param.size) == 0) {
+        return;
+    }
+
+    std::memcpy(dst, data, param.size);
+
+    if (m_stale_regions[parameter_index] == 0) {
+        m_stale_parameters_count++;
+    }
+
+    m_stale_regions[parameter_index] = frame_sync::frames_in_flight;
 }
 
 
-void renderer::gl::parameters_list::load_data_to_gpu()
+void renderer::gl::parameters_list::load_data_to_gpu(size_t frame)
 {
-    if (m_gpu_storage.has_value()) {
+    if (!m_gpu_storage.has_value()) {
+        return;
+    }
+
+    const auto region_offset = frame * m_region_size;
+
+    if (m_stale_parameters_count > 0) {
+        size_t first = m_parameters.size();
+        size_t last = 0;
+
+        for (size_t i = 0; i < m_parameters.size(); ++i) {
+            if (m_stale_regions[i] > 0) {
+                first = std::min(first, i);
+                last = i;
+            }
+        }
+
+        const auto map_begin = m_parameters[first].offset;
+        const auto map_end = m_parameters[last].offset + m_parameters[last].size;
+
         bind_guard bind(m_gpu_storage.value());
-        m_gpu_storage->load_data(m_parameters_data.data());
+
+        // region of this frame isn't used by gpu anymore (see frame_sync), so no implicit sync is needed.
+        auto* mapped = static_cast<uint8_t*>(m_gpu_storage->map_range(
+            region_offset + map_begin,
+            map_end - map_begin,
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+
+        // adjacent stale parameters are written and flushed as one range.
+        for (size_t i = first; i <= last;) {
+            if (m_stale_regions[i] == 0) {
+                ++i;
+                continue;
+            }
+
+            const auto range_begin = m_parameters[i].offset;
+            size_t range_end = range_begin;
+
+            for (; i <= last && m_stale_regions[i] > 0; ++i) {
+                range_end = m_parameters[i].offset + m_parameters[i].size;
+                if (--m_stale_regions[i] == 0) {
+                    m_stale_parameters_count--;
+                }
+            }
+
+            std::memcpy(mapped + range_begin - map_begin, m_parameters_data.data() + range_begin, range_end - range_begin);
+            m_gpu_storage->flush_range(range_begin - map_begin, range_end - range_begin);
+        }
+
+        m_gpu_storage->unmap();
     }
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, m_binding_index, m_gpu_storage->m_handler, (GLintptr) region_offset, (GLsizeiptr) m_region_size);
 }
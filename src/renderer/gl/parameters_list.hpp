@@ -1,13 +1,14 @@
-
-
-
 #pragma once
 
 #include <renderer/gl/buffer.hpp>
+#include <renderer/gl/frame_sync.hpp>
 #include <renderer/renderer.hpp>
 
 namespace renderer::gl
 {
+    // uniform data lives in a ring of frame_sync::frames_in_flight regions of one buffer.
+    // every frame only parameters changed during the last frames_in_flight frames
+    // are written into the region of the current frame, then the region is bound with glBindBufferRange.
     class parameters_list
     {
         friend class renderer;
@@ -15,7 +16,7 @@ namespace renderer::gl
     public:
         explicit parameters_list(const ::renderer::parameters_list_descriptor&);
         void set_parameter_data(uint32_t parameter_index, void*);
-        void load_data_to_gpu();
+        void load_data_to_gpu(size_t frame);
 
     private:
         struct parameter
@@ -26,6 +27,13 @@ namespace renderer::gl
 
         std::vector<parameter> m_parameters;
         std::vector<uint8_t> m_parameters_data;
+
+        // how many ring regions still hold stale data of the parameter.
+        std::vector<uint8_t> m_stale_regions;
+        size_t m_stale_parameters_count{0};
+
+        size_t m_region_size{0};
+        uint32_t m_binding_index{0};
         std::optional<uniform_buffer> m_gpu_storage;
     };
 } // namespace renderer::gl
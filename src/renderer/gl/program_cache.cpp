@@ -0,0 +1,217 @@
+
+
+#include "program_cache.hpp"
+
+#include <renderer/gl/shader.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+
+namespace
+{
+    constexpr uint32_t cache_file_magic = 0x50524742; // "PRGB"
+
+    struct cache_file_header
+    {
+        uint32_t magic;
+        uint32_t binary_format;
+        uint64_t key;
+        uint64_t binary_size;
+    };
+
+
+    // fnv-1a, stable between runs and platforms unlike std::hash.
+    uint64_t hash(uint64_t h, const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            h ^= bytes[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+
+    std::string get_gl_string(GLenum name)
+    {
+        const auto* str = glGetString(name);
+        return str == nullptr ? std::string{} : reinterpret_cast<const char*>(str);
+    }
+} // namespace
+
+
+renderer::gl::program_cache::program_cache(std::filesystem::path directory)
+    : m_directory(std::move(directory))
+    , m_driver_id(get_gl_string(GL_VENDOR) + "|" + get_gl_string(GL_RENDERER) + "|" + get_gl_string(GL_VERSION))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+}
+
+
+renderer::gl::program_cache::~program_cache()
+{
+    wait();
+}
+
+
+uint64_t renderer::gl::program_cache::make_key(const ::renderer::shader_descriptor& descriptor) const
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    h = hash(h, m_driver_id.data(), m_driver_id.size());
+
+    for (const auto& stage : descriptor.stages) {
+        const auto stage_name = uint32_t(stage.name);
+        h = hash(h, &stage_name, sizeof(stage_name));
+
+        const uint64_t code_size = stage.code.size();
+        h = hash(h, &code_size, sizeof(code_size));
+        h = hash(h, stage.code.data(), stage.code.size());
+    }
+
+    return h;
+}
+
+
+bool renderer::gl::program_cache::load(GLuint program, uint64_t key)
+{
+    const auto path = get_path(key);
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file) {
+        return false;
+    }
+
+    std::error_code ec;
+    const auto file_size = std::filesystem::file_size(path, ec);
+
+    cache_file_header header{};
+    std::vector<char> binary;
+
+    // size from disk is trusted only if file really has that many bytes after the header.
+    if (!ec && file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == cache_file_magic && header.key == key
+        && header.binary_size == file_size - sizeof(header)) {
+        binary.resize(header.binary_size);
+        file.read(binary.data(), std::streamsize(binary.size()));
+    }
+
+    const bool read = file && !binary.empty();
+    file.close();
+
+    if (read) {
+        glProgramBinary(program, header.binary_format, binary.data(), GLsizei(binary.size()));
+
+        GLint link_status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &link_status);
+
+        if (link_status == GL_TRUE) {
+            return true;
+        }
+    }
+
+    // truncated file or binary of another driver build, it would fail every run.
+    std::filesystem::remove(path, ec);
+    return false;
+}
+
+
+void renderer::gl::program_cache::store(GLuint program, uint64_t key)
+{
+    GLint binary_size = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+
+    if (binary_size <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(binary_size);
+    GLenum binary_format = 0;
+    glGetProgramBinary(program, binary_size, nullptr, &binary_format, binary.data());
+
+    const cache_file_header header{
+        .magic = cache_file_magic,
+        .binary_format = binary_format,
+        .key = key,
+        .binary_size = uint64_t(binary_size)};
+
+    // written aside and renamed, so readers never see partially written file.
+    const auto path = get_path(key);
+    auto tmp_path = path;
+    tmp_path += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+    {
+        std::ofstream file{tmp_path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), std::streamsize(binary.size()));
+
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+}
+
+
+void renderer::gl::program_cache::prewarm(std::vector<::renderer::shader_descriptor> descriptors, context_binder worker_context)
+{
+    wait();
+
+    if (!worker_context) {
+        compile_missing(descriptors);
+        return;
+    }
+
+    m_prewarm_thread = std::thread([this, descriptors = std::move(descriptors), worker_context = std::move(worker_context)]() {
+        worker_context(true);
+        compile_missing(descriptors);
+        // programs of this context are deleted already, finish makes sure the driver is done with them.
+        glFinish();
+        worker_context(false);
+    });
+}
+
+
+void renderer::gl::program_cache::wait()
+{
+    if (m_prewarm_thread.joinable()) {
+        m_prewarm_thread.join();
+    }
+}
+
+
+std::filesystem::path renderer::gl::program_cache::get_path(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return m_directory / name;
+}
+
+
+void renderer::gl::program_cache::compile_missing(const std::vector<::renderer::shader_descriptor>& descriptors)
+{
+    for (const auto& descriptor : descriptors) {
+        const auto key = make_key(descriptor);
+
+        std::error_code ec;
+        if (std::filesystem::exists(get_path(key), ec)) {
+            continue;
+        }
+
+        detail::shader_handler program;
+
+        try {
+            shader::link_program(program, descriptor);
+        } catch (const std::runtime_error&) {
+            // broken shader fails again with proper message when it's created for real.
+            continue;
+        }
+
+        store(program, key);
+    }
+}
@@ -0,0 +1,57 @@
+
+
+#pragma once
+
+#include <renderer/renderer.hpp>
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace renderer::gl
+{
+    // on disk cache of linked program binaries. key is a hash of stages sources and of
+    // driver vendor, renderer and version strings, so driver updates invalidate old binaries.
+    // binaries rejected by the driver are removed and the program is compiled from source.
+    class program_cache
+    {
+    public:
+        // makes worker context current (true) or releases it (false) on the calling thread.
+        using context_binder = std::function<void(bool)>;
+
+        // queries driver strings, context must be current.
+        explicit program_cache(std::filesystem::path directory);
+        ~program_cache();
+
+        program_cache(const program_cache&) = delete;
+        program_cache& operator=(const program_cache&) = delete;
+
+        uint64_t make_key(const ::renderer::shader_descriptor&) const;
+
+        // true if program is linked from cached binary.
+        bool load(GLuint program, uint64_t key);
+
+        // program must be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+        void store(GLuint program, uint64_t key);
+
+        // compiles missing programs into the cache on a background thread with shared worker context.
+        // without worker context programs are compiled on the calling thread.
+        void prewarm(std::vector<::renderer::shader_descriptor> descriptors, context_binder worker_context);
+
+        // blocks until prewarm finished.
+        void wait();
+
+    private:
+        std::filesystem::path get_path(uint64_t key) const;
+        void compile_missing(const std::vector<::renderer::shader_descriptor>& descriptors);
+
+        std::filesystem::path m_directory;
+        std::string m_driver_id;
+        std::thread m_prewarm_thread;
+    };
+} // namespace renderer::gl
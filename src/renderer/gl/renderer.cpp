@@ -3,66 +3,285 @@
 #include "renderer.hpp"
 
 #include <misc/opengl.hpp>
+#include <renderer/gl/traits.hpp>
+#include <renderer/gl/extensions.hpp>
+
+#include <algorithm>
+#include <stdexcept>
 
 renderer::mesh_handler renderer::gl::renderer::create_mesh(
     const ::renderer::mesh_layout_descriptor& descriptor)
 {
-    return m_factory.create<vao>(descriptor);
+    if (!descriptor.shared_storage) {
+        return m_factory.create<vao>(descriptor);
+    }
+
+    auto arena = std::find_if(m_mesh_arenas.begin(), m_mesh_arenas.end(), [&descriptor](const auto& a) {
+        return a->is_compatible(descriptor);
+    });
+
+    if (arena == m_mesh_arenas.end()) {
+        m_mesh_arenas.emplace_back(std::make_unique<mesh_arena>(descriptor.vertex_attributes, traits::get_gl_geom_topology(descriptor.topology, descriptor.adjacent)));
+        arena = m_mesh_arenas.end() - 1;
+    }
+
+    return m_factory.create<vao>(descriptor, **arena);
 }
 
 
 renderer::shader_handler renderer::gl::renderer::create_shader(
     const ::renderer::shader_descriptor& descriptor)
 {
-    return m_factory.create<shader>(descriptor);
+    auto handler = m_factory.create<shader>(descriptor, m_program_cache.get());
+    auto& shader = m_factory.view<::renderer::gl::shader>()[handler];
+    auto params_lists_view = m_factory.view<parameters_list>();
+
+    for (const auto& [block_name, params_list_handler] : descriptor.parameters) {
+        shader.set_block_binding(block_name, params_lists_view[params_list_handler].m_binding_index);
+    }
+
+    return handler;
 }
 
 
-void renderer::gl::renderer::draw(
-    ::renderer::mesh_handler mesh_handler,
-    ::renderer::shader_handler shader_handler,
-    uint32_t instances_count,
-    uint32_t draw_id)
+void renderer::gl::renderer::set_program_cache_directory(const std::string& directory)
 {
-    constexpr static ::renderer::shader_state default_state{};
+    if (m_program_cache) {
+        m_program_cache->wait();
+    }
+
+    m_program_cache = std::make_unique<program_cache>(directory);
+}
+
+
+void renderer::gl::renderer::prewarm_shaders(std::vector<::renderer::shader_descriptor> descriptors)
+{
+    if (!m_program_cache) {
+        return;
+    }
+
+    m_program_cache->prewarm(std::move(descriptors), m_worker_context);
+}
+
+
+void renderer::gl::renderer::set_worker_context(program_cache::context_binder binder)
+{
+    m_worker_context = std::move(binder);
+}
+
 
+renderer::gl::shader& renderer::gl::renderer::use_shader(::renderer::shader_handler shader_handler, uint32_t draw_id)
+{
     auto shader_view = m_factory.view<shader>();
     auto& shader = shader_view[shader_handler];
 
-    auto& shader_samplers = shader.m_samplers;
+    if (m_bound_shader != shader_handler) {
+        shader.bind();
+        m_bound_shader = shader_handler;
+    }
 
-    bind_guard shader_bind(shader);
+    auto textures_view = m_factory.view<texture>();
 
-    uint32_t sampler_index = 0;
+    for (uint32_t unit = 0; unit < shader.m_samplers.size(); ++unit) {
+        const auto texture_handler = shader.m_samplers[unit].texture;
 
-    auto textures_view = m_factory.view<texture>();
+        if (texture_handler == ::renderer::null) {
+            continue;
+        }
 
-    for (const auto& [sampler_name, texture_index] : shader_samplers) {
-        glActiveTexture(GL_TEXTURE0 + sampler_index++);
-        textures_view[texture_index].bind();
+        if (m_bound_textures.size() <= unit) {
+            m_bound_textures.resize(unit + 1, ::renderer::null);
+        }
+
+        if (m_bound_textures[unit] != texture_handler) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            textures_view[texture_handler].bind();
+            m_bound_textures[unit] = texture_handler;
+        }
     }
 
-    auto loc = glGetUniformLocation(shader.m_handler, "DrawID");
-    if (loc >= 0) {
-        glUniform1i(loc, draw_id);
+    // uniform values live in the program, so cached value stays valid between frames.
+    if (shader.m_draw_id_location >= 0 && shader.m_draw_id != draw_id) {
+        glUniform1i(shader.m_draw_id_location, draw_id);
+        shader.m_draw_id = draw_id;
     }
 
     set_gpu_state(shader.m_state);
 
+    return shader;
+}
+
+
+void renderer::gl::renderer::bind_mesh(vao& mesh)
+{
+    const auto handler = mesh.get_handler();
+
+    if (m_bound_vao != handler) {
+        mesh.bind();
+        m_bound_vao = handler;
+    }
+}
+
+
+void renderer::gl::renderer::draw(
+    ::renderer::mesh_handler mesh_handler,
+    ::renderer::shader_handler shader_handler,
+    uint32_t instances_count,
+    uint32_t draw_id)
+{
     auto mesh_view = m_factory.view<vao>();
+    auto& mesh = mesh_view[mesh_handler];
+
+    // with multi draw indirect shared storage vaos read draw id from base instance, draw is a batch of one.
+    if (mesh.get_arena() != nullptr && extensions::multi_draw_elements_indirect != nullptr) {
+        const ::renderer::draw_command command{.mesh = mesh_handler, .shader = shader_handler, .instances_count = instances_count, .draw_id = draw_id};
+        multi_draw(&command, 1);
+        return;
+    }
+
+    use_shader(shader_handler, draw_id);
+    bind_mesh(mesh);
+
+    if (mesh.get_arena() != nullptr) {
+        glVertexAttribI1ui(draw_id_attribute_location, draw_id);
+    }
 
     if (instances_count == 1) {
-        mesh_view[mesh_handler].draw();
+        mesh.draw();
     } else {
-        mesh_view[mesh_handler].draw_instanced(instances_count);
+        mesh.draw_instanced(instances_count);
     }
+}
 
-    set_gpu_state(default_state);
+
+void renderer::gl::renderer::multi_draw(const ::renderer::draw_command* commands, size_t count)
+{
+    auto mesh_view = m_factory.view<vao>();
+    auto* arena = mesh_view[commands[0].mesh].get_arena();
+
+    if (arena == nullptr || extensions::multi_draw_elements_indirect == nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            draw(commands[i].mesh, commands[i].shader, commands[i].instances_count, commands[i].draw_id);
+        }
+        return;
+    }
+
+    use_shader(commands[0].shader, commands[0].draw_id);
+
+    m_indirect_commands.clear();
+    uint32_t max_draw_id = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        auto& mesh = mesh_view[commands[i].mesh];
+        ASSERT(mesh.get_arena() == arena);
+
+        m_indirect_commands.emplace_back(indirect_command{
+            .count = mesh.get_indices_count(),
+            .instance_count = commands[i].instances_count,
+            .first_index = mesh.get_first_index(),
+            .base_vertex = mesh.get_base_vertex(),
+            .base_instance = commands[i].draw_id});
+
+        max_draw_id = std::max(max_draw_id, commands[i].draw_id);
+    }
+
+    if (arena->reserve_draw_ids(max_draw_id + 1)) {
+        m_bound_vao = 0;
+    }
+
+    if (m_bound_vao != arena->get_vao_handler()) {
+        arena->bind();
+        m_bound_vao = arena->get_vao_handler();
+    }
+
+    if (!m_indirect_buffer) {
+        m_indirect_buffer.emplace();
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, *m_indirect_buffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, GLsizeiptr(m_indirect_commands.size() * sizeof(indirect_command)), m_indirect_commands.data(), GL_STREAM_DRAW);
+
+    const auto topology = arena->get_topology();
+
+    if (topology == GL_POINTS) {
+        glEnable(GL_PROGRAM_POINT_SIZE);
+    }
+
+    extensions::multi_draw_elements_indirect(topology, GL_UNSIGNED_INT, nullptr, GLsizei(m_indirect_commands.size()), 0);
+
+    if (topology == GL_POINTS) {
+        glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+
+uint32_t renderer::gl::renderer::get_batch_key(const ::renderer::draw_command& command)
+{
+    if (command.type == draw_command_type::multi_draw) {
+        auto* arena = m_factory.view<vao>()[command.mesh].get_arena();
+
+        if (arena != nullptr) {
+            // high bit keeps arenas apart from mesh slots, multi draws of one arena become adjacent.
+            const auto it = std::find_if(m_mesh_arenas.begin(), m_mesh_arenas.end(), [arena](const auto& a) {
+                return a.get() == arena;
+            });
+            return uint32_t(1) << (memory::handles::index_bits - 1) | uint32_t(it - m_mesh_arenas.begin());
+        }
+    }
+
+    return memory::handles::index(command.mesh);
+}
+
+
+void renderer::gl::renderer::sort_commands()
+{
+    m_commands_order.clear();
+    m_sort_items.clear();
+
+    auto flush_sorted = [this]() {
+        radix_sort(m_sort_items, m_sort_scratch);
+        for (const auto& item : m_sort_items) {
+            m_commands_order.emplace_back(item.command);
+        }
+        m_sort_items.clear();
+    };
+
+    auto shader_view = m_factory.view<shader>();
+
+    for (uint32_t i = 0; i < m_commands_buffer.size(); ++i) {
+        const auto& command = m_commands_buffer[i];
+
+        if (command.type == draw_command_type::draw || command.type == draw_command_type::multi_draw) {
+            const auto& state = shader_view[command.shader].m_state;
+            if (is_order_independent(state)) {
+                m_sort_items.emplace_back(sort_item{make_sort_key(state, command.shader, get_batch_key(command), command.depth), i});
+                continue;
+            }
+        }
+
+        flush_sorted();
+        m_commands_order.emplace_back(i);
+    }
+
+    flush_sorted();
+}
+
+
+void renderer::gl::renderer::reset_bindings_cache()
+{
+    m_bound_shader = ::renderer::null;
+    m_bound_vao = 0;
+    m_bound_textures.clear();
+    m_gpu_state.reset();
 }
 
 
 void renderer::gl::renderer::update(float time)
 {
+    constexpr static ::renderer::shader_state default_state{};
+
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
     GLint main_fb;
@@ -73,20 +292,41 @@ void renderer::gl::renderer::update(float time)
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     auto params_list_view = m_factory.view<parameters_list>();
-    auto params_lists_impl = params_list_view.get_pool()->objects_view();
 
-    for (auto& params_list : params_lists_impl) {
-        params_list->load_data_to_gpu();
+    const auto frame = m_frame_sync.begin_frame();
+
+    for (auto& params_list : params_list_view) {
+        params_list.load_data_to_gpu(frame);
+    }
+
+    auto textures_view = m_factory.view<texture>();
+
+    for (auto& stream : m_factory.view<instance_stream>()) {
+        stream.load_data_to_gpu(frame, textures_view[stream.m_texture]);
     }
 
-    int32_t last_pass = -1;
+    pass_handler last_pass = ::renderer::null;
 
     auto passes_view = m_factory.view<render_pass>();
 
-    for (const auto& command : m_commands_buffer) {
+    for (auto& encoder : m_encoders) {
+        encoder->append_to(m_commands_buffer);
+        encoder->reset();
+    }
+
+    // resources could be created or loaded since the last frame, they leave own bindings.
+    reset_bindings_cache();
+    sort_commands();
+
+    for (size_t order_index = 0; order_index < m_commands_order.size(); ++order_index) {
+        const auto& command = m_commands_buffer[m_commands_order[order_index]];
+
         switch (command.type) {
             case draw_command_type::pass:
-                if (last_pass >= 0) {
+                // pass clears respect depth and color masks.
+                set_gpu_state(default_state);
+
+                if (last_pass != ::renderer::null) {
                     passes_view[last_pass].end();
                 }
                 passes_view[command.pass].begin();
@@ -95,10 +335,34 @@ void renderer::gl::renderer::update(float time)
             case draw_command_type::draw:
                 draw(command.mesh, command.shader, command.instances_count, command.draw_id);
                 break;
+            case draw_command_type::multi_draw: {
+                m_batch.clear();
+                m_batch.emplace_back(command);
+
+                const auto* arena = m_factory.view<vao>()[command.mesh].get_arena();
+
+                while (order_index + 1 < m_commands_order.size()) {
+                    const auto& next = m_commands_buffer[m_commands_order[order_index + 1]];
+
+                    if (next.type != draw_command_type::multi_draw || next.shader != command.shader || arena == nullptr || m_factory.view<vao>()[next.mesh].get_arena() != arena) {
+                        break;
+                    }
+
+                    m_batch.emplace_back(next);
+                    ++order_index;
+                }
+
+                multi_draw(m_batch.data(), m_batch.size());
+                break;
+            }
         }
     }
 
-    if (last_pass >= 0) {
+    set_gpu_state(default_state);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    if (last_pass != ::renderer::null) {
         auto& src_pass = passes_view[last_pass];
         passes_view[last_pass].end();
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, main_fb);
@@ -107,6 +371,7 @@ void renderer::gl::renderer::update(float time)
     }
 
     m_commands_buffer.clear();
+    m_frame_sync.end_frame();
 }
 
 
@@ -122,20 +387,26 @@ void renderer::gl::renderer::set_shader_sampler(
     ::renderer::texture_handler texture_handler,
     const std::string& sampler_name)
 {
-    auto shader_view = m_factory.view<shader>();
+    m_factory.view<shader>()[shader_handler].set_sampler(sampler_name, texture_handler);
+}
 
-    auto& shader = shader_view[shader_handler];
-    shader.m_samplers[sampler_name] = texture_handler;
+
+const renderer::shader_reflection& renderer::gl::renderer::get_shader_reflection(::renderer::shader_handler handler)
+{
+    return m_factory.view<shader>()[handler].get_reflection();
 }
 
 
 ::renderer::parameters_list_handler renderer::gl::renderer::create_parameters_list(const ::renderer::parameters_list_descriptor& descriptor)
 {
-    auto binding_index = m_factory.create<parameters_list>(descriptor);
-    auto& params_list = m_factory.view<parameters_list>()[binding_index];
-    glBindBufferBase(GL_UNIFORM_BUFFER, binding_index, params_list.m_gpu_storage->m_handler);
+    // binding point is taken first, list isn't created when they are over.
+    // the buffer range itself is bound every frame in update.
+    const auto binding = m_uniform_bindings.acquire();
 
-    return binding_index;
+    auto handler = m_factory.create<parameters_list>(descriptor);
+    m_factory.view<parameters_list>()[handler].m_binding_index = binding;
+
+    return handler;
 }
 
 
@@ -145,6 +416,99 @@ void renderer::gl::renderer::set_parameter_data(::renderer::parameters_list_hand
 }
 
 
+bool renderer::gl::renderer::validate_parameters_list(
+    ::renderer::shader_handler shader_handler,
+    const std::string& block_name,
+    ::renderer::parameters_list_handler params_list_handler)
+{
+    const auto& reflection = m_factory.view<shader>()[shader_handler].get_reflection();
+    const auto& params_list = m_factory.view<parameters_list>()[params_list_handler];
+
+    auto block = std::find_if(reflection.blocks.begin(), reflection.blocks.end(), [&block_name](const auto& b) {
+        return b.name == block_name;
+    });
+
+    if (block == reflection.blocks.end()) {
+        return false;
+    }
+
+    // every array element of the block must match one parameter of the list, in order.
+    size_t param_index = 0;
+
+    for (auto uniform_index : block->uniforms) {
+        const auto& uniform = reflection.uniforms[uniform_index];
+        const auto size = traits::get_std140_size(uniform.type, uniform.matrix_stride);
+
+        for (uint32_t element = 0; element < uniform.array_size; ++element, ++param_index) {
+            if (param_index >= params_list.m_parameters.size()) {
+                return false;
+            }
+
+            const auto& param = params_list.m_parameters[param_index];
+            if (param.offset != uniform.offset + element * uniform.array_stride || param.size != size) {
+                return false;
+            }
+        }
+    }
+
+    return param_index == params_list.m_parameters.size();
+}
+
+
+renderer::instance_stream_handler renderer::gl::renderer::create_instance_stream(const ::renderer::instance_stream_descriptor& descriptor)
+{
+    // checked before the stream is allocated, so a failed creation leaves the factory untouched.
+    const auto storage_size = std::max<size_t>(descriptor.elements_count, 1) * traits::get_parameter_size(descriptor.element_type);
+    GLint max_texels;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);
+    if (storage_size / (sizeof(float) * 4) > size_t(max_texels)) {
+        throw std::runtime_error("instance stream exceeds max texture buffer size.");
+    }
+
+    auto handler = m_factory.create<instance_stream>(descriptor);
+
+    m_factory.view<instance_stream>()[handler].m_texture = m_factory.create<texture>(::renderer::texture_descriptor{
+        .pixels_data_type = data_type::f32,
+        .format = texture_format::rgba,
+        .type = texture_type::buffer,
+        .size = {.width = 0, .height = 0},
+        .pixels = {}});
+
+    return handler;
+}
+
+
+void renderer::gl::renderer::set_instance_data(
+    ::renderer::instance_stream_handler handler,
+    uint32_t first_element,
+    uint32_t elements_count,
+    const void* data)
+{
+    m_factory.view<instance_stream>()[handler].set_data(first_element, elements_count, data);
+}
+
+
+void renderer::gl::renderer::set_shader_instance_stream(
+    ::renderer::shader_handler shader_handler,
+    ::renderer::instance_stream_handler stream_handler,
+    const std::string& sampler_name)
+{
+    const auto texture_handler = m_factory.view<instance_stream>()[stream_handler].m_texture;
+    m_factory.view<shader>()[shader_handler].set_sampler(sampler_name, texture_handler);
+}
+
+
+void renderer::gl::renderer::destroy_instance_stream(::renderer::instance_stream_handler handler)
+{
+    if (handler == ::renderer::null) {
+        return;
+    }
+
+    m_factory.destroy<texture>(m_factory.view<instance_stream>()[handler].m_texture);
+    m_factory.destroy<instance_stream>(handler);
+}
+
+
 void renderer::gl::renderer::destroy_mesh(::renderer::mesh_handler handler)
 {
     if (handler == ::renderer::null) {
@@ -181,74 +545,101 @@ void renderer::gl::renderer::destroy_parameters_list(::renderer::parameters_list
         return;
     }
 
+    m_uniform_bindings.release(m_factory.view<parameters_list>()[handler].m_binding_index);
     m_factory.destroy<parameters_list>(handler);
 }
 
 
 void renderer::gl::renderer::encode_draw_command(::renderer::draw_command command)
 {
-    m_commands_buffer.emplace_back(command);
+    get_command_encoder(0).encode_draw_command(command);
+}
+
+
+renderer::command_encoder& renderer::gl::renderer::get_command_encoder(uint32_t index)
+{
+    while (m_encoders.size() <= index) {
+        m_encoders.emplace_back(std::make_unique<command_encoder>());
+    }
+
+    return *m_encoders[index];
 }
 
 
 void renderer::gl::renderer::set_gpu_state(const ::renderer::shader_state& state)
 {
-    switch (state.depth_test) {
-        case depth_test_mode::less:
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_LESS);
-            break;
-        case depth_test_mode::less_eq:
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_LEQUAL);
-            break;
-        case depth_test_mode::greater:
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_GREATER);
-            break;
-        case depth_test_mode::greater_eq:
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_GEQUAL);
-            break;
-        case depth_test_mode::off:
-            glDisable(GL_DEPTH_TEST);
-            break;
-    }
-
-    glDepthMask(state.depth_write);
-    glColorMask(state.color_write, state.color_write, state.color_write, state.color_write);
-
-    switch (state.cull) {
-        case cull_mode::off:
-            glDisable(GL_CULL_FACE);
-            break;
-        case cull_mode::back:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_BACK);
-            break;
-        case cull_mode::front:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_FRONT);
-            break;
-    }
-
-    switch (state.blend) {
-        case blend_mode::off:
-            glDisable(GL_BLEND);
-            break;
-        case blend_mode::alpha:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            break;
-        case blend_mode::add:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_ONE, GL_ONE);
-            break;
-        case blend_mode::multiply:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_DST_COLOR, GL_ZERO);
-            break;
+    // only fields which differ from the current state are sent to the driver.
+    const auto* current = m_gpu_state.has_value() ? &m_gpu_state.value() : nullptr;
+
+    if (current == nullptr || current->depth_test != state.depth_test) {
+        switch (state.depth_test) {
+            case depth_test_mode::less:
+                glEnable(GL_DEPTH_TEST);
+                glDepthFunc(GL_LESS);
+                break;
+            case depth_test_mode::less_eq:
+                glEnable(GL_DEPTH_TEST);
+                glDepthFunc(GL_LEQUAL);
+                break;
+            case depth_test_mode::greater:
+                glEnable(GL_DEPTH_TEST);
+                glDepthFunc(GL_GREATER);
+                break;
+            case depth_test_mode::greater_eq:
+                glEnable(GL_DEPTH_TEST);
+                glDepthFunc(GL_GEQUAL);
+                break;
+            case depth_test_mode::off:
+                glDisable(GL_DEPTH_TEST);
+                break;
+        }
+    }
+
+    if (current == nullptr || current->depth_write != state.depth_write) {
+        glDepthMask(state.depth_write);
     }
+
+    if (current == nullptr || current->color_write != state.color_write) {
+        glColorMask(state.color_write, state.color_write, state.color_write, state.color_write);
+    }
+
+    if (current == nullptr || current->cull != state.cull) {
+        switch (state.cull) {
+            case cull_mode::off:
+                glDisable(GL_CULL_FACE);
+                break;
+            case cull_mode::back:
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_BACK);
+                break;
+            case cull_mode::front:
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_FRONT);
+                break;
+        }
+    }
+
+    if (current == nullptr || current->blend != state.blend) {
+        switch (state.blend) {
+            case blend_mode::off:
+                glDisable(GL_BLEND);
+                break;
+            case blend_mode::alpha:
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                break;
+            case blend_mode::add:
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_ONE, GL_ONE);
+                break;
+            case blend_mode::multiply:
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_DST_COLOR, GL_ZERO);
+                break;
+        }
+    }
+
+    m_gpu_state = state;
 }
 
 
@@ -285,7 +676,31 @@ void renderer::gl::renderer::load_texture_data(
 }
 
 
+void renderer::gl::renderer::load_texture_region(
+    ::renderer::texture_handler handler,
+    ::renderer::texture_size offset,
+    ::renderer::texture_size size,
+    const void* data)
+{
+    m_factory.view<texture>()[handler].load_region(offset, size, data);
+}
+
+
 void renderer::gl::renderer::clear()
 {
+    // worker context dies with the window, prewarm must not outlive it.
+    if (m_program_cache) {
+        m_program_cache->wait();
+    }
+
     m_factory.clear();
+    m_uniform_bindings.clear();
+
+    // gl objects and fences must die while the context is alive, ~renderer runs after it is gone.
+    m_mesh_arenas.clear();
+    m_indirect_buffer.reset();
+    m_frame_sync.clear();
+
+    m_commands_buffer.clear();
+    reset_bindings_cache();
 }
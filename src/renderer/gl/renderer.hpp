@@ -3,17 +3,27 @@
 
 
 #include <renderer/renderer.hpp>
+#include <renderer/command_encoder.hpp>
 #include <renderer/gl/vao.hpp>
 #include <renderer/gl/shader.hpp>
 #include <renderer/gl/texture.hpp>
 #include <renderer/gl/parameters_list.hpp>
+#include <renderer/gl/instance_stream.hpp>
 #include <renderer/gl/render_pass.hpp>
+#include <renderer/gl/frame_sync.hpp>
+#include <renderer/gl/commands_sort.hpp>
+#include <renderer/gl/program_cache.hpp>
+#include <renderer/gl/mesh_arena.hpp>
+#include <renderer/gl/binding_points.hpp>
 #include <memory/pool.hpp>
 #include <memory/pool_factory.hpp>
 
 
 namespace renderer::gl
 {
+    // handlers are pool handles as is.
+    static_assert(std::is_same_v<mesh_handler, memory::handle> && ::renderer::null == memory::null_handle);
+
     class renderer : public ::renderer::renderer
     {
     public:
@@ -22,31 +32,88 @@ namespace renderer::gl
 
         shader_handler create_shader(const shader_descriptor& descriptor) override;
         void set_shader_sampler(shader_handler, texture_handler, const std::string&) override;
+        const shader_reflection& get_shader_reflection(shader_handler) override;
+
+        void set_program_cache_directory(const std::string& directory) override;
+        void prewarm_shaders(std::vector<shader_descriptor> descriptors) override;
+
+        // context sharing objects with the main one, prewarm compiles on it in background.
+        void set_worker_context(program_cache::context_binder binder);
         void destroy_shader(shader_handler handler) override;
 
         texture_handler create_texture(const texture_descriptor& descriptor) override;
         void destroy_texture(texture_handler handler) override;
         void load_texture_data(texture_handler handler, texture_size size, void* pVoid) override;
+        void load_texture_region(texture_handler handler, texture_size offset, texture_size size, const void* data) override;
 
         ::renderer::parameters_list_handler create_parameters_list(const parameters_list_descriptor& descriptor) override;
         void set_parameter_data(::renderer::parameters_list_handler, uint32_t parameter_index, void* data) override;
+        bool validate_parameters_list(shader_handler, const std::string& block_name, parameters_list_handler) override;
         void destroy_parameters_list(parameters_list_handler handler) override;
 
+        instance_stream_handler create_instance_stream(const instance_stream_descriptor& descriptor) override;
+        void destroy_instance_stream(instance_stream_handler handler) override;
+        void set_instance_data(instance_stream_handler handler, uint32_t first_element, uint32_t elements_count, const void* data) override;
+        void set_shader_instance_stream(shader_handler, instance_stream_handler, const std::string& sampler_name) override;
+
         pass_handler create_pass(const pass_descriptor& descriptor) override;
         void destroy_pass(pass_handler handler) override;
         void resize_pass(pass_handler handler, size_t w, size_t h) override;
 
         void encode_draw_command(draw_command command) override;
+        command_encoder& get_command_encoder(uint32_t index) override;
 
         void update(float) override;
 
         void clear() override;
 
     private:
+        struct indirect_command
+        {
+            uint32_t count;
+            uint32_t instance_count;
+            uint32_t first_index;
+            uint32_t base_vertex;
+            uint32_t base_instance;
+        };
+
+        shader& use_shader(shader_handler shader_handler, uint32_t draw_id);
+        void bind_mesh(vao& mesh);
         void draw(mesh_handler mesh_handler, shader_handler shader_handler, uint32_t instances_count = 1, uint32_t draw_id = 0);
+
+        // commands share shader and mesh arena, falls back to separate draws without multi draw indirect.
+        void multi_draw(const ::renderer::draw_command* commands, size_t count);
+        uint32_t get_batch_key(const ::renderer::draw_command& command);
         void set_gpu_state(const ::renderer::shader_state&);
+        void sort_commands();
+        void reset_bindings_cache();
 
+        // declared before the factory, meshes return their ranges to arenas on destruction.
+        std::vector<std::unique_ptr<mesh_arena>> m_mesh_arenas;
         memory::pool_factory<renderer> m_factory;
+        std::unique_ptr<program_cache> m_program_cache;
+        program_cache::context_binder m_worker_context;
+
+        // encoders own recorded commands until update merges them into the commands buffer.
+        std::vector<std::unique_ptr<command_encoder>> m_encoders;
         std::vector<::renderer::draw_command> m_commands_buffer;
+        frame_sync m_frame_sync;
+        binding_points m_uniform_bindings;
+
+        // commands buffer indices in execution order: passes stay in place,
+        // runs of order independent draws between them are sorted by key.
+        std::vector<uint32_t> m_commands_order;
+        std::vector<sort_item> m_sort_items;
+        std::vector<sort_item> m_sort_scratch;
+
+        std::vector<::renderer::draw_command> m_batch;
+        std::vector<indirect_command> m_indirect_commands;
+        std::optional<raii_storage<detail::buffer_create_policy, detail::buffer_destroy_policy>> m_indirect_buffer;
+
+        // what is bound right now, binds and state changes matching it are skipped.
+        shader_handler m_bound_shader{::renderer::null};
+        GLuint m_bound_vao{0};
+        std::vector<texture_handler> m_bound_textures;
+        std::optional<::renderer::shader_state> m_gpu_state;
     };
 } // namespace renderer::gl
@@ -5,30 +5,180 @@
 #include <renderer/gl/bind_guard.hpp>
 #include <renderer/renderer.hpp>
 #include <renderer/gl/traits.hpp>
+#include <renderer/gl/program_cache.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 
 
-renderer::gl::shader::shader(const ::renderer::shader_descriptor& descriptor)
-    : m_samplers(descriptor.samplers)
-    , m_state(descriptor.state)
+renderer::gl::shader::shader(const ::renderer::shader_descriptor& descriptor, program_cache* cache)
+    : m_state(descriptor.state)
+{
+    const auto key = cache != nullptr ? cache->make_key(descriptor) : 0;
+
+    if (cache == nullptr || !cache->load(m_handler, key)) {
+        link_program(m_handler, descriptor);
+
+        if (cache != nullptr) {
+            cache->store(m_handler, key);
+        }
+    }
+
+    reflect();
+
+    for (const auto& uniform : m_reflection.uniforms) {
+        if (uniform.name == "DrawID") {
+            m_draw_id_location = uniform.location;
+        }
+    }
+
+    bind_guard shader_bind(*this);
+
+    for (size_t unit = 0; unit < m_samplers.size(); ++unit) {
+        glUniform1i(m_samplers[unit].location, GLint(unit));
+    }
+
+    for (const auto& [sampler_name, sampler_tex] : descriptor.samplers) {
+        set_sampler(sampler_name, sampler_tex);
+    }
+}
+
+
+void renderer::gl::shader::set_block_binding(const std::string& block_name, GLuint binding)
+{
+    auto block = std::find_if(m_reflection.blocks.begin(), m_reflection.blocks.end(), [&block_name](const auto& b) {
+        return b.name == block_name;
+    });
+
+    ASSERT(block != m_reflection.blocks.end() && "shader doesn't have such active block.");
+    glUniformBlockBinding(m_handler, GLuint(block - m_reflection.blocks.begin()), binding);
+}
+
+
+void renderer::gl::shader::set_sampler(const std::string& name, ::renderer::texture_handler texture)
+{
+    for (size_t i = 0; i < m_reflection.samplers.size(); ++i) {
+        if (m_reflection.uniforms[m_reflection.samplers[i]].name == name) {
+            m_samplers[i].texture = texture;
+            return;
+        }
+    }
+
+    ASSERT(false && "shader doesn't have such active sampler.");
+}
+
+
+const renderer::shader_reflection& renderer::gl::shader::get_reflection() const
+{
+    return m_reflection;
+}
+
+
+void renderer::gl::shader::reflect()
+{
+    GLint uniforms_count = 0;
+    GLint max_name_length = 0;
+    glGetProgramiv(m_handler, GL_ACTIVE_UNIFORMS, &uniforms_count);
+    glGetProgramiv(m_handler, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+    std::vector<GLuint> indices(uniforms_count);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    auto query = [this, &indices](GLenum param) {
+        std::vector<GLint> res(indices.size());
+        if (!indices.empty()) {
+            glGetActiveUniformsiv(m_handler, GLsizei(indices.size()), indices.data(), param, res.data());
+        }
+        return res;
+    };
+
+    const auto types = query(GL_UNIFORM_TYPE);
+    const auto sizes = query(GL_UNIFORM_SIZE);
+    const auto block_indices = query(GL_UNIFORM_BLOCK_INDEX);
+    const auto offsets = query(GL_UNIFORM_OFFSET);
+    const auto array_strides = query(GL_UNIFORM_ARRAY_STRIDE);
+    const auto matrix_strides = query(GL_UNIFORM_MATRIX_STRIDE);
+
+    std::string name;
+
+    for (GLint i = 0; i < uniforms_count; ++i) {
+        GLsizei length = 0;
+        name.resize(std::max(max_name_length, 1));
+        glGetActiveUniformName(m_handler, GLuint(i), GLsizei(name.size()), &length, name.data());
+        name.resize(length);
+
+        // arrays are reported as name[0].
+        if (name.ends_with("[0]")) {
+            name.resize(name.size() - 3);
+        }
+
+        auto& uniform = m_reflection.uniforms.emplace_back();
+        uniform.name = name;
+        uniform.type = traits::get_uniform_type(types[i]);
+        uniform.array_size = uint32_t(sizes[i]);
+        uniform.block_index = block_indices[i];
+        uniform.location = block_indices[i] < 0 ? glGetUniformLocation(m_handler, name.c_str()) : -1;
+        uniform.offset = uint32_t(std::max(offsets[i], 0));
+        uniform.array_stride = uint32_t(std::max(array_strides[i], 0));
+        uniform.matrix_stride = uint32_t(std::max(matrix_strides[i], 0));
+
+        if (uniform.type == uniform_type::sampler && uniform.location >= 0) {
+            m_reflection.samplers.emplace_back(uint32_t(i));
+            m_samplers.emplace_back(sampler_slot{.location = uniform.location, .texture = ::renderer::null});
+        }
+    }
+
+    GLint blocks_count = 0;
+    GLint max_block_name_length = 0;
+    glGetProgramiv(m_handler, GL_ACTIVE_UNIFORM_BLOCKS, &blocks_count);
+    glGetProgramiv(m_handler, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_block_name_length);
+
+    for (GLint i = 0; i < blocks_count; ++i) {
+        GLsizei length = 0;
+        name.resize(std::max(max_block_name_length, 1));
+        glGetActiveUniformBlockName(m_handler, GLuint(i), GLsizei(name.size()), &length, name.data());
+        name.resize(length);
+
+        GLint data_size = 0;
+        glGetActiveUniformBlockiv(m_handler, GLuint(i), GL_UNIFORM_BLOCK_DATA_SIZE, &data_size);
+
+        auto& block = m_reflection.blocks.emplace_back();
+        block.name = name;
+        block.data_size = uint32_t(data_size);
+
+        for (uint32_t u = 0; u < m_reflection.uniforms.size(); ++u) {
+            if (m_reflection.uniforms[u].block_index == i) {
+                block.uniforms.emplace_back(u);
+            }
+        }
+
+        std::sort(block.uniforms.begin(), block.uniforms.end(), [this](uint32_t l, uint32_t r) {
+            return m_reflection.uniforms[l].offset < m_reflection.uniforms[r].offset;
+        });
+    }
+}
+
+
+void renderer::gl::shader::link_program(detail::shader_handler& program, const ::renderer::shader_descriptor& descriptor)
 {
     for (const auto& stage : descriptor.stages) {
-        glAttachShader(m_handler, compile_shader(stage));
+        glAttachShader(program, compile_shader(stage));
     }
 
-    glLinkProgram(m_handler);
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
 
     GLint link_status = 0;
     GLint log_len = 0;
-    glGetProgramiv(m_handler, GL_LINK_STATUS, &link_status);
-    glGetProgramiv(m_handler, GL_INFO_LOG_LENGTH, &log_len);
+    glGetProgramiv(program, GL_LINK_STATUS, &link_status);
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_len);
 
     if (log_len > 0) {
         std::string log_buffer;
         log_buffer.resize(log_len);
 
-        glGetProgramInfoLog(m_handler, log_len, nullptr, log_buffer.data());
+        glGetProgramInfoLog(program, log_len, nullptr, log_buffer.data());
 
         if (link_status == GL_FALSE) {
             throw std::runtime_error(log_buffer);
@@ -36,23 +186,6 @@ renderer::gl::shader::shader(const ::renderer::shader_descriptor& descriptor)
 
         std::cout << log_buffer << std::endl;
     }
-
-    bind_guard shader_bind(*this);
-
-    GLint texture_slot = 0;
-    for (const auto& [sampler_name, sampler_tex] : m_samplers) {
-        GLint loc = glGetUniformLocation(m_handler, sampler_name.c_str());
-        ASSERT(loc >= 0);
-        glUniform1i(loc, texture_slot++);
-    }
-
-    GLint max_blocks;
-    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &max_blocks);
-    for (auto& [params_list_name, params_list_handler] : descriptor.parameters) {
-        auto uniform_index = glGetUniformBlockIndex(m_handler, params_list_name.c_str());
-        ASSERT(uniform_index >= 0);
-        glUniformBlockBinding(m_handler, uniform_index, params_list_handler);
-    }
 }
 
 
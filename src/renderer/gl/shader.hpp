@@ -52,19 +52,47 @@ namespace renderer::gl
     } // namespace detail
 
 
+    class program_cache;
+
     class shader
     {
         friend class renderer;
 
     public:
-        explicit shader(const ::renderer::shader_descriptor&);
+        // with cache program is linked from cached binary when possible.
+        explicit shader(const ::renderer::shader_descriptor&, program_cache* cache = nullptr);
         void bind();
         void unbind();
 
+        // compiles stages and links them into program, throws with driver log on errors.
+        static void link_program(detail::shader_handler& program, const ::renderer::shader_descriptor&);
+
+        void set_sampler(const std::string& name, texture_handler texture);
+        // uniform block of the shader reads the buffer range bound at binding point.
+        void set_block_binding(const std::string& block_name, GLuint binding);
+        const ::renderer::shader_reflection& get_reflection() const;
+
     private:
-        detail::stage_handler compile_shader(const ::renderer::shader_stage&);
+        struct sampler_slot
+        {
+            GLint location;
+            texture_handler texture;
+        };
+
+        static detail::stage_handler compile_shader(const ::renderer::shader_stage&);
+        void reflect();
+
         detail::shader_handler m_handler;
-        std::unordered_map<std::string, uint32_t> m_samplers;
         ::renderer::shader_state m_state;
+
+        // filled once after link, draws never look anything up by name.
+        ::renderer::shader_reflection m_reflection;
+
+        // one slot per reflected sampler, texture unit is the slot index.
+        std::vector<sampler_slot> m_samplers;
+
+        // DrawID uniform location and its last uploaded value, -1 if unknown.
+        GLint m_draw_id_location{-1};
+        int64_t m_draw_id{-1};
     };
 } // namespace renderer::gl
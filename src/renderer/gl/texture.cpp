@@ -28,6 +28,9 @@ renderer::gl::texture::texture(const ::renderer::texture_descriptor& desc)
             resize(desc.size);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
             return;
+        case texture_type::buffer:
+            // no images and no sampling parameters, see instance_stream.
+            return;
     }
 
     if (desc.mips) {
@@ -135,3 +138,22 @@ void renderer::gl::texture::load(::renderer::texture_size size, void* data_ptr)
     const auto [type, int_fmt, fmt] = m_storage_data;
     glTexImage2D(m_gl_type, 0, int_fmt, size.width, size.height, 0, fmt, type, data_ptr);
 }
+
+
+void renderer::gl::texture::load_region(::renderer::texture_size offset, ::renderer::texture_size size, const void* data_ptr)
+{
+    bind_guard bind(*this);
+
+    const auto [type, int_fmt, fmt] = m_storage_data;
+
+    switch (m_gl_type) {
+        case GL_TEXTURE_2D:
+            glTexSubImage2D(m_gl_type, 0, offset.width, offset.height, size.width, size.height, fmt, type, data_ptr);
+            break;
+        case GL_TEXTURE_3D:
+            glTexSubImage3D(m_gl_type, 0, offset.width, offset.height, offset.depth, size.width, size.height, size.depth, fmt, type, data_ptr);
+            break;
+        default:
+            ASSERT(false && "regions are loaded into 2d and 3d textures only.");
+    }
+}
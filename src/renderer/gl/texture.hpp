@@ -45,6 +45,7 @@ namespace renderer::gl
         void resize(const ::renderer::texture_size&);
 
         void load(::renderer::texture_size, void*);
+        void load_region(::renderer::texture_size offset, ::renderer::texture_size size, const void*);
 
     private:
         void load_2d_data(const texture_descriptor&);
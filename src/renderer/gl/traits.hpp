@@ -60,6 +60,8 @@ namespace renderer::gl::traits
                 return descriptor.size.length == 1 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_CUBE_MAP_ARRAY;
             case texture_type::attachment:
                 return GL_TEXTURE_2D;
+            case texture_type::buffer:
+                return GL_TEXTURE_BUFFER;
             default:
                 ASSERT(false && "invalid texture type.");
         }
@@ -148,6 +150,74 @@ namespace renderer::gl::traits
         }
     }
 
+    inline ::renderer::uniform_type get_uniform_type(GLenum type)
+    {
+        switch (type) {
+            case GL_FLOAT:
+                return uniform_type::f32;
+            case GL_INT:
+                return uniform_type::i32;
+            case GL_UNSIGNED_INT:
+                return uniform_type::u32;
+            case GL_FLOAT_VEC2:
+                return uniform_type::vec2;
+            case GL_FLOAT_VEC3:
+                return uniform_type::vec3;
+            case GL_FLOAT_VEC4:
+                return uniform_type::vec4;
+            case GL_FLOAT_MAT2:
+                return uniform_type::mat2;
+            case GL_FLOAT_MAT3:
+                return uniform_type::mat3;
+            case GL_FLOAT_MAT4:
+                return uniform_type::mat4;
+            case GL_FLOAT_MAT2x4:
+                return uniform_type::mat2x4;
+            case GL_FLOAT_MAT3x4:
+                return uniform_type::mat3x4;
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_BUFFER:
+            case GL_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+                return uniform_type::sampler;
+            default:
+                return uniform_type::other;
+        }
+    }
+
+    // std140 size of one (non array) block member, matrices are column major.
+    inline size_t get_std140_size(::renderer::uniform_type type, size_t matrix_stride)
+    {
+        switch (type) {
+            case uniform_type::f32:
+            case uniform_type::i32:
+            case uniform_type::u32:
+                return 4;
+            case uniform_type::vec2:
+                return 8;
+            case uniform_type::vec3:
+                return 12;
+            case uniform_type::vec4:
+                return 16;
+            case uniform_type::mat2:
+            case uniform_type::mat2x4:
+                return 2 * matrix_stride;
+            case uniform_type::mat3:
+            case uniform_type::mat3x4:
+                return 3 * matrix_stride;
+            case uniform_type::mat4:
+                return 4 * matrix_stride;
+            default:
+                return 0;
+        }
+    }
+
     inline size_t get_gl_geom_topology(::renderer::geometry_topology topology, bool adjacent)
     {
         switch (topology) {
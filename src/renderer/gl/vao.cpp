@@ -5,9 +5,17 @@
 #include <renderer/renderer.hpp>
 #include <renderer/gl/traits.hpp>
 #include <renderer/gl/buffer.hpp>
+#include <renderer/gl/mesh_arena.hpp>
+
+
+struct renderer::gl::vao::arena_storage
+{
+    mesh_arena::allocation allocation;
+};
 
 
 renderer::gl::vao::vao(const ::renderer::mesh_layout_descriptor& vld)
+    : m_handler(std::in_place)
 {
     vertex_buffer vbo(vld.vertex_data.size());
     std::optional<element_buffer> ebo;
@@ -53,15 +61,36 @@ renderer::gl::vao::vao(const ::renderer::mesh_layout_descriptor& vld)
 }
 
 
-void renderer::gl::vao::draw()
+renderer::gl::vao::vao(const ::renderer::mesh_layout_descriptor& vld, mesh_arena& arena)
+    : m_arena_storage(std::make_unique<arena_storage>(arena_storage{.allocation = arena.allocate(vld)}))
 {
-    bind_guard bind(*this);
+    const auto& range = m_arena_storage->allocation.get_range();
+
+    m_vertices_count = range.vertices_count;
+    m_indices_count = range.indices_count;
+    m_indices_format = GL_UNSIGNED_INT;
+    m_geometry_topology = arena.get_topology();
+}
+
+
+renderer::gl::vao::~vao() = default;
+
 
+renderer::gl::vao::vao(vao&&) noexcept = default;
+
+
+renderer::gl::vao& renderer::gl::vao::operator=(vao&&) noexcept = default;
+
+
+void renderer::gl::vao::draw()
+{
     if (m_geometry_topology == GL_POINTS) {
         glEnable(GL_PROGRAM_POINT_SIZE);
     }
 
-    if (m_indices_count > 0) {
+    if (m_arena_storage) {
+        glDrawElementsBaseVertex(m_geometry_topology, m_indices_count, GL_UNSIGNED_INT, reinterpret_cast<void*>(get_first_index() * sizeof(uint32_t)), get_base_vertex());
+    } else if (m_indices_count > 0) {
         glDrawElements(m_geometry_topology, m_indices_count, m_indices_format, reinterpret_cast<void*>(0));
     } else {
         glDrawArrays(m_geometry_topology, 0, m_vertices_count);
@@ -74,7 +103,37 @@ void renderer::gl::vao::draw()
 
 void renderer::gl::vao::bind()
 {
-    glBindVertexArray(m_handler);
+    glBindVertexArray(get_handler());
+}
+
+
+GLuint renderer::gl::vao::get_handler()
+{
+    return m_arena_storage ? m_arena_storage->allocation.get_arena().get_vao_handler() : GLuint(*m_handler);
+}
+
+
+renderer::gl::mesh_arena* renderer::gl::vao::get_arena()
+{
+    return m_arena_storage ? &m_arena_storage->allocation.get_arena() : nullptr;
+}
+
+
+uint32_t renderer::gl::vao::get_indices_count() const
+{
+    return uint32_t(m_indices_count);
+}
+
+
+uint32_t renderer::gl::vao::get_first_index() const
+{
+    return m_arena_storage ? m_arena_storage->allocation.get_range().first_index : 0;
+}
+
+
+uint32_t renderer::gl::vao::get_base_vertex() const
+{
+    return m_arena_storage ? m_arena_storage->allocation.get_range().base_vertex : 0;
 }
 
 void renderer::gl::vao::unbind()
@@ -85,14 +144,14 @@ void renderer::gl::vao::unbind()
 
 void renderer::gl::vao::draw_instanced(uint32_t instances_count)
 {
-    bind_guard bind(*this);
-
     if (m_geometry_topology == GL_POINTS) {
         glEnable(GL_PROGRAM_POINT_SIZE);
     }
 
     ASSERT(instances_count > 0);
-    if (m_indices_count > 0) {
+    if (m_arena_storage) {
+        glDrawElementsInstancedBaseVertex(m_geometry_topology, m_indices_count, GL_UNSIGNED_INT, reinterpret_cast<void*>(get_first_index() * sizeof(uint32_t)), instances_count, get_base_vertex());
+    } else if (m_indices_count > 0) {
         glDrawElementsInstanced(m_geometry_topology, m_indices_count, m_indices_format, reinterpret_cast<void*>(0), instances_count);
     } else {
         glDrawArraysInstanced(m_geometry_topology, 0, m_vertices_count, instances_count);
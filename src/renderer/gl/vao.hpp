@@ -6,6 +6,9 @@
 #include <renderer/gl/raii_storage.hpp>
 #include <glad/glad.h>
 
+#include <memory>
+#include <optional>
+
 namespace renderer
 {
     class mesh_layout_descriptor;
@@ -14,6 +17,8 @@ namespace renderer
 
 namespace renderer::gl
 {
+    class mesh_arena;
+
     namespace detail
     {
         struct vao_create_policy
@@ -38,13 +43,33 @@ namespace renderer::gl
     {
     public:
         explicit vao(const mesh_layout_descriptor&);
+
+        // mesh data lives in the arena, vao of the arena is used.
+        vao(const mesh_layout_descriptor&, mesh_arena& arena);
+        ~vao();
+
+        vao(vao&&) noexcept;
+        vao& operator=(vao&&) noexcept;
+
+        // vao must be bound, renderer keeps it bound between draws of the same mesh.
         void draw();
         void draw_instanced(uint32_t instances_count);
         void bind();
         void unbind();
 
+        GLuint get_handler();
+
+        // null for meshes with own buffers.
+        mesh_arena* get_arena();
+        uint32_t get_indices_count() const;
+        uint32_t get_first_index() const;
+        uint32_t get_base_vertex() const;
+
     private:
-        raii_storage<detail::vao_create_policy, detail::vao_destroy_policy> m_handler;
+        struct arena_storage;
+
+        std::optional<raii_storage<detail::vao_create_policy, detail::vao_destroy_policy>> m_handler;
+        std::unique_ptr<arena_storage> m_arena_storage;
         size_t m_indices_count{0};
         size_t m_vertices_count{0};
         GLenum m_indices_format{0};
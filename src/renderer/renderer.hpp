@@ -10,13 +10,19 @@
 
 namespace renderer
 {
-    using mesh_handler = uint32_t;
-    using shader_handler = uint32_t;
-    using texture_handler = uint32_t;
-    using parameters_list_handler = uint32_t;
-    using pass_handler = uint32_t;
+    // handlers are generational (slot index + slot generation, see memory/handle.hpp),
+    // handlers of destroyed resources never alias new ones.
+    using mesh_handler = uint64_t;
+    using shader_handler = uint64_t;
+    using texture_handler = uint64_t;
+    using parameters_list_handler = uint64_t;
+    using pass_handler = uint64_t;
+    using instance_stream_handler = uint64_t;
 
-    constexpr static auto null = uint32_t(-1);
+    constexpr static auto null = uint64_t(-1);
+
+    // meshes with shared storage get draw id of the command in this uint vertex attribute.
+    constexpr static uint32_t draw_id_attribute_location = 15;
 
     enum class data_type
     {
@@ -58,7 +64,9 @@ namespace renderer
         d2,
         d3,
         cube,
-        attachment
+        attachment,
+        // texel buffer, its storage is attached by instance stream.
+        buffer
     };
 
     enum class texture_filtration
@@ -83,10 +91,29 @@ namespace renderer
         mat4
     };
 
+    enum class uniform_type
+    {
+        f32,
+        i32,
+        u32,
+        vec2,
+        vec3,
+        vec4,
+        mat2,
+        mat3,
+        mat4,
+        mat2x4,
+        mat3x4,
+        sampler,
+        other
+    };
+
     enum class draw_command_type
     {
         pass,
-        draw
+        draw,
+        // adjacent multi draws of one shader and meshes of one shared storage are issued as one gl call.
+        multi_draw
     };
 
     enum class blend_mode
@@ -139,6 +166,8 @@ namespace renderer
         data_type indices_data_type = data_type::u16;
         geometry_topology topology = geometry_topology::triangles;
         bool adjacent = false;
+        // mesh is sub-allocated from buffers shared by meshes of the same layout, see multi_draw.
+        bool shared_storage = false;
     };
 
     struct shader_stage
@@ -164,6 +193,36 @@ namespace renderer
         shader_state state;
     };
 
+    // active uniforms of a linked program. offsets and strides are std140 layout of block members,
+    // location is -1 for block members.
+    struct uniform_info
+    {
+        std::string name;
+        uniform_type type;
+        uint32_t array_size;
+        int32_t block_index;
+        int32_t location;
+        uint32_t offset;
+        uint32_t array_stride;
+        uint32_t matrix_stride;
+    };
+
+    struct uniform_block_info
+    {
+        std::string name;
+        uint32_t data_size;
+        // indices in shader_reflection::uniforms, sorted by offset.
+        std::vector<uint32_t> uniforms;
+    };
+
+    struct shader_reflection
+    {
+        std::vector<uniform_info> uniforms;
+        std::vector<uniform_block_info> blocks;
+        // indices in uniforms, texture unit of a sampler is its position here.
+        std::vector<uint32_t> samplers;
+    };
+
     struct texture_size
     {
         size_t width, height, depth = 0, length = 1;
@@ -185,6 +244,14 @@ namespace renderer
         std::vector<parameter_type> parameters;
     };
 
+    // every element is a run of rgba32f texels in samplerBuffer: element i of mat4 stream
+    // is texelFetch(s, i * 4 + column).
+    struct instance_stream_descriptor
+    {
+        parameter_type element_type = parameter_type::mat4;
+        size_t elements_count;
+    };
+
     struct draw_command
     {
         draw_command_type type{draw_command_type::draw};
@@ -193,6 +260,8 @@ namespace renderer
         pass_handler pass{null};
         uint32_t instances_count{1};
         uint32_t draw_id{0};
+        // view depth hint, opaque draws of the same shader and mesh are drawn front to back.
+        float depth{0};
     };
 
 
@@ -219,6 +288,8 @@ namespace renderer
         pass_state state;
     };
 
+    class command_encoder;
+
     class renderer
     {
     public:
@@ -230,21 +301,50 @@ namespace renderer
         virtual shader_handler create_shader(const shader_descriptor&) = 0;
         virtual void destroy_shader(shader_handler) = 0;
         virtual void set_shader_sampler(shader_handler, texture_handler, const std::string& sampler_name) = 0;
+        virtual const shader_reflection& get_shader_reflection(shader_handler) = 0;
+
+        // linked programs are stored in the directory, next runs load them instead of compiling.
+        virtual void set_program_cache_directory(const std::string& directory) = 0;
+
+        // fills program cache in background, create_shader of these descriptors only loads binaries then.
+        virtual void prewarm_shaders(std::vector<shader_descriptor>) = 0;
 
         virtual texture_handler create_texture(const texture_descriptor&) = 0;
         virtual void destroy_texture(texture_handler) = 0;
         virtual void load_texture_data(texture_handler, texture_size, void*) = 0;
 
+        // replaces part of 2d or 3d texture, offset and size are in texels.
+        virtual void load_texture_region(texture_handler, texture_size offset, texture_size size, const void*) = 0;
+
         virtual parameters_list_handler create_parameters_list(const parameters_list_descriptor&) = 0;
         virtual void destroy_parameters_list(parameters_list_handler) = 0;
 
         virtual void set_parameter_data(parameters_list_handler, uint32_t parameter_index, void* data) = 0;
 
+        // true if parameters of the list lie exactly at std140 offsets of the shader's uniform block.
+        virtual bool validate_parameters_list(shader_handler, const std::string& block_name, parameters_list_handler) = 0;
+
+        // per instance data which isn't limited by uniform block size. throws if it exceeds max texture buffer size.
+        virtual instance_stream_handler create_instance_stream(const instance_stream_descriptor&) = 0;
+        virtual void destroy_instance_stream(instance_stream_handler) = 0;
+
+        // only changed elements are uploaded, the stream is attached to shaders as samplerBuffer.
+        virtual void set_instance_data(instance_stream_handler, uint32_t first_element, uint32_t elements_count, const void* data) = 0;
+        virtual void set_shader_instance_stream(shader_handler, instance_stream_handler, const std::string& sampler_name) = 0;
+
         virtual pass_handler create_pass(const pass_descriptor&) = 0;
         virtual void destroy_pass(pass_handler) = 0;
         virtual void resize_pass(pass_handler, size_t w, size_t h) = 0;
 
+        // same as get_command_encoder(0).encode_draw_command(command).
         virtual void encode_draw_command(draw_command) = 0;
+
+        // encoder which can be filled on any thread in parallel with other encoders.
+        // encoders are created on demand, so get them before the recording threads start.
+        // update replays them merged by index, so the frame doesn't depend on threads timing.
+        // draws continue the last pass of the previous encoder unless encoder begins with own pass command.
+        virtual command_encoder& get_command_encoder(uint32_t index) = 0;
+
         virtual void update(float) = 0;
         virtual void clear() = 0;
     };
@@ -19,7 +19,7 @@ namespace renderer::scene
         virtual ~shader() = default;
         virtual void create_gpu_resources() = 0;
 
-        uint32_t handler = -1;
+        uint64_t handler = -1;
     };
 }
 
@@ -4,6 +4,8 @@
 
 #include <math/misc/misc.hpp>
 
+#include <algorithm>
+
 
 renderer::scene::shapes::cylinder::cylinder(::renderer::renderer* renderer, uint32_t smoothness, uint32_t cond_bits, float r, float zmin, float zmax, float phi_max)
     : procedural(renderer, smoothness, cond_bits, phi_max / float(M_PI * 2), 1, clockwise::ccw)
@@ -35,3 +37,22 @@ math::vec3 renderer::scene::shapes::cylinder::get_tangent(float u, float v, math
 {
     return math::normalize(math::vec3{-m_phi_max * position.y, m_phi_max * position.x, 0});
 }
+
+
+void renderer::scene::shapes::cylinder::get_normals(const math::vec2_soa&, const math::vec3_soa& positions, math::vec3_soa& normals)
+{
+    const auto count = positions.size();
+    normals.resize(count);
+
+    std::copy(positions.lane(0), positions.lane(0) + count, normals.lane(0));
+    std::copy(positions.lane(1), positions.lane(1) + count, normals.lane(1));
+    std::fill(normals.lane(2), normals.lane(2) + count, 0.f);
+
+    math::soa::normalize(normals, normals);
+}
+
+
+void renderer::scene::shapes::cylinder::get_tangents(const math::vec2_soa&, const math::vec3_soa& positions, math::vec3_soa& tangents)
+{
+    get_revolution_tangents(positions, m_phi_max, tangents);
+}
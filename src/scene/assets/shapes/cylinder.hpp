@@ -24,6 +24,8 @@ namespace renderer::scene::shapes
         math::vec3 get_position(float u, float v) override;
         math::vec3 get_normal(float u, float v, math::vec3 position) override;
         math::vec3 get_tangent(float u, float v, math::vec3 position) override;
+        void get_normals(const math::vec2_soa& uvs, const math::vec3_soa& positions, math::vec3_soa& normals) override;
+        void get_tangents(const math::vec2_soa& uvs, const math::vec3_soa& positions, math::vec3_soa& tangents) override;
 
 
     private:
@@ -3,6 +3,7 @@
 #include "procedural.hpp"
 #include <renderer/renderer.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <cstring>
 
@@ -11,7 +12,7 @@ namespace
 {
     template<typename IndexType>
     void generate_indices(
-        std::vector<math::vec3>& vertices,
+        const math::vec3_soa& vertices,
         std::vector<uint8_t>& res,
         size_t total,
         renderer::scene::shapes::clockwise clockwise,
@@ -98,26 +99,24 @@ void renderer::scene::shapes::procedural::create_gpu_resources()
     std::vector<uint8_t>& vert_buf = mld.vertex_data;
     std::vector<uint8_t>& ind_buf = mld.index_data;
 
-    std::vector<math::vec3> vertices;
-    std::vector<math::vec2> uvs;
-    std::vector<math::vec3> normals;
-    std::vector<math::vec3> tangents;
+    math::vec3_soa vertices;
+    math::vec2_soa uvs;
+    math::vec3_soa normals;
+    math::vec3_soa tangents;
 
-    vertices.reserve(m_smoothness * m_smoothness);
+    vertices.reserve((m_smoothness + 1) * (m_smoothness + 1));
+    uvs.reserve((m_smoothness + 1) * (m_smoothness + 1));
     mld.vertex_attributes.emplace_back(::renderer::vertex_attribute{.data_type = ::renderer::data_type::f32, .elements_count = 3});
 
     if (m_cond_bits & gen_uv) {
-        uvs.reserve(m_smoothness * m_smoothness);
         mld.vertex_attributes.emplace_back(::renderer::vertex_attribute{.data_type = ::renderer::data_type::f32, .elements_count = 2});
     }
 
     if (m_cond_bits & gen_normal) {
-        normals.reserve(m_smoothness * m_smoothness);
         mld.vertex_attributes.emplace_back(::renderer::vertex_attribute{.data_type = ::renderer::data_type::f32, .elements_count = 3});
     }
 
     if (m_cond_bits & gen_tangents) {
-        tangents.reserve(m_smoothness * m_smoothness);
         mld.vertex_attributes.emplace_back(::renderer::vertex_attribute{.data_type = ::renderer::data_type::f32, .elements_count = 3});
     }
 
@@ -134,55 +133,53 @@ void renderer::scene::shapes::procedural::create_gpu_resources()
                 continue;
             }
 
-            auto pos = get_position(u, v);
-
-            vertices.emplace_back(pos);
-
-            if (m_cond_bits & gen_uv) {
-                uvs.emplace_back(math::vec2{u, v});
-            }
-
-            if (m_cond_bits & gen_normal) {
-                normals.emplace_back(get_normal(u, v, pos));
-            }
-
-            if (m_cond_bits & gen_tangents) {
-                tangents.emplace_back(get_tangent(u, v, pos));
-            }
+            vertices.push_back(get_position(u, v));
+            uvs.push_back(math::vec2{u, v});
         }
     }
 
-    auto buffer_size = vertices.size() * sizeof(vertices.front())
-                       + uvs.size() * sizeof(uvs.front())
-                       + normals.size() * sizeof(normals.front())
-                       + tangents.size() * sizeof(tangents.front());
+    if (m_cond_bits & gen_normal) {
+        get_normals(uvs, vertices, normals);
+    }
+
+    if (m_cond_bits & gen_tangents) {
+        get_tangents(uvs, vertices, tangents);
+    }
 
-    auto vert_size = sizeof(vertices.front())
-                     + (uvs.empty() ? 0 : sizeof(uvs.front()))
-                     + (normals.empty() ? 0 : sizeof(normals.front()))
-                     + (tangents.empty() ? 0 : sizeof(tangents.front()));
+    const bool has_uvs = m_cond_bits & gen_uv;
+    const bool has_normals = m_cond_bits & gen_normal;
+    const bool has_tangents = m_cond_bits & gen_tangents;
 
+    auto vert_size = sizeof(math::vec3)
+                     + (has_uvs ? sizeof(math::vec2) : 0)
+                     + (has_normals ? sizeof(math::vec3) : 0)
+                     + (has_tangents ? sizeof(math::vec3) : 0);
 
-    vert_buf.resize(buffer_size);
-    auto begin = vert_buf.data();
+    vert_buf.resize(vertices.size() * vert_size);
+    auto begin = reinterpret_cast<float*>(vert_buf.data());
 
-    for (int i = 0; i < vertices.size(); ++i, begin += vert_size) {
-        std::memcpy(begin, &vertices[i], sizeof(vertices[i]));
-        size_t offset = sizeof(vertices[i]);
+    // interleave lanes straight into the vertex buffer.
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        for (size_t lane = 0; lane < 3; ++lane) {
+            *begin++ = vertices.lane(lane)[i];
+        }
 
-        if (!uvs.empty()) {
-            std::memcpy(begin + offset, &uvs[i], sizeof(uvs[i]));
-            offset += sizeof(uvs[i]);
+        if (has_uvs) {
+            for (size_t lane = 0; lane < 2; ++lane) {
+                *begin++ = uvs.lane(lane)[i];
+            }
         }
 
-        if (!normals.empty()) {
-            std::memcpy(begin + offset, &normals[i], sizeof(normals[i]));
-            offset += sizeof(normals[i]);
+        if (has_normals) {
+            for (size_t lane = 0; lane < 3; ++lane) {
+                *begin++ = normals.lane(lane)[i];
+            }
         }
 
-        if (!tangents.empty()) {
-            std::memcpy(begin + offset, &tangents[i], sizeof(tangents[i]));
-            offset += sizeof(tangents[i]);
+        if (has_tangents) {
+            for (size_t lane = 0; lane < 3; ++lane) {
+                *begin++ = tangents.lane(lane)[i];
+            }
         }
     }
 
@@ -196,3 +193,37 @@ void renderer::scene::shapes::procedural::create_gpu_resources()
 
     handler = m_renderer->create_mesh(mld);
 }
+
+
+void renderer::scene::shapes::procedural::get_normals(const math::vec2_soa& uvs, const math::vec3_soa& positions, math::vec3_soa& normals)
+{
+    normals.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        auto uv = uvs.get(i);
+        normals.set(i, get_normal(uv.x, uv.y, positions.get(i)));
+    }
+}
+
+
+void renderer::scene::shapes::procedural::get_tangents(const math::vec2_soa& uvs, const math::vec3_soa& positions, math::vec3_soa& tangents)
+{
+    tangents.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        auto uv = uvs.get(i);
+        tangents.set(i, get_tangent(uv.x, uv.y, positions.get(i)));
+    }
+}
+
+
+void renderer::scene::shapes::procedural::get_revolution_tangents(const math::vec3_soa& positions, float phi_max, math::vec3_soa& tangents)
+{
+    const auto count = positions.size();
+    tangents.resize(count);
+
+    std::copy(positions.lane(1), positions.lane(1) + count, tangents.lane(0));
+    std::copy(positions.lane(0), positions.lane(0) + count, tangents.lane(1));
+    std::fill(tangents.lane(2), tangents.lane(2) + count, 0.f);
+
+    math::soa::mul(tangents, math::vec3{-phi_max, phi_max, 0}, tangents);
+    math::soa::normalize(tangents, tangents);
+}
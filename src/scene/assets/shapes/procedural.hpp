@@ -5,6 +5,7 @@
 #include <scene/assets/shapes/shape.hpp>
 
 #include <math/vector.hpp>
+#include <math/soa/vec_soa.hpp>
 
 namespace renderer::scene::shapes
 {
@@ -40,6 +41,14 @@ namespace renderer::scene::shapes
         virtual math::vec3 get_normal(float u, float v, math::vec3 position) = 0;
         virtual math::vec3 get_tangent(float u, float v, math::vec3 position) = 0;
 
+        // whole mesh versions, shapes with closed form normals/tangents override them with batch math.
+        // default ones call per vertex get_normal/get_tangent.
+        virtual void get_normals(const math::vec2_soa& uvs, const math::vec3_soa& positions, math::vec3_soa& normals);
+        virtual void get_tangents(const math::vec2_soa& uvs, const math::vec3_soa& positions, math::vec3_soa& tangents);
+
+        // normalize(-phi_max * y, phi_max * x, 0) for every position, tangents of surfaces of revolution around z.
+        static void get_revolution_tangents(const math::vec3_soa& positions, float phi_max, math::vec3_soa& tangents);
+
         uint32_t m_smoothness;
         uint64_t m_cond_bits;
 
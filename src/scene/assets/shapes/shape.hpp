@@ -22,7 +22,7 @@ namespace renderer::scene::shapes
 
         virtual ~shape() = default;
         virtual void create_gpu_resources() = 0;
-        uint32_t handler = -1;
+        uint64_t handler = -1;
 
     protected:
         ::renderer::renderer* m_renderer;
@@ -46,3 +46,15 @@ math::vec3 renderer::scene::shapes::sphere::get_tangent(float u, float v, math::
 {
     return math::normalize(math::vec3{-m_phi_max * position.y, m_phi_max * position.x, 0});
 }
+
+
+void renderer::scene::shapes::sphere::get_normals(const math::vec2_soa&, const math::vec3_soa& positions, math::vec3_soa& normals)
+{
+    math::soa::normalize(positions, normals);
+}
+
+
+void renderer::scene::shapes::sphere::get_tangents(const math::vec2_soa&, const math::vec3_soa& positions, math::vec3_soa& tangents)
+{
+    get_revolution_tangents(positions, m_phi_max, tangents);
+}
@@ -14,7 +14,7 @@ namespace renderer::scene
         virtual ~image() = default;
         virtual void create_gpu_resources() = 0;
 
-        uint32_t handler = -1;
+        uint64_t handler = -1;
     };
 }
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cinttypes>
+#include <cstddef>
 
 namespace renderer::scene
 {
@@ -11,10 +12,14 @@ namespace renderer::scene
         friend class scene;
 
     public:
+        // components live in chunked pools, pointers from scene::get_component/emplace_component
+        // stay valid until the component is removed.
+        constexpr static size_t pool_chunk_size = 256;
+
         virtual ~component_base() = default;
 
     private:
-        uint32_t object_handler = -1;
+        uint64_t object_handler = -1;
     };
 }
 
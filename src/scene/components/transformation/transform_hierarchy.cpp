@@ -0,0 +1,358 @@
+
+
+#include "transform_hierarchy.hpp"
+
+#include <misc/debug.hpp>
+
+#include <algorithm>
+
+
+math::mat4 renderer::scene::to_matrix(const trs& t)
+{
+    const auto r = math::to_matrix(t.rotation);
+    const float* s = &t.scale.x;
+    const float* p = &t.translation.x;
+
+    math::mat4 res;
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            res[row][col] = r[row][col] * s[col];
+        }
+        res[row][3] = p[row];
+    }
+
+    return res;
+}
+
+
+math::mat4 renderer::scene::to_inverse_matrix(const trs& t)
+{
+    // (T * R * S)^-1 = S^-1 * R^T * T^-1
+    const auto r = math::to_matrix(t.rotation);
+    const float* s = &t.scale.x;
+    const float* p = &t.translation.x;
+
+    math::mat4 res;
+    for (size_t row = 0; row < 3; ++row) {
+        const float inv_s = 1.f / s[row];
+        float translation = 0;
+        for (size_t col = 0; col < 3; ++col) {
+            res[row][col] = r[col][row] * inv_s;
+            translation += res[row][col] * p[col];
+        }
+        res[row][3] = -translation;
+    }
+
+    return res;
+}
+
+
+renderer::scene::transform_hierarchy::node_handle renderer::scene::transform_hierarchy::create_node(node_handle parent, const trs& local)
+{
+    const auto index = uint32_t(m_handles.size());
+    const auto handle = m_indices.create(index);
+    const auto parent_index = parent == memory::null_handle ? npos : index_of(parent);
+
+    m_handles.emplace_back(handle);
+    m_parents.emplace_back(parent_index);
+    m_subtree_sizes.emplace_back(1);
+    m_locals.emplace_back(local);
+    m_worlds.emplace_back();
+    m_inverse_worlds.emplace_back();
+    m_dirty_flags.emplace_back(0);
+
+    if (parent_index != npos) {
+        // new node belongs to the end of parent's subtree. it's appended and moved there lazily,
+        // so creating a batch of children costs one reorder instead of one per node.
+        m_order_dirty = m_order_dirty || parent_index + m_subtree_sizes[parent_index] != index;
+        add_to_ancestors_sizes(parent_index, 1);
+    }
+
+    mark_dirty(index);
+    return handle;
+}
+
+
+void renderer::scene::transform_hierarchy::destroy_node(node_handle node)
+{
+    restore_order();
+
+    const auto index = index_of(node);
+    const auto size = m_subtree_sizes[index];
+
+    if (m_parents[index] != npos) {
+        add_to_ancestors_sizes(m_parents[index], -int64_t(size));
+    }
+
+    std::vector<uint32_t> order;
+    order.reserve(m_handles.size() - size);
+
+    for (uint32_t i = 0; i < m_handles.size(); ++i) {
+        if (i >= index && i < index + size) {
+            m_indices.destroy(m_handles[i]);
+        } else {
+            order.emplace_back(i);
+        }
+    }
+
+    reorder(order);
+}
+
+
+void renderer::scene::transform_hierarchy::set_parent(node_handle node, node_handle parent)
+{
+    restore_order();
+
+    const auto index = index_of(node);
+    const auto size = m_subtree_sizes[index];
+    const auto parent_index = parent == memory::null_handle ? npos : index_of(parent);
+
+    ASSERT(parent_index == npos || parent_index < index || parent_index >= index + size);
+
+    if (m_parents[index] == parent_index) {
+        return;
+    }
+
+    if (m_parents[index] != npos) {
+        add_to_ancestors_sizes(m_parents[index], -int64_t(size));
+    }
+
+    const auto count = uint32_t(m_handles.size());
+
+    std::vector<uint32_t> rest;
+    rest.reserve(count - size);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (i < index || i >= index + size) {
+            rest.emplace_back(i);
+        }
+    }
+
+    // subtree sizes don't include the moved subtree anymore, so they are valid for positions in rest.
+    auto insert_pos = uint32_t(rest.size());
+    if (parent_index != npos) {
+        const auto parent_pos = parent_index < index ? parent_index : parent_index - size;
+        insert_pos = parent_pos + m_subtree_sizes[parent_index];
+        add_to_ancestors_sizes(parent_index, size);
+    }
+
+    m_parents[index] = parent_index;
+
+    std::vector<uint32_t> order;
+    order.reserve(count);
+    order.insert(order.end(), rest.begin(), rest.begin() + insert_pos);
+    for (uint32_t i = index; i < index + size; ++i) {
+        order.emplace_back(i);
+    }
+    order.insert(order.end(), rest.begin() + insert_pos, rest.end());
+
+    reorder(order);
+    mark_dirty(index_of(node));
+}
+
+
+renderer::scene::transform_hierarchy::node_handle renderer::scene::transform_hierarchy::get_parent(node_handle node) const
+{
+    const auto parent = m_parents[index_of(node)];
+    return parent == npos ? memory::null_handle : m_handles[parent];
+}
+
+
+const renderer::scene::trs& renderer::scene::transform_hierarchy::get_local(node_handle node) const
+{
+    return m_locals[index_of(node)];
+}
+
+
+void renderer::scene::transform_hierarchy::set_local(node_handle node, const trs& local)
+{
+    const auto index = index_of(node);
+    m_locals[index] = local;
+    mark_dirty(index);
+}
+
+
+void renderer::scene::transform_hierarchy::set_translation(node_handle node, math::vec3 translation)
+{
+    const auto index = index_of(node);
+    m_locals[index].translation = translation;
+    mark_dirty(index);
+}
+
+
+void renderer::scene::transform_hierarchy::set_rotation(node_handle node, math::quaternion rotation)
+{
+    const auto index = index_of(node);
+    m_locals[index].rotation = rotation;
+    mark_dirty(index);
+}
+
+
+void renderer::scene::transform_hierarchy::set_scale(node_handle node, math::vec3 scale)
+{
+    const auto index = index_of(node);
+    m_locals[index].scale = scale;
+    mark_dirty(index);
+}
+
+
+const math::mat4& renderer::scene::transform_hierarchy::get_world(node_handle node) const
+{
+    return m_worlds[index_of(node)];
+}
+
+
+const math::mat4& renderer::scene::transform_hierarchy::get_inverse_world(node_handle node) const
+{
+    return m_inverse_worlds[index_of(node)];
+}
+
+
+bool renderer::scene::transform_hierarchy::is_valid(node_handle node) const
+{
+    return !m_indices.is_id_expired(node);
+}
+
+
+size_t renderer::scene::transform_hierarchy::size() const
+{
+    return m_handles.size();
+}
+
+
+std::span<const renderer::scene::transform_hierarchy::node_handle> renderer::scene::transform_hierarchy::update()
+{
+    restore_order();
+    m_updated.clear();
+
+    std::vector<uint32_t> roots;
+    roots.reserve(m_dirty.size());
+
+    for (auto handle : m_dirty) {
+        if (is_valid(handle)) {
+            roots.emplace_back(index_of(handle));
+        }
+    }
+
+    m_dirty.clear();
+    std::sort(roots.begin(), roots.end());
+
+    // dirty node inside already recomputed subtree is skipped, its parent is fresh and it's recomputed anyway.
+    uint32_t covered_end = 0;
+
+    for (auto root : roots) {
+        if (root < covered_end) {
+            continue;
+        }
+
+        covered_end = root + m_subtree_sizes[root];
+
+        for (auto i = root; i < covered_end; ++i) {
+            const auto local = to_matrix(m_locals[i]);
+            const auto inverse_local = to_inverse_matrix(m_locals[i]);
+            const auto parent = m_parents[i];
+
+            if (parent == npos) {
+                m_worlds[i] = local;
+                m_inverse_worlds[i] = inverse_local;
+            } else {
+                m_worlds[i] = m_worlds[parent] * local;
+                m_inverse_worlds[i] = inverse_local * m_inverse_worlds[parent];
+            }
+
+            m_dirty_flags[i] = 0;
+            m_updated.emplace_back(m_handles[i]);
+        }
+    }
+
+    return m_updated;
+}
+
+
+uint32_t renderer::scene::transform_hierarchy::index_of(node_handle node) const
+{
+    ASSERT(is_valid(node));
+    return m_indices[node];
+}
+
+
+void renderer::scene::transform_hierarchy::mark_dirty(uint32_t index)
+{
+    if (m_dirty_flags[index] == 0) {
+        m_dirty_flags[index] = 1;
+        m_dirty.emplace_back(m_handles[index]);
+    }
+}
+
+
+void renderer::scene::transform_hierarchy::restore_order()
+{
+    if (!m_order_dirty) {
+        return;
+    }
+
+    m_order_dirty = false;
+
+    // parents always have smaller indices than children and subtree sizes are up to date,
+    // so every node's new position follows from its parent's one. siblings keep index order,
+    // which puts appended nodes at the ends of their parents' subtrees.
+    const auto count = uint32_t(m_handles.size());
+    std::vector<uint32_t> positions(count);
+    std::vector<uint32_t> next_child_positions(count);
+    uint32_t next_root_position = 0;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto parent = m_parents[i];
+        auto& next = parent == npos ? next_root_position : next_child_positions[parent];
+        positions[i] = next;
+        next += m_subtree_sizes[i];
+        next_child_positions[i] = positions[i] + 1;
+    }
+
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        order[positions[i]] = i;
+    }
+
+    reorder(order);
+}
+
+
+void renderer::scene::transform_hierarchy::reorder(const std::vector<uint32_t>& order)
+{
+    std::vector<uint32_t> old_to_new(m_handles.size(), npos);
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        old_to_new[order[i]] = i;
+    }
+
+    auto permute = [&order](auto& v) {
+        std::remove_reference_t<decltype(v)> res;
+        res.reserve(order.size());
+        for (auto old : order) {
+            res.emplace_back(std::move(v[old]));
+        }
+        v = std::move(res);
+    };
+
+    permute(m_handles);
+    permute(m_parents);
+    permute(m_subtree_sizes);
+    permute(m_locals);
+    permute(m_worlds);
+    permute(m_inverse_worlds);
+    permute(m_dirty_flags);
+
+    for (uint32_t i = 0; i < m_handles.size(); ++i) {
+        if (m_parents[i] != npos) {
+            m_parents[i] = old_to_new[m_parents[i]];
+        }
+        m_indices[m_handles[i]] = i;
+    }
+}
+
+
+void renderer::scene::transform_hierarchy::add_to_ancestors_sizes(uint32_t index, int64_t delta)
+{
+    for (; index != npos; index = m_parents[index]) {
+        m_subtree_sizes[index] = uint32_t(int64_t(m_subtree_sizes[index]) + delta);
+    }
+}
@@ -0,0 +1,86 @@
+
+
+#pragma once
+
+#include <memory/pool.hpp>
+#include <math/matrix.hpp>
+#include <math/quaternion.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace renderer::scene
+{
+    struct trs
+    {
+        math::vec3 translation{0, 0, 0};
+        math::quaternion rotation{{0, 0, 0}, 1};
+        math::vec3 scale{1, 1, 1};
+    };
+
+    // T * R * S and its inverse, computed in closed form (rotation is expected to be normalized).
+    math::mat4 to_matrix(const trs&);
+    math::mat4 to_inverse_matrix(const trs&);
+
+
+    // parent/child transforms with local trs. nodes live in flat arrays in pre-order,
+    // so parents always precede children and every subtree is a contiguous range.
+    // created nodes are appended and put in place once, before the next update or structural change.
+    // update() recomputes world matrices of dirty subtrees only.
+    class transform_hierarchy
+    {
+    public:
+        using node_handle = memory::handle;
+
+        constexpr static uint32_t npos = uint32_t(-1);
+
+        node_handle create_node(node_handle parent = memory::null_handle, const trs& local = {});
+
+        // destroys node with its whole subtree.
+        void destroy_node(node_handle);
+
+        void set_parent(node_handle, node_handle parent);
+        node_handle get_parent(node_handle) const;
+
+        const trs& get_local(node_handle) const;
+        void set_local(node_handle, const trs&);
+        void set_translation(node_handle, math::vec3);
+        void set_rotation(node_handle, math::quaternion);
+        void set_scale(node_handle, math::vec3);
+
+        // valid after update().
+        const math::mat4& get_world(node_handle) const;
+        const math::mat4& get_inverse_world(node_handle) const;
+
+        bool is_valid(node_handle) const;
+        size_t size() const;
+
+        // returns handles of nodes which world matrices were recomputed.
+        std::span<const node_handle> update();
+
+    private:
+        uint32_t index_of(node_handle) const;
+        void mark_dirty(uint32_t index);
+        void restore_order();
+        void reorder(const std::vector<uint32_t>& order);
+        void add_to_ancestors_sizes(uint32_t parent_index, int64_t delta);
+
+        // handle -> flat index, generations come from the pool.
+        memory::pool<uint32_t> m_indices;
+
+        // flat arrays, pre-order.
+        std::vector<node_handle> m_handles;
+        std::vector<uint32_t> m_parents;
+        std::vector<uint32_t> m_subtree_sizes;
+        std::vector<trs> m_locals;
+        std::vector<math::mat4> m_worlds;
+        std::vector<math::mat4> m_inverse_worlds;
+
+        std::vector<node_handle> m_dirty;
+        std::vector<uint8_t> m_dirty_flags;
+        std::vector<node_handle> m_updated;
+
+        bool m_order_dirty = false;
+    };
+} // namespace renderer::scene
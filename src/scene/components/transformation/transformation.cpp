@@ -6,7 +6,7 @@
 renderer::scene::transformation& renderer::scene::transformation::operator*(const renderer::scene::transformation& r)
 {
     transform = transform * r.transform;
-    inverse_transform = inverse_transform * r.inverse_transform;
+    inverse_transform = r.inverse_transform * inverse_transform;
     return *this;
 }
 
@@ -70,6 +70,7 @@ renderer::scene::transformation renderer::scene::rotation(math::quaternion q)
 {
     transformation t;
     t.transform = math::to_matrix(q);
-    t.inverse_transform = math::inverse(t.transform);
+    // pure rotation, inverse is transpose.
+    t.inverse_transform = math::transpose(t.transform);
     return t;
 }
@@ -0,0 +1,162 @@
+
+
+#pragma once
+
+#include <memory/handle.hpp>
+#include <misc/debug.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace renderer::scene
+{
+    using object_handler = memory::handle;
+
+    namespace detail
+    {
+        // sparse set of objects owning a component of one type.
+        // sparse array maps object slot index to position in the dense arrays,
+        // dense arrays are packed (swap and pop on removal), so views walk them linearly.
+        class component_set_base
+        {
+        public:
+            constexpr static uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+            virtual ~component_set_base() = default;
+
+            bool contains(object_handler object) const
+            {
+                return dense_index(object) != npos;
+            }
+
+            size_t size() const
+            {
+                return m_objects.size();
+            }
+
+            std::span<const object_handler> objects() const
+            {
+                return m_objects;
+            }
+
+            // handle of the component in its pool, null_handle if object doesn't have it.
+            memory::handle component_handle(object_handler object) const
+            {
+                const auto i = dense_index(object);
+                return i == npos ? memory::null_handle : m_handles[i];
+            }
+
+            // removes object from the set and returns handle of its component in the pool.
+            memory::handle remove(object_handler object)
+            {
+                const auto i = dense_index(object);
+                if (i == npos) {
+                    return memory::null_handle;
+                }
+
+                const auto handle = m_handles[i];
+                const auto last = uint32_t(m_objects.size() - 1);
+
+                if (i != last) {
+                    m_objects[i] = m_objects[last];
+                    m_handles[i] = m_handles[last];
+                    move_component(last, i);
+                    m_sparse[memory::handles::index(m_objects[i])] = i;
+                }
+
+                m_sparse[memory::handles::index(object)] = npos;
+                m_objects.pop_back();
+                m_handles.pop_back();
+                pop_component();
+
+                return handle;
+            }
+
+        protected:
+            uint32_t dense_index(object_handler object) const
+            {
+                const auto index = memory::handles::index(object);
+                if (index >= m_sparse.size()) {
+                    return npos;
+                }
+
+                const auto i = m_sparse[index];
+
+                // full handle compare rejects stale objects which slot is reused.
+                if (i == npos || m_objects[i] != object) {
+                    return npos;
+                }
+
+                return i;
+            }
+
+            uint32_t insert(object_handler object, memory::handle handle)
+            {
+                ASSERT(!contains(object));
+                const auto index = memory::handles::index(object);
+
+                if (index >= m_sparse.size()) {
+                    m_sparse.resize(index + 1, npos);
+                }
+
+                const auto i = uint32_t(m_objects.size());
+                m_sparse[index] = i;
+                m_objects.emplace_back(object);
+                m_handles.emplace_back(handle);
+                return i;
+            }
+
+            virtual void move_component(uint32_t from, uint32_t to) = 0;
+            virtual void pop_component() = 0;
+
+        private:
+            std::vector<uint32_t> m_sparse;
+            std::vector<object_handler> m_objects;
+            std::vector<memory::handle> m_handles;
+        };
+
+
+        template<typename T>
+        class component_set : public component_set_base
+        {
+        public:
+            T& emplace(object_handler object, memory::handle handle, T& component)
+            {
+                insert(object, handle);
+                m_components.emplace_back(&component);
+                return component;
+            }
+
+            T* get(object_handler object) const
+            {
+                const auto i = dense_index(object);
+                return i == npos ? nullptr : m_components[i];
+            }
+
+            // components in the same order as objects().
+            std::span<T* const> components() const
+            {
+                return m_components;
+            }
+
+        protected:
+            void move_component(uint32_t from, uint32_t to) override
+            {
+                m_components[to] = m_components[from];
+            }
+
+            void pop_component() override
+            {
+                m_components.pop_back();
+            }
+
+        private:
+            // components themselves stay in the chunked pools, so their addresses are stable.
+            // dense storage would move them on growth and on swap and pop of other objects,
+            // breaking pointers from scene::get_component (see component_base).
+            std::vector<T*> m_components;
+        };
+    } // namespace detail
+} // namespace renderer::scene
@@ -3,15 +3,28 @@
 
 #pragma once
 
+#include <scene/systems/system.hpp>
+
 namespace renderer::scene
 {
     class scene;
 
-    class render_system
+    // gpu work, so it runs on the main thread and never together with other systems.
+    class render_system : public system
     {
     public:
-        virtual ~render_system() = default;
+        ~render_system() override = default;
         virtual void draw_scene(scene*) = 0;
+
+        void declare_access(system_access& access) const override
+        {
+            access.exclusive().main_thread();
+        }
+
+        void update(scene& s, job_scheduler&, float) override
+        {
+            draw_scene(&s);
+        }
     };
 }
 
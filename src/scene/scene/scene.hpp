@@ -4,44 +4,159 @@
 
 #include <memory/pool_factory.hpp>
 #include <scene/components/component_base.hpp>
+#include <scene/scene/component_set.hpp>
 
 #include <scene/components/transformation/transformation.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <vector>
+
 namespace renderer::scene
 {
-    using object_handler = size_t;
-
     namespace detail
     {
-        template<typename T>
-        struct component_wrapper
+        // objects are generational ids only, components are tracked by component sets.
+        struct object
+        {
+            constexpr static size_t pool_chunk_size = 256;
+        };
+    } // namespace detail
+
+
+    // objects having all of Ts components. walks dense arrays of the smallest set,
+    // other sets are probed in O(1). yields tuple<object_handler, Ts&...>, nothing is allocated.
+    template<typename... Ts>
+    class scene_view
+    {
+    public:
+        class iterator
         {
-            component_wrapper(T* ptr, object_handler obj)
-                : component_ptr(ptr)
-                , object(obj)
+        public:
+            iterator(const scene_view* view, size_t index)
+                : m_view(view)
+                , m_index(index)
+            {
+                skip();
+            }
+
+            std::tuple<object_handler, Ts&...> operator*() const
             {
+                return m_view->at(m_index);
+            }
+
+            iterator& operator++()
+            {
+                ++m_index;
+                skip();
+                return *this;
+            }
+
+            bool operator==(const iterator& r) const
+            {
+                return m_index == r.m_index;
+            }
+
+            bool operator!=(const iterator& r) const
+            {
+                return m_index != r.m_index;
+            }
+
+        private:
+            void skip()
+            {
+                const auto count = m_view->size();
+                while (m_index < count && !m_view->matches(m_index)) {
+                    ++m_index;
+                }
             }
 
-            T* component_ptr;
-            object_handler object = -1;
+            const scene_view* m_view;
+            size_t m_index;
         };
 
-        struct component_handler
+        explicit scene_view(detail::component_set<Ts>*... sets)
+            : m_sets(sets...)
         {
-            size_t type_id;
-            size_t handler;
-            object_handler object_handler;
-        };
+            if ((... && (sets != nullptr))) {
+                m_driver = std::min({static_cast<detail::component_set_base*>(sets)...}, [](auto* l, auto* r) {
+                    return l->size() < r->size();
+                });
+            }
+        }
 
-        struct object
+        iterator begin() const
         {
-            std::vector<component_handler> components;
-        };
-    } // namespace detail
+            return {this, 0};
+        }
+
+        iterator end() const
+        {
+            return {this, objects().size()};
+        }
+
+        // upper bound of objects count, parallel_for range for each().
+        size_t size() const
+        {
+            return objects().size();
+        }
+
+        // calls f(object, Ts&...) for matching objects of [from, to) part of the view, see size().
+        template<typename Func>
+        void each(size_t from, size_t to, Func&& f) const
+        {
+            to = std::min(to, size());
+            // indices are compared directly, matches are never searched past the end of the part.
+            for (auto i = from; i < to; ++i) {
+                if (matches(i)) {
+                    std::apply(f, at(i));
+                }
+            }
+        }
+
+    private:
+        std::span<const object_handler> objects() const
+        {
+            return m_driver == nullptr ? std::span<const object_handler>{} : m_driver->objects();
+        }
+
+        // driver set objects always have its component, only other sets are probed.
+        bool matches(size_t index) const
+        {
+            if constexpr (sizeof...(Ts) == 1) {
+                return true;
+            } else {
+                const auto object = objects()[index];
+                return (... && std::get<detail::component_set<Ts>*>(m_sets)->contains(object));
+            }
+        }
+
+        std::tuple<object_handler, Ts&...> at(size_t index) const
+        {
+            const auto object = objects()[index];
+            if constexpr (sizeof...(Ts) == 1) {
+                return {object, *std::get<0>(m_sets)->components()[index]};
+            } else {
+                return {object, *std::get<detail::component_set<Ts>*>(m_sets)->get(object)...};
+            }
+        }
+
+        std::tuple<detail::component_set<Ts>*...> m_sets;
+        const detail::component_set_base* m_driver{nullptr};
+    };
+
 
     class scene
     {
     public:
+        template<typename T>
+        static size_t component_type_id()
+        {
+            return misc::type_traits::type_id<memory::pool_factory<scene>>::template get<std::remove_cv_t<std::remove_reference_t<T>>>();
+        }
+
         object_handler create_object()
         {
             auto o = m_pool_factory.create<detail::object>();
@@ -57,11 +172,16 @@ namespace renderer::scene
 
         void reset_object(object_handler object_id)
         {
-            auto objects_view = m_pool_factory.view<detail::object>();
-            auto& obj = objects_view[object_id];
+            for (size_t type_id = 0; type_id < m_component_sets.size(); ++type_id) {
+                auto& set = m_component_sets[type_id];
+                if (set == nullptr) {
+                    continue;
+                }
 
-            for (auto c : obj.components) {
-                m_pool_factory.destroy(c.type_id, c.handler);
+                const auto handle = set->remove(object_id);
+                if (handle != memory::null_handle) {
+                    m_pool_factory.destroy(type_id, handle);
+                }
             }
         }
 
@@ -69,112 +189,87 @@ namespace renderer::scene
         T& emplace_component(object_handler object_id, Args... args)
         {
             static_assert(std::is_base_of_v<component_base, T>, "component must be child of component_base.");
+            ASSERT(!m_pool_factory.view<detail::object>().get_pool()->is_id_expired(object_id));
             ASSERT(!has_component<T>(object_id));
 
-            auto& obj = get_object(object_id);
-            const auto type_id = m_pool_factory.get_type_id<T>();
-
             auto component = m_pool_factory.create<T>(std::forward<Args>(args)...);
-
-            obj.components.emplace_back(detail::component_handler{.type_id = type_id, .handler = component, .object_handler = object_id});
             auto& c = m_pool_factory.view<T>()[component];
             c.object_handler = object_id;
-            return c;
+
+            return get_or_create_set<T>().emplace(object_id, component, c);
         }
 
         template<typename T>
         bool has_component(object_handler object_id) const
         {
-            auto& obj = get_object(object_id);
-
-            const auto type_id = m_pool_factory.get_type_id<T>();
-            auto it = std::find_if(obj.components.begin(), obj.components.end(), [type_id](detail::component_handler& handler) {
-                return handler.type_id == type_id;
-            });
-
-            return it != obj.components.end();
+            auto* set = get_set<T>();
+            return set != nullptr && set->contains(object_id);
         }
 
         template<typename T>
         T* get_component(object_handler object_id)
         {
-            const auto type_id = m_pool_factory.get_type_id<T>();
-
-            auto& obj = get_object(object_id);
-
-            auto it = std::find_if(obj.components.begin(), obj.components.end(), [type_id](detail::component_handler& handler) {
-                return handler.type_id == type_id;
-            });
-
-            if (it == obj.components.end()) {
-                return nullptr;
-            }
-
-            auto components_view = m_pool_factory.view<T>();
-            auto& c = components_view[it->handler];
-            return &c;
+            auto* set = get_set<T>();
+            return set == nullptr ? nullptr : set->get(object_id);
         }
 
         template<typename T>
         void remove_component(object_handler object_id)
         {
-            if (!has_component<T>(object_id)) {
+            auto* set = get_set<T>();
+            if (set == nullptr) {
                 return;
-            };
-
-            const auto type_id = m_pool_factory.get_type_id<T>();
-
-            auto& obj = get_object(object_id);
-
-            auto it = std::find_if(obj.components.begin(), obj.components.end(), [type_id](detail::component_handler& handler) {
-                return handler.type_id == type_id;
-            });
+            }
 
-            if (it == obj.components.end()) {
-                return;
+            const auto handle = set->remove(object_id);
+            if (handle != memory::null_handle) {
+                m_pool_factory.destroy<T>(handle);
             }
+        }
 
-            m_pool_factory.destroy<T>(it->handler);
-            obj.components.erase(it);
+        template<typename... Ts>
+        scene_view<Ts...> view() const
+        {
+            return scene_view<Ts...>{get_set<Ts>()...};
         }
 
+        // objects having T component, valid until next component of type T is added or removed.
         template<typename T>
-        auto view()
+        std::span<const object_handler> objects_view() const
         {
-            auto v = m_pool_factory.view<T>();
-            if (v.get_pool() == nullptr) {
-                return std::vector<T*>{};
-            } else {
-                return v.get_pool()->objects_view();
-            }
+            auto* set = get_set<T>();
+            return set == nullptr ? std::span<const object_handler>{} : set->objects();
         }
 
+    private:
         template<typename T>
-        std::vector<object_handler> objects_view()
+        detail::component_set<T>* get_set() const
         {
-            auto view = m_pool_factory.view<T>();
+            const auto type_id = m_pool_factory.get_type_id<T>();
+            if (type_id >= m_component_sets.size()) {
+                return nullptr;
+            }
 
-            std::vector<object_handler> res;
-            res.reserve(view.size());
+            return static_cast<detail::component_set<T>*>(m_component_sets[type_id].get());
+        }
 
-            for (int i = 0; i < view.size(); ++i) {
-                if (view.get_pool()->is_id_expired(i)) {
-                    continue;
-                }
+        template<typename T>
+        detail::component_set<T>& get_or_create_set()
+        {
+            const auto type_id = m_pool_factory.get_type_id<T>();
+            if (type_id >= m_component_sets.size()) {
+                m_component_sets.resize(type_id + 1);
+            }
 
-                res.emplace_back(view[i].object_handler);
+            auto& set = m_component_sets[type_id];
+            if (set == nullptr) {
+                set = std::make_unique<detail::component_set<T>>();
             }
 
-            return res;
+            return static_cast<detail::component_set<T>&>(*set);
         }
 
-    private:
-        detail::object& get_object(object_handler object_id) const
-        {
-            auto objects_view = m_pool_factory.view<detail::object>();
-            auto& obj = objects_view[object_id];
-            return obj;
-        }
         memory::pool_factory<scene> m_pool_factory;
+        std::vector<std::unique_ptr<detail::component_set_base>> m_component_sets;
     };
 } // namespace renderer::scene
@@ -0,0 +1,195 @@
+
+
+#include "job_scheduler.hpp"
+
+#include <misc/debug.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    constexpr size_t external_thread = size_t(-1);
+
+    thread_local const renderer::scene::job_scheduler* current_scheduler = nullptr;
+    thread_local size_t current_worker = external_thread;
+} // namespace
+
+
+renderer::scene::job_scheduler::job_scheduler(size_t workers_count)
+{
+    m_queues.reserve(std::max<size_t>(workers_count, 1));
+    for (size_t i = 0; i < std::max<size_t>(workers_count, 1); ++i) {
+        m_queues.emplace_back(std::make_unique<queue>());
+    }
+
+    m_workers.reserve(workers_count);
+    for (size_t i = 0; i < workers_count; ++i) {
+        m_workers.emplace_back([this, i]() {
+            worker_loop(i);
+        });
+    }
+}
+
+
+renderer::scene::job_scheduler::~job_scheduler()
+{
+    {
+        std::lock_guard lock{m_sleep_mutex};
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+
+size_t renderer::scene::job_scheduler::default_workers_count()
+{
+    const auto threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 0;
+}
+
+
+size_t renderer::scene::job_scheduler::workers_count() const
+{
+    return m_workers.size();
+}
+
+
+void renderer::scene::job_scheduler::submit(job_group& group, job j)
+{
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    const auto queue_index = current_scheduler == this
+                                 ? current_worker
+                                 : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    m_queued.fetch_add(1, std::memory_order_release);
+
+    {
+        auto& q = *m_queues[queue_index];
+        std::lock_guard lock{q.mutex};
+        q.tasks.emplace_back(task{.func = std::move(j), .group = &group});
+    }
+
+    // empty critical section, worker can't miss the notification between its check and its sleep.
+    {
+        std::lock_guard lock{m_sleep_mutex};
+    }
+    m_wake.notify_one();
+}
+
+
+void renderer::scene::job_scheduler::wait(job_group& group)
+{
+    while (!group.done()) {
+        if (!help()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+
+bool renderer::scene::job_scheduler::help()
+{
+    return try_execute_one(current_scheduler == this ? current_worker : 0);
+}
+
+
+void renderer::scene::job_scheduler::parallel_for(size_t count, size_t chunk_size, const std::function<void(size_t, size_t)>& f)
+{
+    ASSERT(chunk_size > 0);
+
+    if (count <= chunk_size) {
+        f(0, count);
+        return;
+    }
+
+    job_group group;
+
+    for (size_t begin = 0; begin < count; begin += chunk_size) {
+        const auto end = std::min(begin + chunk_size, count);
+        submit(group, [&f, begin, end]() {
+            f(begin, end);
+        });
+    }
+
+    wait(group);
+}
+
+
+bool renderer::scene::job_scheduler::pop(size_t queue_index, task& t)
+{
+    auto& q = *m_queues[queue_index];
+    std::lock_guard lock{q.mutex};
+
+    if (q.tasks.empty()) {
+        return false;
+    }
+
+    t = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    return true;
+}
+
+
+bool renderer::scene::job_scheduler::steal(size_t thief_index, task& t)
+{
+    for (size_t i = 1; i < m_queues.size(); ++i) {
+        auto& q = *m_queues[(thief_index + i) % m_queues.size()];
+        std::lock_guard lock{q.mutex};
+
+        if (!q.tasks.empty()) {
+            t = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool renderer::scene::job_scheduler::try_execute_one(size_t queue_index)
+{
+    task t;
+    if (!pop(queue_index, t) && !steal(queue_index, t)) {
+        return false;
+    }
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    execute(t);
+    return true;
+}
+
+
+void renderer::scene::job_scheduler::execute(task& t)
+{
+    t.func();
+    t.group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+
+void renderer::scene::job_scheduler::worker_loop(size_t index)
+{
+    current_scheduler = this;
+    current_worker = index;
+
+    while (true) {
+        if (try_execute_one(index)) {
+            continue;
+        }
+
+        std::unique_lock lock{m_sleep_mutex};
+        m_wake.wait(lock, [this]() {
+            return m_stop || m_queued.load(std::memory_order_acquire) > 0;
+        });
+
+        if (m_stop && m_queued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
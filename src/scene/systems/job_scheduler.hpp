@@ -0,0 +1,88 @@
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace renderer::scene
+{
+    // counter of unfinished jobs, wait on it with job_scheduler::wait.
+    class job_group
+    {
+        friend class job_scheduler;
+
+    public:
+        bool done() const
+        {
+            return m_pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        std::atomic<size_t> m_pending{0};
+    };
+
+
+    // work stealing thread pool. every worker owns a queue, takes own jobs from the back
+    // and steals from the front of other queues when it runs out of work.
+    // threads waiting for a group execute jobs too, so nested waits never deadlock.
+    // with zero workers every job runs on the thread which waits for it.
+    class job_scheduler
+    {
+    public:
+        using job = std::function<void()>;
+
+        explicit job_scheduler(size_t workers_count = default_workers_count());
+        ~job_scheduler();
+
+        job_scheduler(const job_scheduler&) = delete;
+        job_scheduler& operator=(const job_scheduler&) = delete;
+
+        static size_t default_workers_count();
+
+        size_t workers_count() const;
+
+        void submit(job_group& group, job j);
+        void wait(job_group& group);
+
+        // executes one queued job on the calling thread, false if there was nothing to do.
+        bool help();
+
+        // calls f(begin, end) for [0, count) split by chunk_size and waits for all of them.
+        void parallel_for(size_t count, size_t chunk_size, const std::function<void(size_t, size_t)>& f);
+
+    private:
+        struct task
+        {
+            job func;
+            job_group* group;
+        };
+
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<task> tasks;
+        };
+
+        bool pop(size_t queue_index, task& t);
+        bool steal(size_t thief_index, task& t);
+        bool try_execute_one(size_t queue_index);
+        void execute(task& t);
+        void worker_loop(size_t index);
+
+        std::vector<std::unique_ptr<queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::atomic<size_t> m_next_queue{0};
+        std::atomic<size_t> m_queued{0};
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake;
+        bool m_stop{false};
+    };
+} // namespace renderer::scene
@@ -0,0 +1,103 @@
+
+
+#pragma once
+
+#include <scene/scene/scene.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace renderer::scene
+{
+    class job_scheduler;
+
+    // component types a system reads and writes. systems_scheduler runs two systems
+    // in parallel only if neither of them writes a type the other one touches.
+    class system_access
+    {
+    public:
+        template<typename T>
+        system_access& read()
+        {
+            add(m_reads, scene::component_type_id<T>());
+            return *this;
+        }
+
+        template<typename T>
+        system_access& write()
+        {
+            add(m_writes, scene::component_type_id<T>());
+            return *this;
+        }
+
+        // conflicts with every other system: structural scene changes, gpu calls, etc.
+        system_access& exclusive()
+        {
+            m_exclusive = true;
+            return *this;
+        }
+
+        // runs on the thread calling systems_scheduler::update (the one owning gl context).
+        system_access& main_thread()
+        {
+            m_main_thread = true;
+            return *this;
+        }
+
+        bool is_main_thread() const
+        {
+            return m_main_thread;
+        }
+
+        bool conflicts(const system_access& r) const
+        {
+            if (m_exclusive || r.m_exclusive) {
+                return true;
+            }
+
+            return intersects(m_writes, r.m_writes) || intersects(m_writes, r.m_reads) || intersects(m_reads, r.m_writes);
+        }
+
+    private:
+        static void add(std::vector<size_t>& types, size_t type_id)
+        {
+            auto it = std::lower_bound(types.begin(), types.end(), type_id);
+            if (it == types.end() || *it != type_id) {
+                types.insert(it, type_id);
+            }
+        }
+
+        static bool intersects(const std::vector<size_t>& l, const std::vector<size_t>& r)
+        {
+            auto l_it = l.begin();
+            auto r_it = r.begin();
+
+            while (l_it != l.end() && r_it != r.end()) {
+                if (*l_it == *r_it) {
+                    return true;
+                }
+                *l_it < *r_it ? ++l_it : ++r_it;
+            }
+
+            return false;
+        }
+
+        std::vector<size_t> m_reads;
+        std::vector<size_t> m_writes;
+        bool m_exclusive{false};
+        bool m_main_thread{false};
+    };
+
+
+    class system
+    {
+    public:
+        virtual ~system() = default;
+
+        virtual void declare_access(system_access&) const = 0;
+
+        // may split own work with scheduler.parallel_for, must not add or remove components
+        // unless the system declared exclusive access.
+        virtual void update(scene&, job_scheduler&, float dt) = 0;
+    };
+} // namespace renderer::scene
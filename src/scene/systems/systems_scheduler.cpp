@@ -0,0 +1,114 @@
+
+
+#include "systems_scheduler.hpp"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+renderer::scene::systems_scheduler::systems_scheduler(job_scheduler& jobs)
+    : m_jobs(jobs)
+{
+}
+
+
+void renderer::scene::systems_scheduler::update(scene& s, float dt)
+{
+    build_graph();
+
+    const auto count = m_systems.size();
+    std::vector<std::atomic<size_t>> remaining(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        remaining[i].store(m_dependencies[i].size(), std::memory_order_relaxed);
+    }
+
+    job_group group;
+    std::atomic<size_t> finished{0};
+
+    std::mutex main_thread_mutex;
+    std::vector<size_t> main_thread_ready;
+
+    std::function<void(size_t)> run;
+
+    auto schedule = [&](size_t i) {
+        if (m_access[i].is_main_thread()) {
+            std::lock_guard lock{main_thread_mutex};
+            main_thread_ready.emplace_back(i);
+        } else {
+            m_jobs.submit(group, [&run, i]() {
+                run(i);
+            });
+        }
+    };
+
+    // finished system releases its dependants, the last released dependency schedules it.
+    run = [&](size_t i) {
+        m_systems[i]->update(s, m_jobs, dt);
+
+        for (auto dependant : m_dependants[i]) {
+            if (remaining[dependant].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                schedule(dependant);
+            }
+        }
+
+        finished.fetch_add(1, std::memory_order_acq_rel);
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_dependencies[i].empty()) {
+            schedule(i);
+        }
+    }
+
+    while (finished.load(std::memory_order_acquire) < count) {
+        size_t main_thread_system = count;
+
+        {
+            std::lock_guard lock{main_thread_mutex};
+            if (!main_thread_ready.empty()) {
+                main_thread_system = main_thread_ready.front();
+                main_thread_ready.erase(main_thread_ready.begin());
+            }
+        }
+
+        if (main_thread_system != count) {
+            run(main_thread_system);
+        } else if (!m_jobs.help()) {
+            std::this_thread::yield();
+        }
+    }
+
+    m_jobs.wait(group);
+}
+
+
+const std::vector<std::vector<size_t>>& renderer::scene::systems_scheduler::dependencies() const
+{
+    return m_dependencies;
+}
+
+
+void renderer::scene::systems_scheduler::build_graph()
+{
+    const auto count = m_systems.size();
+
+    m_access.assign(count, {});
+    for (size_t i = 0; i < count; ++i) {
+        m_systems[i]->declare_access(m_access[i]);
+    }
+
+    m_dependencies.assign(count, {});
+    m_dependants.assign(count, {});
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (m_access[i].conflicts(m_access[j])) {
+                m_dependencies[i].emplace_back(j);
+                m_dependants[j].emplace_back(i);
+            }
+        }
+    }
+}
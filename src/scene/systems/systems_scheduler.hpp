@@ -0,0 +1,45 @@
+
+
+#pragma once
+
+#include <scene/systems/system.hpp>
+#include <scene/systems/job_scheduler.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace renderer::scene
+{
+    // runs systems once per update. every update dependency graph is rebuilt from declared access:
+    // system depends on each earlier registered system it conflicts with, so conflicting systems
+    // always run in registration order and the result doesn't depend on threads timings.
+    // main thread systems run on the caller of update, the rest on job_scheduler workers.
+    class systems_scheduler
+    {
+    public:
+        explicit systems_scheduler(job_scheduler&);
+
+        template<typename T, typename... Args>
+        T& add_system(Args&&... args)
+        {
+            auto s = std::make_unique<T>(std::forward<Args>(args)...);
+            auto& res = *s;
+            m_systems.emplace_back(std::move(s));
+            return res;
+        }
+
+        void update(scene&, float dt);
+
+        // dependencies[i] are indices of systems which finished before system i started, for the last update.
+        const std::vector<std::vector<size_t>>& dependencies() const;
+
+    private:
+        void build_graph();
+
+        job_scheduler& m_jobs;
+        std::vector<std::unique_ptr<system>> m_systems;
+        std::vector<system_access> m_access;
+        std::vector<std::vector<size_t>> m_dependencies;
+        std::vector<std::vector<size_t>> m_dependants;
+    };
+} // namespace renderer::scene
@@ -0,0 +1,43 @@
+
+
+#include "transform_system.hpp"
+
+
+renderer::scene::transform_system::transform_system(transform_hierarchy& hierarchy)
+    : m_hierarchy(hierarchy)
+{
+}
+
+
+void renderer::scene::transform_system::bind(transform_hierarchy::node_handle node, object_handler object)
+{
+    m_objects[node] = object;
+}
+
+
+void renderer::scene::transform_system::unbind(transform_hierarchy::node_handle node)
+{
+    m_objects.erase(node);
+}
+
+
+void renderer::scene::transform_system::declare_access(system_access& access) const
+{
+    access.write<transformation>();
+}
+
+
+void renderer::scene::transform_system::update(scene& s, job_scheduler&, float)
+{
+    for (auto node : m_hierarchy.update()) {
+        auto it = m_objects.find(node);
+        if (it == m_objects.end()) {
+            continue;
+        }
+
+        if (auto* t = s.get_component<transformation>(it->second); t != nullptr) {
+            t->transform = m_hierarchy.get_world(node);
+            t->inverse_transform = m_hierarchy.get_inverse_world(node);
+        }
+    }
+}
@@ -0,0 +1,30 @@
+
+
+#pragma once
+
+#include <scene/components/transformation/transform_hierarchy.hpp>
+#include <scene/systems/system.hpp>
+
+#include <unordered_map>
+
+namespace renderer::scene
+{
+    // propagates dirty hierarchy nodes and copies their world matrices
+    // into transformation components of bound objects. untouched objects cost nothing.
+    class transform_system : public system
+    {
+    public:
+        explicit transform_system(transform_hierarchy& hierarchy);
+        ~transform_system() override = default;
+
+        void bind(transform_hierarchy::node_handle node, object_handler object);
+        void unbind(transform_hierarchy::node_handle node);
+
+        void declare_access(system_access& access) const override;
+        void update(scene& s, job_scheduler& scheduler, float dt) override;
+
+    private:
+        transform_hierarchy& m_hierarchy;
+        std::unordered_map<transform_hierarchy::node_handle, object_handler> m_objects;
+    };
+} // namespace renderer::scene
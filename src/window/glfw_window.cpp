@@ -8,6 +8,7 @@
 
 #include <renderer/gl/renderer.hpp>
 #include <renderer/gl/traits.hpp>
+#include <renderer/gl/extensions.hpp>
 
 
 renderer::glfw_window::glfw_window(const std::string& name, misc::size size)
@@ -34,6 +35,19 @@ renderer::glfw_window::glfw_window(const std::string& name, misc::size size)
         throw std::runtime_error("Failed to initialize GLAD");
     }
 
+    gl::extensions::load((void* (*) (const char*)) glfwGetProcAddress);
+
+    // invisible window, its context shares objects with the main one and is used by background shader compilation.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_worker_window = glfwCreateWindow(1, 1, "", nullptr, m_window);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    if (m_worker_window != nullptr) {
+        static_cast<gl::renderer&>(*m_renderer).set_worker_context([worker_window = m_worker_window](bool current) {
+            glfwMakeContextCurrent(current ? worker_window : nullptr);
+        });
+    }
+
     glfwSetWindowUserPointer(m_window, this);
 
     glfwSetWindowSizeCallback(m_window, &resize_callback);
@@ -66,6 +80,10 @@ void renderer::glfw_window::destroy_window()
     if (m_renderer) {
         m_renderer->clear();
     }
+    if (m_worker_window != nullptr) {
+        glfwDestroyWindow(m_worker_window);
+        m_worker_window = nullptr;
+    }
     glfwDestroyWindow(m_window);
     glfwTerminate();
 }
@@ -53,5 +53,6 @@ namespace renderer
         std::vector<keyboard_handler> m_keyboard_handlers;
 
         GLFWwindow* m_window;
+        GLFWwindow* m_worker_window{nullptr};
     };
 } // namespace renderer